@@ -0,0 +1,278 @@
+/**
+ * @file data-structures/spsc_queue/bench/pingpong.cpp
+ * @brief Cross-process round trip benchmark for spsc_queue_shm
+ *
+ * Forks a ping and a pong process, pins each one to a chosen core and bounces messages
+ * through two spsc_queue_shm rings. For every payload size from 8 B to 4 KiB it reports
+ * round trip time percentiles, then streams messages one way to measure throughput.
+ *
+ * Usage: bench_pingpong [--ping-core N] [--pong-core M] [--iterations K] [--warmup W]
+ *
+ * Run it with the two cores on the same socket, on different sockets and on SMT
+ * siblings of the same physical core to compare layouts.
+ */
+
+#include "spsc_queue_shm.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <print>
+#include <sched.h>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+constexpr std::size_t RING_CAPACITY = 1024;
+
+struct options {
+    int ping_core = 0;
+    int pong_core = 1;
+    std::size_t iterations = 100000;
+    std::size_t warmup = 10000;
+};
+
+template <std::size_t N> struct payload {
+    static_assert(N >= sizeof(std::uint64_t));
+    alignas(8) std::byte bytes[N];
+};
+
+template <std::size_t N> void set_sequence(payload<N>& p, std::uint64_t seq) {
+    std::memcpy(p.bytes, &seq, sizeof(seq));
+}
+
+template <std::size_t N> std::uint64_t get_sequence(const payload<N>& p) {
+    std::uint64_t seq;
+    std::memcpy(&seq, p.bytes, sizeof(seq));
+    return seq;
+}
+
+void pin_to_core(int core) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == -1) {
+        std::println(stderr, "failed to pin to core {}", core);
+        std::exit(1);
+    }
+}
+
+std::string read_topology(int core, const char* file) {
+    std::ifstream in("/sys/devices/system/cpu/cpu" + std::to_string(core) +
+                     "/topology/" + file);
+    std::string value;
+    std::getline(in, value);
+    return value.empty() ? "?" : value;
+}
+
+void describe_layout(const options& opts) {
+    std::string ping_socket = read_topology(opts.ping_core, "physical_package_id");
+    std::string pong_socket = read_topology(opts.pong_core, "physical_package_id");
+    std::string ping_core_id = read_topology(opts.ping_core, "core_id");
+    std::string pong_core_id = read_topology(opts.pong_core, "core_id");
+
+    const char* layout = "unknown";
+    if (opts.ping_core == opts.pong_core) {
+        layout = "same cpu, both processes spin on one core";
+    } else if (ping_socket != "?" && pong_socket != "?") {
+        if (ping_socket != pong_socket) {
+            layout = "cross-socket";
+        } else if (ping_core_id == pong_core_id) {
+            layout = "SMT siblings";
+        } else {
+            layout = "same socket";
+        }
+    }
+
+    std::println("ping cpu {} (socket {}, core {}), pong cpu {} (socket {}, core {}): {}",
+                 opts.ping_core, ping_socket, ping_core_id, opts.pong_core, pong_socket,
+                 pong_core_id, layout);
+}
+
+/*
+ * Both rings live in one anonymous shared mapping created before the fork, so the
+ * children inherit it at the same address and no shm_open name is needed.
+ */
+template <typename T> struct ring_pair {
+    using queue = ptorpis::spsc_queue_shm<T>;
+
+    static std::size_t ring_bytes() {
+        std::size_t bytes = sizeof(queue) + sizeof(T) * std::bit_ceil(RING_CAPACITY + 1);
+        return (bytes + 63) & ~std::size_t{63};
+    }
+
+    ring_pair() {
+        size_m = 2 * ring_bytes();
+        base_m = mmap(nullptr, size_m, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS,
+                      -1, 0);
+        if (base_m == MAP_FAILED) {
+            std::println(stderr, "mmap failed");
+            std::exit(1);
+        }
+
+        ping()->init(RING_CAPACITY);
+        pong()->init(RING_CAPACITY);
+    }
+
+    ~ring_pair() { munmap(base_m, size_m); }
+
+    queue* ping() { return static_cast<queue*>(base_m); }
+    queue* pong() {
+        return reinterpret_cast<queue*>(static_cast<char*>(base_m) + ring_bytes());
+    }
+
+    void* base_m;
+    std::size_t size_m;
+};
+
+template <typename Q, typename T> void push_spin(Q* q, const T& item) {
+    while (!q->try_push(item)) {
+    }
+}
+
+template <typename Q, typename T> void pop_spin(Q* q, T& item) {
+    while (!q->try_pop(item)) {
+    }
+}
+
+double percentile(const std::vector<std::int64_t>& sorted, double p) {
+    auto last = static_cast<double>(sorted.size() - 1);
+    auto index = static_cast<std::size_t>(p / 100.0 * last);
+    return static_cast<double>(sorted[index]);
+}
+
+template <std::size_t N> void run(const options& opts) {
+    using message = payload<N>;
+    ring_pair<message> rings;
+    const std::size_t round_trips = opts.warmup + opts.iterations;
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        std::println(stderr, "fork failed");
+        std::exit(1);
+    }
+
+    if (pid == 0) {
+        // pong: echo every round trip, then drain the one way stream and ack it
+        pin_to_core(opts.pong_core);
+        message msg{};
+        for (std::size_t i{}; i < round_trips; ++i) {
+            pop_spin(rings.ping(), msg);
+            push_spin(rings.pong(), msg);
+        }
+        for (std::size_t i{}; i < opts.iterations; ++i) {
+            pop_spin(rings.ping(), msg);
+        }
+        push_spin(rings.pong(), msg);
+        std::_Exit(0);
+    }
+
+    pin_to_core(opts.ping_core);
+    message msg{};
+    std::vector<std::int64_t> rtt;
+    rtt.reserve(opts.iterations);
+
+    for (std::size_t i{}; i < round_trips; ++i) {
+        set_sequence(msg, i);
+        auto start = clock_type::now();
+        push_spin(rings.ping(), msg);
+        pop_spin(rings.pong(), msg);
+        auto end = clock_type::now();
+
+        if (get_sequence(msg) != i) {
+            std::println(stderr, "sequence mismatch: expected {}, got {}", i,
+                         get_sequence(msg));
+            std::exit(1);
+        }
+        if (i >= opts.warmup) {
+            using std::chrono::nanoseconds;
+            rtt.push_back(std::chrono::duration_cast<nanoseconds>(end - start).count());
+        }
+    }
+
+    auto stream_start = clock_type::now();
+    for (std::size_t i{}; i < opts.iterations; ++i) {
+        set_sequence(msg, i);
+        push_spin(rings.ping(), msg);
+    }
+    pop_spin(rings.pong(), msg);
+    auto stream_end = clock_type::now();
+
+    int status;
+    waitpid(pid, &status, 0);
+
+    std::sort(rtt.begin(), rtt.end());
+    double seconds = std::chrono::duration<double>(stream_end - stream_start).count();
+    double msgs_per_sec = static_cast<double>(opts.iterations) / seconds;
+
+    std::println("{:>6} {:>9.0f} {:>9.0f} {:>9.0f} {:>9.0f} {:>9.0f} {:>12.2f} {:>10.1f}",
+                 N, percentile(rtt, 50), percentile(rtt, 90), percentile(rtt, 99),
+                 percentile(rtt, 99.9), static_cast<double>(rtt.back()),
+                 msgs_per_sec / 1e6, msgs_per_sec * N / (1024.0 * 1024.0));
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--ping-core") {
+            opts.ping_core = std::atoi(value);
+        } else if (arg == "--pong-core") {
+            opts.pong_core = std::atoi(value);
+        } else if (arg == "--iterations") {
+            opts.iterations = std::strtoull(value, nullptr, 10);
+        } else if (arg == "--warmup") {
+            opts.warmup = std::strtoull(value, nullptr, 10);
+        } else {
+            std::println(stderr, "unknown option {}", arg);
+            std::exit(1);
+        }
+    }
+
+    if (opts.iterations == 0) {
+        std::println(stderr, "--iterations must be > 0");
+        std::exit(1);
+    }
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+    describe_layout(opts);
+    std::println("{} round trips per size after {} warmup, RTT in ns", opts.iterations,
+                 opts.warmup);
+    std::println("{:>6} {:>9} {:>9} {:>9} {:>9} {:>9} {:>12} {:>10}", "bytes", "p50",
+                 "p90", "p99", "p99.9", "max", "Mmsg/s", "MiB/s");
+
+    run<8>(opts);
+    run<16>(opts);
+    run<32>(opts);
+    run<64>(opts);
+    run<128>(opts);
+    run<256>(opts);
+    run<512>(opts);
+    run<1024>(opts);
+    run<2048>(opts);
+    run<4096>(opts);
+
+    return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file data-structures/spsc_queue/include/broadcast_queue_shm.hpp
+ * @brief Single producer, multiple reader broadcast ring living in shared memory
+ * @author ptorpis -- Peter Torpis
+ *
+ * Same idea as spsc_queue_shm, except every message is delivered to every attached
+ * reader. Readers register themselves in a fixed table inside the segment and each one
+ * keeps its own cursor, so they can be added and removed while the producer is running.
+ * The producer only looks at readers that are currently active.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace ptorpis {
+template <typename T, std::size_t MaxReaders = 32> class broadcast_queue_shm {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "broadcast_queue_shm requires trivially copyable types");
+    static_assert(MaxReaders > 0, "broadcast_queue_shm needs room for at least 1 reader");
+    using size_type = std::size_t;
+
+    enum reader_state : std::uint32_t { FREE, ATTACHING, ACTIVE, DETACHED };
+
+public:
+    /**
+     * @brief Number of bytes the shared segment needs for a queue of this capacity
+     */
+    static constexpr size_type required_size(size_type capacity) noexcept {
+        return sizeof(broadcast_queue_shm) + sizeof(T) * std::bit_ceil(capacity + 1);
+    }
+
+    /**
+     * @brief Initializes the queue in place, called once by the creator of the segment
+     *
+     * @param capacity Minimum number of messages a reader can fall behind by
+     * @param detach_lag 0 -> the producer applies backpressure, try_push fails while the
+     * slowest active reader is full. Otherwise any reader more than detach_lag messages
+     * behind is detached and the producer never blocks (clamped to the capacity).
+     */
+    void init(size_type capacity, size_type detach_lag = 0) {
+        buffer_size_m = std::bit_ceil(capacity + 1);
+        mask_m = buffer_size_m - 1;
+        buffer_offset_m = sizeof(broadcast_queue_shm);
+        detach_lag_m = detach_lag < buffer_size_m ? detach_lag : buffer_size_m - 1;
+        min_cursor_m = 0;
+        tail_m.store(0, std::memory_order_relaxed);
+        writing_m.store(0, std::memory_order_relaxed);
+
+        for (auto& reader : readers_m) {
+            reader.cursor.store(0, std::memory_order_relaxed);
+            reader.state.store(FREE, std::memory_order_relaxed);
+        }
+    }
+
+    /*
+     * Reader management, callable from any process at any time
+     */
+
+    /**
+     * @brief Claims a reader slot, the reader starts with the next message pushed
+     * @param id Set to the slot index to pass to try_pop / detach_reader
+     * @return false if all MaxReaders slots are taken
+     */
+    bool attach_reader(size_type& id) {
+        for (size_type i{}; i < MaxReaders; ++i) {
+            std::uint32_t expected = FREE;
+            if (!readers_m[i].state.compare_exchange_strong(expected, ATTACHING,
+                                                            std::memory_order_acq_rel)) {
+                continue;
+            }
+
+            readers_m[i].cursor.store(tail_m.load(std::memory_order_acquire),
+                                      std::memory_order_relaxed);
+            readers_m[i].state.store(ACTIVE, std::memory_order_release);
+            id = i;
+            return true;
+        }
+
+        return false;
+    }
+
+    // releases the slot, also required after the reader has been detached by the producer
+    void detach_reader(size_type id) {
+        readers_m[id].state.store(FREE, std::memory_order_release);
+    }
+
+    // true once the reader fell too far behind and was dropped
+    bool detached(size_type id) const {
+        return readers_m[id].state.load(std::memory_order_acquire) == DETACHED;
+    }
+
+    // producer calls this
+    bool try_push(const T& item) {
+        size_type current_tail = tail_m.load(std::memory_order_relaxed);
+        size_type next_tail = current_tail + 1;
+
+        // the cached minimum can only be behind the real one, so this is the fast path
+        if (next_tail - min_cursor_m > gate_lag_()) {
+            min_cursor_m = scan_readers_(current_tail);
+            if (next_tail - min_cursor_m >= buffer_size_m) {
+                return false;
+            }
+        }
+
+        // announce the overwrite before touching the slot, readers validate against it
+        writing_m.store(current_tail, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        size_type index = current_tail & mask_m;
+        T* buffer = get_buf_();
+        std::memcpy(&buffer[index], &item, sizeof(T));
+        tail_m.store(next_tail, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Reads the next message for reader id
+     * @return false if there is nothing new, or if the reader has been detached
+     */
+    bool try_pop(size_type id, T& item) {
+        auto& reader = readers_m[id];
+        size_type cursor = reader.cursor.load(std::memory_order_relaxed);
+        size_type current_tail = tail_m.load(std::memory_order_acquire);
+
+        if (cursor == current_tail) {
+            return false;
+        }
+
+        if (reader.state.load(std::memory_order_relaxed) != ACTIVE) {
+            return false;
+        }
+
+        T* buffer = get_buf_();
+        size_type index = cursor & mask_m;
+        std::memcpy(&item, &buffer[index], sizeof(T));
+
+        // if the producer has started writing a slot one lap ahead, the copy may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (writing_m.load(std::memory_order_relaxed) - cursor >= buffer_size_m) {
+            reader.state.store(DETACHED, std::memory_order_release);
+            return false;
+        }
+
+        reader.cursor.store(cursor + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_type capacity() const noexcept { return buffer_size_m - 1; }
+
+    size_type active_readers() const noexcept {
+        size_type count{};
+        for (const auto& reader : readers_m) {
+            count += reader.state.load(std::memory_order_relaxed) == ACTIVE;
+        }
+        return count;
+    }
+
+    /*
+     * Since this object is meant to exist in a shared memory space, regular RAII rules
+     * don't apply, dtor, ctor and other special members are deleted, since they would
+     * cause UB
+     */
+    broadcast_queue_shm() = delete;
+    ~broadcast_queue_shm() = delete;
+    broadcast_queue_shm(const broadcast_queue_shm&) = delete;
+    broadcast_queue_shm(broadcast_queue_shm&&) = delete;
+    broadcast_queue_shm& operator=(const broadcast_queue_shm&) = delete;
+    broadcast_queue_shm& operator=(broadcast_queue_shm&&) = delete;
+
+private:
+    // each reader's slot gets its own cache line, only the producer's scan reads it
+    struct alignas(64) reader_slot {
+        std::atomic<size_type> cursor;
+        std::atomic<std::uint32_t> state;
+    };
+
+    size_type buffer_offset_m; // offset from object pointer to the buffer
+    size_type buffer_size_m;
+    size_type mask_m;
+    size_type detach_lag_m;
+
+    alignas(64) std::atomic<size_type> tail_m; // producer position
+    std::atomic<size_type> writing_m;          // slot sequence being overwritten
+    size_type min_cursor_m;                    // producer's cached slowest cursor
+
+    reader_slot readers_m[MaxReaders];
+
+    T* get_buf_() {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + buffer_offset_m);
+    }
+
+    size_type gate_lag_() const noexcept {
+        return detach_lag_m == 0 ? buffer_size_m - 1 : detach_lag_m;
+    }
+
+    /*
+     * Recomputes the slowest active cursor, detaching readers that lag more than
+     * detach_lag_m behind if that mode is on. With no active readers the tail itself is
+     * the minimum.
+     */
+    size_type scan_readers_(size_type current_tail) {
+        size_type max_lag{};
+
+        for (auto& reader : readers_m) {
+            if (reader.state.load(std::memory_order_acquire) != ACTIVE) {
+                continue;
+            }
+
+            size_type lag = current_tail - reader.cursor.load(std::memory_order_acquire);
+            if (detach_lag_m != 0 && lag + 1 > detach_lag_m) {
+                std::uint32_t expected = ACTIVE;
+                reader.state.compare_exchange_strong(expected, DETACHED,
+                                                     std::memory_order_acq_rel);
+                continue;
+            }
+
+            max_lag = lag > max_lag ? lag : max_lag;
+        }
+
+        return current_tail - max_lag;
+    }
+};
+
+} // namespace ptorpis
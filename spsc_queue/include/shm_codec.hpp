@@ -0,0 +1,267 @@
+/**
+ * @file data-structures/spsc_queue/include/shm_codec.hpp
+ * @brief Codecs for carrying non-trivially copyable types through spsc_varqueue_shm
+ * @author ptorpis -- Peter Torpis
+ *
+ * A codec for T is a struct with four static functions, all working on a position
+ * relative to the start of a record, which the queue guarantees to be aligned to
+ * record_alignment:
+ *
+ *  - encoded_size(value, pos) -> position just past value if it was encoded at pos
+ *  - encode_into(value, base, pos) -> writes value at base + pos, returns the new
+ *    position
+ *  - decode_from(base, pos) -> an owning T, advances pos
+ *  - view_from(base, pos) -> a view_type that points into the buffer, advances pos
+ *
+ * Every codec aligns pos for its own data, so codecs compose (aggregates simply chain
+ * the codecs of their fields) and views can hand out properly aligned spans.
+ *
+ * Built in: trivially copyable types, std::string, contiguous containers of trivially
+ * copyable elements (ptorpis::vector, std::vector, ...) and aggregates that list their
+ * members through codec_fields.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace ptorpis {
+
+inline constexpr std::size_t record_alignment = 8;
+
+/**
+ * @brief Opt-in field list for aggregates, specialize it with a tuple of member pointers
+ *
+ *     template <> struct ptorpis::codec_fields<Order> {
+ *         static constexpr auto members = std::tuple{&Order::id, &Order::symbol};
+ *     };
+ */
+template <typename T> struct codec_fields;
+
+template <typename T> struct codec;
+
+namespace detail {
+
+constexpr std::size_t codec_align_up(std::size_t pos, std::size_t alignment) noexcept {
+    return (pos + alignment - 1) & ~(alignment - 1);
+}
+
+template <typename T>
+concept has_codec_fields = requires { codec_fields<T>::members; };
+
+template <typename C>
+concept contiguous_container = requires(C& c, const C& cc) {
+    { cc.data() } -> std::convertible_to<const void*>;
+    { cc.size() } -> std::convertible_to<std::size_t>;
+    c.insert(c.end(), cc.data(), cc.data());
+};
+
+template <typename C>
+using container_element_t =
+    std::remove_cvref_t<decltype(*std::declval<const C&>().data())>;
+
+template <typename C>
+concept trivial_element_container =
+    contiguous_container<C> && std::is_trivially_copyable_v<container_element_t<C>>;
+
+} // namespace detail
+
+template <typename C, typename T>
+concept codec_for = requires(const T& value, std::byte* out, const std::byte* in,
+                             std::size_t pos, std::size_t& cursor) {
+    { C::encoded_size(value, pos) } -> std::same_as<std::size_t>;
+    { C::encode_into(value, out, pos) } -> std::same_as<std::size_t>;
+    { C::decode_from(in, cursor) } -> std::same_as<T>;
+    C::view_from(in, cursor);
+};
+
+/**
+ * @brief Trivially copyable types are copied as they are, the view is a reference into
+ * the buffer
+ */
+template <typename T>
+    requires(std::is_trivially_copyable_v<T> && !detail::has_codec_fields<T>)
+struct codec<T> {
+    static_assert(alignof(T) <= record_alignment,
+                  "over-aligned types cannot be placed in a record");
+    using view_type = const T&;
+
+    static std::size_t encoded_size(const T&, std::size_t pos) noexcept {
+        return detail::codec_align_up(pos, alignof(T)) + sizeof(T);
+    }
+
+    static std::size_t encode_into(const T& value, std::byte* out,
+                                   std::size_t pos) noexcept {
+        pos = detail::codec_align_up(pos, alignof(T));
+        std::memcpy(out + pos, &value, sizeof(T));
+        return pos + sizeof(T);
+    }
+
+    static T decode_from(const std::byte* in, std::size_t& pos) noexcept {
+        pos = detail::codec_align_up(pos, alignof(T));
+        T value;
+        std::memcpy(&value, in + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    static view_type view_from(const std::byte* in, std::size_t& pos) noexcept {
+        pos = detail::codec_align_up(pos, alignof(T));
+        const T* value = reinterpret_cast<const T*>(in + pos);
+        pos += sizeof(T);
+        return *value;
+    }
+};
+
+/**
+ * @brief Contiguous containers of trivially copyable elements: a 64 bit element count
+ * followed by the elements, the view is a span over them
+ */
+template <typename C>
+    requires(detail::trivial_element_container<C> && !std::is_trivially_copyable_v<C>)
+struct codec<C> {
+    using element_type = detail::container_element_t<C>;
+    static_assert(alignof(element_type) <= record_alignment,
+                  "over-aligned types cannot be placed in a record");
+    using view_type = std::span<const element_type>;
+
+    static std::size_t encoded_size(const C& value, std::size_t pos) noexcept {
+        pos = detail::codec_align_up(pos, alignof(std::uint64_t)) + sizeof(std::uint64_t);
+        pos = detail::codec_align_up(pos, alignof(element_type));
+        return pos + value.size() * sizeof(element_type);
+    }
+
+    static std::size_t encode_into(const C& value, std::byte* out,
+                                   std::size_t pos) noexcept {
+        auto count = static_cast<std::uint64_t>(value.size());
+        pos = codec<std::uint64_t>::encode_into(count, out, pos);
+        pos = detail::codec_align_up(pos, alignof(element_type));
+        if (count != 0) {
+            std::memcpy(out + pos, value.data(), count * sizeof(element_type));
+        }
+        return pos + count * sizeof(element_type);
+    }
+
+    static C decode_from(const std::byte* in, std::size_t& pos) {
+        view_type elements = view_from(in, pos);
+        C value;
+        if (!elements.empty()) {
+            value.insert(value.end(), elements.data(), elements.data() + elements.size());
+        }
+        return value;
+    }
+
+    static view_type view_from(const std::byte* in, std::size_t& pos) noexcept {
+        auto count = codec<std::uint64_t>::decode_from(in, pos);
+        pos = detail::codec_align_up(pos, alignof(element_type));
+        const auto* first = reinterpret_cast<const element_type*>(in + pos);
+        pos += count * sizeof(element_type);
+        return view_type(first, count);
+    }
+};
+
+/**
+ * @brief Strings are encoded like any other contiguous container, but viewed as a
+ * std::string_view
+ */
+template <> struct codec<std::string> {
+    using view_type = std::string_view;
+
+    static std::size_t encoded_size(const std::string& value, std::size_t pos) noexcept {
+        pos = detail::codec_align_up(pos, alignof(std::uint64_t)) + sizeof(std::uint64_t);
+        return pos + value.size();
+    }
+
+    static std::size_t encode_into(const std::string& value, std::byte* out,
+                                   std::size_t pos) noexcept {
+        pos = codec<std::uint64_t>::encode_into(value.size(), out, pos);
+        std::memcpy(out + pos, value.data(), value.size());
+        return pos + value.size();
+    }
+
+    static std::string decode_from(const std::byte* in, std::size_t& pos) {
+        return std::string(view_from(in, pos));
+    }
+
+    static view_type view_from(const std::byte* in, std::size_t& pos) noexcept {
+        auto length = codec<std::uint64_t>::decode_from(in, pos);
+        const auto* first = reinterpret_cast<const char*>(in + pos);
+        pos += length;
+        return view_type(first, length);
+    }
+};
+
+/**
+ * @brief Aggregates with a codec_fields specialization, encoded field by field in
+ * declaration order, the view is a tuple of the fields' views
+ */
+template <typename T>
+    requires detail::has_codec_fields<T>
+struct codec<T> {
+private:
+    static constexpr auto& members_ = codec_fields<T>::members;
+
+    template <typename M>
+    using field_t = std::remove_cvref_t<decltype(std::declval<T&>().*std::declval<M>())>;
+
+    template <typename Tuple> struct views_of;
+    template <typename... M> struct views_of<std::tuple<M...>> {
+        using type = std::tuple<typename codec<field_t<M>>::view_type...>;
+    };
+
+public:
+    using view_type = typename views_of<std::remove_cvref_t<decltype(members_)>>::type;
+
+    static std::size_t encoded_size(const T& value, std::size_t pos) {
+        std::apply(
+            [&](auto... member) {
+                ((pos = codec<field_t<decltype(member)>>::encoded_size(value.*member,
+                                                                       pos)),
+                 ...);
+            },
+            members_);
+        return pos;
+    }
+
+    static std::size_t encode_into(const T& value, std::byte* out, std::size_t pos) {
+        std::apply(
+            [&](auto... member) {
+                ((pos = codec<field_t<decltype(member)>>::encode_into(value.*member, out,
+                                                                      pos)),
+                 ...);
+            },
+            members_);
+        return pos;
+    }
+
+    static T decode_from(const std::byte* in, std::size_t& pos) {
+        T value{};
+        std::apply(
+            [&](auto... member) {
+                ((value.*member = codec<field_t<decltype(member)>>::decode_from(in, pos)),
+                 ...);
+            },
+            members_);
+        return value;
+    }
+
+    static view_type view_from(const std::byte* in, std::size_t& pos) {
+        // braced init, so the fields are read in order
+        return std::apply(
+            [&](auto... member) {
+                return view_type{codec<field_t<decltype(member)>>::view_from(in, pos)...};
+            },
+            members_);
+    }
+};
+
+} // namespace ptorpis
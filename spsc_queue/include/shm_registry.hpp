@@ -0,0 +1,438 @@
+/**
+ * @file data-structures/spsc_queue/include/shm_registry.hpp
+ * @brief Directory of named spsc_queue_shm channels sharing one shared memory segment
+ * @author ptorpis -- Peter Torpis
+ *
+ * Giving every channel its own shm_open + mmap costs a file descriptor, a /dev/shm entry
+ * and separate TLB entries per queue. The registry instead sits at the start of one
+ * (preferably huge page backed) segment and hands out named queues of any element type
+ * and capacity from the space after it.
+ *
+ * Names are kept in an open addressing hash table inside the segment, so attaching to a
+ * queue by name is O(1). Every queue starts on its own cache line and its size is rounded
+ * up to a whole number of cache lines, so adjacent queues never share one.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "spsc_queue_shm.hpp"
+
+namespace ptorpis {
+
+class shm_registry {
+    using size_type = std::size_t;
+
+    static constexpr size_type CACHE_LINE = 64;
+    enum entry_state : std::uint32_t { EMPTY, CLAIMING, READY, DEAD };
+
+public:
+    static constexpr size_type max_name_length = 47;
+
+    struct queue_info {
+        std::string_view name;
+        size_type element_size;
+        size_type capacity;
+        size_type offset; // of the queue from the start of the registry
+    };
+
+    /**
+     * @brief Bytes taken by the registry itself (header + name table) for max_queues
+     * entries, the queues are placed after this
+     */
+    static constexpr size_type required_size(size_type max_queues) noexcept {
+        return align_up_(sizeof(shm_registry), CACHE_LINE) +
+               table_size_(max_queues) * sizeof(entry);
+    }
+
+    /**
+     * @brief Initializes an empty registry in place, called once by the creator of the
+     * segment
+     * @param region_size Size of the whole segment, the registry sits at its start
+     * @param max_queues Upper bound on the number of queues that will be created
+     */
+    void init(size_type region_size, size_type max_queues) {
+        region_size_m = region_size;
+        table_mask_m = table_size_(max_queues) - 1;
+        max_queues_m = max_queues;
+        queue_count_m.store(0, std::memory_order_relaxed);
+        next_offset_m.store(required_size(max_queues), std::memory_order_relaxed);
+
+        entry* table = table_();
+        for (size_type i{}; i <= table_mask_m; ++i) {
+            table[i].state.store(EMPTY, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Creates and initializes a named queue, safe to call from several processes
+     * @return nullptr if the name is taken or too long, or there is no room left
+     */
+    template <typename T>
+    spsc_queue_shm<T>* create(std::string_view name, size_type capacity) {
+        if (name.size() > max_name_length) {
+            return nullptr;
+        }
+
+        size_type bytes =
+            align_up_(spsc_queue_shm<T>::required_size(capacity), CACHE_LINE);
+        std::uint64_t hash = hash_(name);
+        entry* table = table_();
+
+        for (size_type probe{}; probe <= table_mask_m; ++probe) {
+            entry& e = table[(hash + probe) & table_mask_m];
+            std::uint32_t state = e.state.load(std::memory_order_acquire);
+
+            // a failed CAS leaves the slot's new state in state, slots never go back to
+            // EMPTY so it is handled like any other occupied slot below
+            if (state == EMPTY && e.state.compare_exchange_strong(
+                                      state, CLAIMING, std::memory_order_acq_rel)) {
+                return fill_<T>(e, name, hash, capacity, bytes);
+            }
+
+            state = wait_claimed_(e, state);
+            if (state == READY && matches_(e, name, hash)) {
+                return nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief Looks up a queue created by any process
+     * @return nullptr if there is no queue by that name, or its element size or
+     * alignment does not match T
+     */
+    template <typename T> spsc_queue_shm<T>* attach(std::string_view name) {
+        const entry* e = find_(name);
+        if (!e || e->element_size != sizeof(T) || e->element_align != alignof(T)) {
+            return nullptr;
+        }
+
+        return reinterpret_cast<spsc_queue_shm<T>*>(reinterpret_cast<std::byte*>(this) +
+                                                    e->offset);
+    }
+
+    /**
+     * @brief Control block of the queue described by info, whatever its element type
+     *
+     * Only reads the segment, so it works on a read-only mapping (see
+     * shm_segment::open).
+     */
+    const spsc_queue_shm_base* inspect(const queue_info& info) const noexcept {
+        return reinterpret_cast<const spsc_queue_shm_base*>(
+            reinterpret_cast<const std::byte*>(this) + info.offset);
+    }
+
+    // calls f(queue_info) for every queue, in table order
+    template <typename F> void for_each_queue(F&& f) const {
+        const entry* table = table_();
+        for (size_type i{}; i <= table_mask_m; ++i) {
+            const entry& e = table[i];
+            if (e.state.load(std::memory_order_acquire) != READY) {
+                continue;
+            }
+            f(queue_info{std::string_view(e.name), e.element_size, e.capacity, e.offset});
+        }
+    }
+
+    size_type size() const noexcept {
+        return queue_count_m.load(std::memory_order_relaxed);
+    }
+
+    size_type max_queues() const noexcept { return max_queues_m; }
+
+    size_type bytes_used() const noexcept {
+        return next_offset_m.load(std::memory_order_relaxed);
+    }
+
+    size_type region_size() const noexcept { return region_size_m; }
+
+    /*
+     * Since this object is meant to exist in a shared memory space, regular RAII rules
+     * don't apply, dtor, ctor and other special members are deleted, since they would
+     * cause UB
+     */
+    shm_registry() = delete;
+    ~shm_registry() = delete;
+    shm_registry(const shm_registry&) = delete;
+    shm_registry(shm_registry&&) = delete;
+    shm_registry& operator=(const shm_registry&) = delete;
+    shm_registry& operator=(shm_registry&&) = delete;
+
+private:
+    struct alignas(CACHE_LINE) entry {
+        std::atomic<std::uint32_t> state;
+        std::uint32_t element_size;
+        std::uint32_t element_align;
+        std::uint64_t hash;
+        std::uint64_t offset;
+        std::uint64_t capacity;
+        char name[max_name_length + 1];
+    };
+
+    size_type region_size_m;
+    size_type table_mask_m;
+    size_type max_queues_m;
+    std::atomic<size_type> queue_count_m;
+    std::atomic<size_type> next_offset_m; // bump allocator for queue storage
+
+    static constexpr size_type align_up_(size_type n, size_type alignment) noexcept {
+        return (n + alignment - 1) & ~(alignment - 1);
+    }
+
+    // at most half full, keeps probe sequences short
+    static constexpr size_type table_size_(size_type max_queues) noexcept {
+        return std::bit_ceil(max_queues * 2 < 2 ? 2 : max_queues * 2);
+    }
+
+    static std::uint64_t hash_(std::string_view name) noexcept {
+        std::uint64_t hash = 0xcbf29ce484222325; // FNV-1a
+        for (char c : name) {
+            hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+        }
+        return hash;
+    }
+
+    entry* table_() noexcept {
+        return reinterpret_cast<entry*>(reinterpret_cast<std::byte*>(this) +
+                                        align_up_(sizeof(shm_registry), CACHE_LINE));
+    }
+
+    const entry* table_() const noexcept {
+        return const_cast<shm_registry*>(this)->table_();
+    }
+
+    static bool matches_(const entry& e, std::string_view name, std::uint64_t hash) {
+        return e.hash == hash && std::string_view(e.name) == name;
+    }
+
+    // another process is filling this slot in, its name is not readable until it is done
+    static std::uint32_t wait_claimed_(const entry& e, std::uint32_t state) {
+        while (state == CLAIMING) {
+            state = e.state.load(std::memory_order_acquire);
+        }
+        return state;
+    }
+
+    const entry* find_(std::string_view name) const {
+        std::uint64_t hash = hash_(name);
+        const entry* table = table_();
+
+        for (size_type probe{}; probe <= table_mask_m; ++probe) {
+            const entry& e = table[(hash + probe) & table_mask_m];
+            std::uint32_t state =
+                wait_claimed_(e, e.state.load(std::memory_order_acquire));
+
+            if (state == EMPTY) {
+                return nullptr;
+            }
+            if (state == READY && matches_(e, name, hash)) {
+                return &e;
+            }
+        }
+
+        return nullptr;
+    }
+
+    template <typename T>
+    spsc_queue_shm<T>* fill_(entry& e, std::string_view name, std::uint64_t hash,
+                             size_type capacity, size_type bytes) {
+        std::memcpy(e.name, name.data(), name.size());
+        e.name[name.size()] = '\0';
+        e.hash = hash;
+
+        size_type offset = next_offset_m.load(std::memory_order_relaxed);
+        do {
+            if (queue_count_m.load(std::memory_order_relaxed) >= max_queues_m ||
+                offset + bytes > region_size_m) {
+                // the slot stays a tombstone so probe sequences through it are not cut
+                e.state.store(DEAD, std::memory_order_release);
+                return nullptr;
+            }
+        } while (!next_offset_m.compare_exchange_weak(offset, offset + bytes,
+                                                      std::memory_order_relaxed));
+
+        auto* queue = reinterpret_cast<spsc_queue_shm<T>*>(
+            reinterpret_cast<std::byte*>(this) + offset);
+        queue->init(capacity);
+
+        e.element_size = sizeof(T);
+        e.element_align = alignof(T);
+        e.offset = offset;
+        e.capacity = capacity;
+        queue_count_m.fetch_add(1, std::memory_order_relaxed);
+        e.state.store(READY, std::memory_order_release);
+        return queue;
+    }
+};
+
+/**
+ * @brief Process-local handle to a named shared memory segment for a registry
+ *
+ * Tries a hugetlbfs file under /dev/hugepages first, so the whole segment is backed by
+ * 2 MiB pages, and falls back to a regular POSIX shm object with MADV_HUGEPAGE (which
+ * only takes effect if transparent huge pages are enabled for shmem).
+ */
+class shm_segment {
+    using size_type = std::size_t;
+
+    static constexpr size_type HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+public:
+    shm_segment() = default;
+
+    shm_segment(const shm_segment&) = delete;
+    shm_segment& operator=(const shm_segment&) = delete;
+
+    shm_segment(shm_segment&& other) noexcept
+        : data_m(std::exchange(other.data_m, nullptr)),
+          size_m(std::exchange(other.size_m, 0)),
+          huge_pages_m(other.huge_pages_m) {}
+
+    shm_segment& operator=(shm_segment&& other) noexcept {
+        if (this != &other) {
+            unmap_();
+            data_m = std::exchange(other.data_m, nullptr);
+            size_m = std::exchange(other.size_m, 0);
+            huge_pages_m = other.huge_pages_m;
+        }
+        return *this;
+    }
+
+    ~shm_segment() { unmap_(); }
+
+    /**
+     * @brief Creates (or truncates) the segment called name, "/name" as for shm_open
+     * @throws std::system_error if neither backing can be created
+     */
+    static shm_segment create(const std::string& name, size_type bytes,
+                              bool huge_pages = true) {
+        if (huge_pages) {
+            size_type rounded = (bytes + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+            int fd =
+                ::open(hugetlbfs_path_(name).c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+            if (fd != -1) {
+                shm_segment seg;
+                if (::ftruncate(fd, static_cast<off_t>(rounded)) == -1) {
+                    ::close(fd);
+                } else if (seg.map_(fd, rounded)) {
+                    seg.huge_pages_m = true;
+                    return seg;
+                }
+                ::unlink(hugetlbfs_path_(name).c_str());
+            }
+        }
+
+        int fd = ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0666);
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "shm_open");
+        }
+        if (::ftruncate(fd, static_cast<off_t>(bytes)) == -1) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "ftruncate");
+        }
+
+        shm_segment seg;
+        if (!seg.map_(fd, bytes)) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        if (huge_pages) {
+            ::madvise(seg.data_m, seg.size_m, MADV_HUGEPAGE); // best effort
+        }
+        return seg;
+    }
+
+    /**
+     * @brief Maps an existing segment created by another process
+     * @param read_only Maps the segment without write access, for observers that must
+     * not be able to disturb the queues
+     * @throws std::system_error if there is no segment called name
+     */
+    static shm_segment open(const std::string& name, bool read_only = false) {
+        shm_segment seg;
+        int flags = read_only ? O_RDONLY : O_RDWR;
+        int fd = ::open(hugetlbfs_path_(name).c_str(), flags);
+        seg.huge_pages_m = fd != -1;
+        if (fd == -1) {
+            fd = ::shm_open(name.c_str(), flags, 0666);
+        }
+        if (fd == -1) {
+            throw std::system_error(errno, std::generic_category(), "shm_open");
+        }
+
+        struct stat st;
+        if (::fstat(fd, &st) == -1) {
+            int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "fstat");
+        }
+        if (!seg.map_(fd, static_cast<size_type>(st.st_size), read_only)) {
+            throw std::system_error(errno, std::generic_category(), "mmap");
+        }
+        return seg;
+    }
+
+    // removes the name, mappings stay valid until they are unmapped
+    static void unlink(const std::string& name) {
+        ::unlink(hugetlbfs_path_(name).c_str());
+        ::shm_unlink(name.c_str());
+    }
+
+    void* data() const noexcept { return data_m; }
+    size_type size() const noexcept { return size_m; }
+    bool huge_pages() const noexcept { return huge_pages_m; }
+
+    shm_registry* registry() const noexcept { return static_cast<shm_registry*>(data_m); }
+
+private:
+    void* data_m = nullptr;
+    size_type size_m = 0;
+    bool huge_pages_m = false;
+
+    static std::string hugetlbfs_path_(const std::string& name) {
+        return "/dev/hugepages/" + (name.starts_with('/') ? name.substr(1) : name);
+    }
+
+    // takes ownership of fd, the mapping keeps the object alive after it is closed
+    bool map_(int fd, size_type bytes, bool read_only = false) {
+        int prot = read_only ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* ptr = ::mmap(nullptr, bytes, prot, MAP_SHARED, fd, 0);
+        int error = errno;
+        ::close(fd);
+        errno = error;
+
+        if (ptr == MAP_FAILED) {
+            return false;
+        }
+        data_m = ptr;
+        size_m = bytes;
+        return true;
+    }
+
+    void unmap_() noexcept {
+        if (data_m) {
+            ::munmap(data_m, size_m);
+            data_m = nullptr;
+        }
+    }
+};
+
+} // namespace ptorpis
@@ -0,0 +1,247 @@
+/**
+ * @file data-structures/spsc_queue/include/shm_slab_pool.hpp
+ * @brief Lock-free, size-class based block pool living in shared memory
+ * @author ptorpis -- Peter Torpis
+ *
+ * spsc_queue_shm copies every element with memcpy, which is fine for small messages but
+ * wasteful for large payloads. The pool lets the producer allocate a block in the shared
+ * segment, fill it in place and push only a small shm_block handle through the queue.
+ * The consumer resolves the handle, reads the payload and gives the block back.
+ *
+ * Handles store offsets relative to the pool, never raw pointers, so every process can
+ * map the segment at a different address.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+namespace ptorpis {
+
+/**
+ * @brief Handle to a block in a shm_slab_pool, trivially copyable so it can be passed
+ * through spsc_queue_shm
+ */
+struct shm_block {
+    std::uint64_t offset;     // from the start of the pool
+    std::uint32_t size;       // bytes requested by the allocation
+    std::uint32_t size_class; // index of the class the block came from
+};
+
+/**
+ * @tparam MinBlockSize Block size of the smallest class, must be a power of 2
+ * @tparam ClassCount Number of classes, each one doubles the block size of the previous
+ *
+ * The defaults give classes of 4, 8, 16, 32 and 64 KiB.
+ */
+template <std::size_t MinBlockSize = 4096, std::size_t ClassCount = 5>
+class shm_slab_pool {
+    static_assert(std::has_single_bit(MinBlockSize) && MinBlockSize >= 64,
+                  "block size must be a power of 2 and at least a cache line");
+    static_assert(ClassCount > 0 && ClassCount <= 32);
+    using size_type = std::size_t;
+
+    static constexpr std::uint32_t NIL = UINT32_MAX;
+    static constexpr size_type PAGE_SIZE = 4096;
+
+public:
+    static constexpr size_type max_block_size = MinBlockSize << (ClassCount - 1);
+
+    static constexpr size_type block_size(size_type size_class) noexcept {
+        return MinBlockSize << size_class;
+    }
+
+    /**
+     * @brief Number of bytes the shared segment needs for blocks_per_class blocks in
+     * every class
+     */
+    static constexpr size_type required_size(size_type blocks_per_class) noexcept {
+        size_type bytes = blocks_offset_(blocks_per_class);
+        for (size_type c{}; c < ClassCount; ++c) {
+            bytes += block_size(c) * blocks_per_class;
+        }
+        return bytes;
+    }
+
+    /**
+     * @brief Initializes the pool in place, called once by the creator of the segment
+     *
+     * The object must sit on a page boundary of the segment for the blocks to be page
+     * aligned; they are always at least cache line aligned.
+     */
+    void init(size_type blocks_per_class) {
+        blocks_per_class_m = blocks_per_class;
+
+        size_type offset = blocks_offset_(blocks_per_class);
+        for (size_type c{}; c < ClassCount; ++c) {
+            classes_m[c].blocks_offset = offset;
+            offset += block_size(c) * blocks_per_class;
+
+            // every block starts out on its class's free list, in address order
+            std::atomic<std::uint32_t>* next = links_(c);
+            for (size_type i{}; i < blocks_per_class; ++i) {
+                next[i].store(i + 1 < blocks_per_class ? static_cast<std::uint32_t>(i + 1)
+                                                       : NIL,
+                              std::memory_order_relaxed);
+            }
+            classes_m[c].head.store(pack_(blocks_per_class ? 0 : NIL, 0),
+                                    std::memory_order_relaxed);
+            classes_m[c].free_count.store(blocks_per_class, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Allocates a block of at least bytes bytes
+     *
+     * Takes a block from the smallest class that fits, moving up to larger classes if
+     * that one is exhausted. Safe to call from any number of processes concurrently.
+     *
+     * @return false if bytes exceeds max_block_size or no suitable block is free
+     */
+    bool try_allocate(size_type bytes, shm_block& block) {
+        if (bytes > max_block_size) {
+            return false;
+        }
+
+        size_type first_class =
+            bytes <= MinBlockSize ? 0
+                                  : static_cast<size_type>(
+                                        std::countr_zero(std::bit_ceil(bytes)) -
+                                        std::countr_zero(MinBlockSize));
+
+        for (size_type c{first_class}; c < ClassCount; ++c) {
+            std::uint32_t index = pop_(c);
+            if (index == NIL) {
+                continue;
+            }
+
+            block.offset = classes_m[c].blocks_offset + index * block_size(c);
+            block.size = static_cast<std::uint32_t>(bytes);
+            block.size_class = static_cast<std::uint32_t>(c);
+            return true;
+        }
+
+        return false;
+    }
+
+    // returns the block to its class, any process may free any block
+    void deallocate(const shm_block& block) {
+        size_type c = block.size_class;
+        size_type offset = block.offset - classes_m[c].blocks_offset;
+        auto index = static_cast<std::uint32_t>(offset / block_size(c));
+        push_(c, index);
+    }
+
+    // address of the block in the calling process's mapping
+    void* resolve(const shm_block& block) noexcept {
+        return reinterpret_cast<std::byte*>(this) + block.offset;
+    }
+
+    template <typename T> T* resolve_as(const shm_block& block) noexcept {
+        return static_cast<T*>(resolve(block));
+    }
+
+    size_type free_blocks(size_type size_class) const noexcept {
+        return classes_m[size_class].free_count.load(std::memory_order_relaxed);
+    }
+
+    size_type blocks_per_class() const noexcept { return blocks_per_class_m; }
+
+    /*
+     * Since this object is meant to exist in a shared memory space, regular RAII rules
+     * don't apply, dtor, ctor and other special members are deleted, since they would
+     * cause UB
+     */
+    shm_slab_pool() = delete;
+    ~shm_slab_pool() = delete;
+    shm_slab_pool(const shm_slab_pool&) = delete;
+    shm_slab_pool(shm_slab_pool&&) = delete;
+    shm_slab_pool& operator=(const shm_slab_pool&) = delete;
+    shm_slab_pool& operator=(shm_slab_pool&&) = delete;
+
+private:
+    /*
+     * Free list head packs the index of the first free block with a tag that changes on
+     * every update, so a pop that raced with a pop + push of the same block fails its CAS
+     * instead of corrupting the list (ABA).
+     */
+    struct alignas(64) size_class_state {
+        std::atomic<std::uint64_t> head;
+        std::atomic<size_type> free_count;
+        size_type blocks_offset;
+    };
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "free list heads must be lock-free to be shared between processes");
+
+    size_type blocks_per_class_m;
+    size_class_state classes_m[ClassCount];
+
+    // next-free links live apart from the blocks, so freeing never writes into payload
+    static constexpr size_type links_offset_(size_type size_class,
+                                             size_type blocks_per_class) noexcept {
+        return sizeof(shm_slab_pool) +
+               size_class * blocks_per_class * sizeof(std::atomic<std::uint32_t>);
+    }
+
+    static constexpr size_type blocks_offset_(size_type blocks_per_class) noexcept {
+        size_type end = links_offset_(ClassCount, blocks_per_class);
+        return (end + PAGE_SIZE - 1) & ~(PAGE_SIZE - 1);
+    }
+
+    std::atomic<std::uint32_t>* links_(size_type size_class) noexcept {
+        return reinterpret_cast<std::atomic<std::uint32_t>*>(
+            reinterpret_cast<std::byte*>(this) +
+            links_offset_(size_class, blocks_per_class_m));
+    }
+
+    static std::uint64_t pack_(std::uint32_t index, std::uint32_t tag) noexcept {
+        return (static_cast<std::uint64_t>(tag) << 32) | index;
+    }
+
+    std::uint32_t pop_(size_type size_class) {
+        auto& state = classes_m[size_class];
+        std::atomic<std::uint32_t>* next = links_(size_class);
+        std::uint64_t head = state.head.load(std::memory_order_acquire);
+
+        for (;;) {
+            auto index = static_cast<std::uint32_t>(head);
+            if (index == NIL) {
+                return NIL;
+            }
+
+            auto tag = static_cast<std::uint32_t>(head >> 32);
+            std::uint64_t new_head =
+                pack_(next[index].load(std::memory_order_relaxed), tag + 1);
+            if (state.head.compare_exchange_weak(head, new_head,
+                                                 std::memory_order_acquire,
+                                                 std::memory_order_acquire)) {
+                state.free_count.fetch_sub(1, std::memory_order_relaxed);
+                return index;
+            }
+        }
+    }
+
+    void push_(size_type size_class, std::uint32_t index) {
+        auto& state = classes_m[size_class];
+        std::atomic<std::uint32_t>* next = links_(size_class);
+        std::uint64_t head = state.head.load(std::memory_order_relaxed);
+
+        for (;;) {
+            next[index].store(static_cast<std::uint32_t>(head),
+                              std::memory_order_relaxed);
+            auto tag = static_cast<std::uint32_t>(head >> 32);
+            if (state.head.compare_exchange_weak(head, pack_(index, tag + 1),
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+                state.free_count.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+        }
+    }
+};
+
+} // namespace ptorpis
@@ -0,0 +1,488 @@
+/**
+ * @file data-structures/spsc_queue/include/spsc_journal.hpp
+ * @brief File-backed, append-only journal with replay, built on the same mmap-friendly
+ * layout ideas as spsc_queue_shm
+ * @author ptorpis -- Peter Torpis
+ *
+ * The journal is a directory of fixed-size segment files. Each segment is mapped with
+ * MAP_SHARED, so a record becomes visible to readers in other processes as soon as the
+ * writer publishes the segment's committed counter, and becomes durable once the kernel
+ * (or an explicit sync) writes the page back to the file.
+ *
+ * One writer appends at the tail, any number of readers can start at any retained
+ * sequence number and replay forward, following the writer live if they catch up.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ptorpis {
+
+/**
+ * @brief When the writer flushes dirty pages back to the file
+ *
+ * none: leave it to the kernel's writeback (records survive a process crash, not a
+ * machine crash). msync_async: schedule writeback without waiting. msync / fdatasync:
+ * block until the data hits the disk.
+ */
+enum class journal_sync { none, msync_async, msync, fdatasync };
+
+struct journal_options {
+    std::size_t records_per_segment = 1 << 16;
+    std::size_t retained_segments = 0; // 0 -> never delete old segments
+    std::size_t sync_every = 0;        // 0 -> only sync on rollover and sync()
+    journal_sync sync_mode = journal_sync::none;
+};
+
+namespace detail {
+
+/*
+ * Lives at the start of every segment file, the records follow right after. The
+ * committed counter sits on its own cache line since it is the only field that is
+ * written after the segment is created.
+ */
+struct journal_segment_header {
+    static constexpr std::uint64_t MAGIC = 0x4c4e524a50535053; // "SPSPJRNL"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint64_t base_sequence;
+    std::uint64_t capacity; // records in this segment
+
+    alignas(64) std::atomic<std::uint64_t> committed; // records published
+    std::atomic<std::uint32_t> sealed;                // set once the writer rolls over
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "journal counters must be lock-free to be shared between processes");
+
+inline constexpr std::size_t journal_records_offset = 128;
+static_assert(sizeof(journal_segment_header) <= journal_records_offset);
+
+inline std::filesystem::path journal_segment_path(const std::filesystem::path& dir,
+                                                  std::uint64_t base_sequence) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu.journal",
+                  static_cast<unsigned long long>(base_sequence));
+    return dir / name;
+}
+
+// base sequences of all segment files in the directory, oldest first
+inline std::vector<std::uint64_t>
+journal_list_segments(const std::filesystem::path& dir) {
+    std::vector<std::uint64_t> bases;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        const auto& p = entry.path();
+        if (p.extension() != ".journal") {
+            continue;
+        }
+        bases.push_back(std::stoull(p.stem().string()));
+    }
+    std::sort(bases.begin(), bases.end());
+    return bases;
+}
+
+[[noreturn]] inline void journal_throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+/*
+ * A single mapped segment file. Owns the file descriptor and the mapping.
+ */
+class journal_segment {
+public:
+    journal_segment() = default;
+
+    journal_segment(const journal_segment&) = delete;
+    journal_segment& operator=(const journal_segment&) = delete;
+
+    journal_segment(journal_segment&& other) noexcept
+        : fd_m(std::exchange(other.fd_m, -1)), map_m(std::exchange(other.map_m, nullptr)),
+          map_size_m(std::exchange(other.map_size_m, 0)) {}
+
+    journal_segment& operator=(journal_segment&& other) noexcept {
+        if (this != &other) {
+            close_();
+            fd_m = std::exchange(other.fd_m, -1);
+            map_m = std::exchange(other.map_m, nullptr);
+            map_size_m = std::exchange(other.map_size_m, 0);
+        }
+        return *this;
+    }
+
+    ~journal_segment() { close_(); }
+
+    static journal_segment create(const std::filesystem::path& path,
+                                  std::uint64_t base_sequence, std::uint64_t capacity,
+                                  std::uint32_t record_size) {
+        // built under a temporary name and renamed into place, so a reader never opens a
+        // segment whose header is still being written
+        auto tmp_path = path;
+        tmp_path += ".tmp";
+
+        journal_segment seg;
+        seg.fd_m = ::open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (seg.fd_m == -1) {
+            journal_throw_errno("journal: open segment");
+        }
+
+        seg.map_size_m = journal_records_offset + capacity * record_size;
+        if (::ftruncate(seg.fd_m, static_cast<off_t>(seg.map_size_m)) == -1) {
+            journal_throw_errno("journal: ftruncate segment");
+        }
+
+        seg.map_(PROT_READ | PROT_WRITE);
+
+        // the file is zero-filled, so the atomics already start at 0
+        auto* hdr = seg.header();
+        hdr->magic = journal_segment_header::MAGIC;
+        hdr->version = journal_segment_header::VERSION;
+        hdr->record_size = record_size;
+        hdr->base_sequence = base_sequence;
+        hdr->capacity = capacity;
+
+        if (::rename(tmp_path.c_str(), path.c_str()) == -1) {
+            journal_throw_errno("journal: rename segment");
+        }
+        return seg;
+    }
+
+    static journal_segment open(const std::filesystem::path& path, bool writable,
+                                std::uint32_t record_size) {
+        journal_segment seg;
+        seg.fd_m = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (seg.fd_m == -1) {
+            journal_throw_errno("journal: open segment");
+        }
+
+        struct stat st;
+        if (::fstat(seg.fd_m, &st) == -1) {
+            journal_throw_errno("journal: fstat segment");
+        }
+        seg.map_size_m = static_cast<std::size_t>(st.st_size);
+        if (seg.map_size_m < journal_records_offset) {
+            throw std::runtime_error("journal: truncated segment " + path.string());
+        }
+
+        seg.map_(writable ? PROT_READ | PROT_WRITE : PROT_READ);
+
+        auto* hdr = seg.header();
+        if (hdr->magic != journal_segment_header::MAGIC ||
+            hdr->version != journal_segment_header::VERSION) {
+            throw std::runtime_error("journal: bad segment header " + path.string());
+        }
+        if (hdr->record_size != record_size) {
+            throw std::runtime_error("journal: record size mismatch in " + path.string());
+        }
+        return seg;
+    }
+
+    bool is_open() const noexcept { return map_m != nullptr; }
+
+    journal_segment_header* header() const noexcept {
+        return static_cast<journal_segment_header*>(map_m);
+    }
+
+    std::byte* records() const noexcept {
+        return static_cast<std::byte*>(map_m) + journal_records_offset;
+    }
+
+    void sync(journal_sync mode) const {
+        switch (mode) {
+        case journal_sync::none:
+            return;
+        case journal_sync::msync_async:
+            if (::msync(map_m, map_size_m, MS_ASYNC) == -1) {
+                journal_throw_errno("journal: msync");
+            }
+            return;
+        case journal_sync::msync:
+            if (::msync(map_m, map_size_m, MS_SYNC) == -1) {
+                journal_throw_errno("journal: msync");
+            }
+            return;
+        case journal_sync::fdatasync:
+            if (::fdatasync(fd_m) == -1) {
+                journal_throw_errno("journal: fdatasync");
+            }
+            return;
+        }
+    }
+
+private:
+    int fd_m = -1;
+    void* map_m = nullptr;
+    std::size_t map_size_m = 0;
+
+    void map_(int prot) {
+        map_m = ::mmap(nullptr, map_size_m, prot, MAP_SHARED, fd_m, 0);
+        if (map_m == MAP_FAILED) {
+            map_m = nullptr;
+            journal_throw_errno("journal: mmap segment");
+        }
+    }
+
+    void close_() noexcept {
+        if (map_m) {
+            ::munmap(map_m, map_size_m);
+            map_m = nullptr;
+        }
+        if (fd_m != -1) {
+            ::close(fd_m);
+            fd_m = -1;
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Appends records to the tail of a journal directory
+ *
+ * Opening a directory that already holds segments resumes after the last committed
+ * record. There must be at most one writer per directory at a time.
+ *
+ * @tparam T Record type, copied into the file byte for byte
+ */
+template <typename T> class journal_writer {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "journal_writer requires trivially copyable types");
+    using size_type = std::size_t;
+
+public:
+    /**
+     * @brief Opens (or creates) the journal in dir
+     *
+     * @throws std::invalid_argument if records_per_segment is 0
+     * @throws std::system_error if a segment file cannot be created or mapped
+     * @throws std::runtime_error if an existing segment is corrupt or holds another type
+     */
+    explicit journal_writer(std::filesystem::path dir, journal_options options = {})
+        : dir_m(std::move(dir)), options_m(options) {
+        if (options_m.records_per_segment == 0) {
+            throw std::invalid_argument("journal: records_per_segment must be > 0");
+        }
+
+        std::filesystem::create_directories(dir_m);
+        auto bases = detail::journal_list_segments(dir_m);
+
+        if (bases.empty()) {
+            open_segment_(0);
+            return;
+        }
+
+        segment_m = detail::journal_segment::open(
+            detail::journal_segment_path(dir_m, bases.back()), true, sizeof(T));
+        auto* hdr = segment_m.header();
+        base_m = hdr->base_sequence;
+        capacity_m = hdr->capacity;
+        count_m = hdr->committed.load(std::memory_order_relaxed);
+    }
+
+    journal_writer(const journal_writer&) = delete;
+    journal_writer& operator=(const journal_writer&) = delete;
+
+    ~journal_writer() {
+        if (segment_m.is_open() && options_m.sync_mode != journal_sync::none) {
+            try {
+                segment_m.sync(options_m.sync_mode);
+            } catch (...) {
+                // nothing sensible to do from a destructor
+            }
+        }
+    }
+
+    /**
+     * @brief Appends a record and publishes it to readers
+     *
+     * The hot path is a memcpy into the mapped file and a release store of the committed
+     * counter. Rolling over to a new segment and the periodic sync (if configured)
+     * happen inline every records_per_segment / sync_every records.
+     *
+     * @return The sequence number assigned to the record
+     */
+    std::uint64_t append(const T& item) {
+        if (count_m == capacity_m) {
+            roll_over_();
+        }
+
+        std::memcpy(segment_m.records() + count_m * sizeof(T), &item, sizeof(T));
+        ++count_m;
+        segment_m.header()->committed.store(count_m, std::memory_order_release);
+
+        if (options_m.sync_every != 0 && ++unsynced_m >= options_m.sync_every) {
+            sync();
+        }
+
+        return base_m + count_m - 1;
+    }
+
+    // flushes everything appended so far according to the configured sync mode
+    void sync() {
+        segment_m.sync(options_m.sync_mode == journal_sync::none ? journal_sync::msync
+                                                                  : options_m.sync_mode);
+        unsynced_m = 0;
+    }
+
+    // the sequence number the next append will get
+    std::uint64_t next_sequence() const noexcept { return base_m + count_m; }
+
+    const std::filesystem::path& directory() const noexcept { return dir_m; }
+
+private:
+    std::filesystem::path dir_m;
+    journal_options options_m;
+    detail::journal_segment segment_m;
+    std::uint64_t base_m = 0;
+    size_type capacity_m = 0;
+    size_type count_m = 0;
+    size_type unsynced_m = 0;
+
+    void open_segment_(std::uint64_t base) {
+        segment_m = detail::journal_segment::create(
+            detail::journal_segment_path(dir_m, base), base,
+            options_m.records_per_segment, sizeof(T));
+        base_m = base;
+        capacity_m = options_m.records_per_segment;
+        count_m = 0;
+    }
+
+    void roll_over_() {
+        if (options_m.sync_mode != journal_sync::none) {
+            segment_m.sync(options_m.sync_mode);
+            unsynced_m = 0;
+        }
+
+        // readers waiting at the end of this segment move on once they see the seal
+        segment_m.header()->sealed.store(1, std::memory_order_release);
+        open_segment_(base_m + capacity_m);
+        apply_retention_();
+    }
+
+    void apply_retention_() {
+        if (options_m.retained_segments == 0) {
+            return;
+        }
+
+        auto bases = detail::journal_list_segments(dir_m);
+        if (bases.size() <= options_m.retained_segments) {
+            return;
+        }
+
+        size_type excess = bases.size() - options_m.retained_segments;
+        for (size_type i{}; i < excess; ++i) {
+            // readers that still have the file mapped keep their pages until they unmap
+            std::filesystem::remove(detail::journal_segment_path(dir_m, bases[i]));
+        }
+    }
+};
+
+/**
+ * @brief Replays a journal directory from a given sequence number
+ *
+ * Readers never modify the journal, so any number of them can run concurrently with
+ * the writer, in the same process or in others.
+ */
+template <typename T> class journal_reader {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "journal_reader requires trivially copyable types");
+
+public:
+    /**
+     * @brief Positions the reader at start_sequence
+     *
+     * @throws std::out_of_range if start_sequence was dropped by retention or lies past
+     * the end of the journal
+     */
+    journal_reader(std::filesystem::path dir, std::uint64_t start_sequence = 0)
+        : dir_m(std::move(dir)), position_m(start_sequence) {
+        auto bases = detail::journal_list_segments(dir_m);
+        if (bases.empty()) {
+            throw std::out_of_range("journal: no segments in " + dir_m.string());
+        }
+
+        if (start_sequence < bases.front()) {
+            throw std::out_of_range("journal: sequence no longer retained");
+        }
+
+        // the last segment whose base is not past the requested sequence
+        auto it = std::upper_bound(bases.begin(), bases.end(), start_sequence);
+        open_segment_(*std::prev(it));
+
+        auto* hdr = segment_m.header();
+        if (start_sequence >
+            hdr->base_sequence + hdr->committed.load(std::memory_order_acquire)) {
+            throw std::out_of_range("journal: sequence past the end of the journal");
+        }
+    }
+
+    /**
+     * @brief Reads the record at the current position, if it has been published
+     * @return false if the reader has caught up with the writer
+     */
+    bool try_read(T& item) {
+        auto* hdr = segment_m.header();
+        std::uint64_t offset = position_m - hdr->base_sequence;
+
+        if (offset == hdr->capacity) {
+            if (!hdr->sealed.load(std::memory_order_acquire) || !next_segment_()) {
+                return false;
+            }
+            hdr = segment_m.header();
+            offset = 0;
+        }
+
+        if (offset >= hdr->committed.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        std::memcpy(&item, segment_m.records() + offset * sizeof(T), sizeof(T));
+        ++position_m;
+        return true;
+    }
+
+    // sequence number of the next record try_read will return
+    std::uint64_t position() const noexcept { return position_m; }
+
+private:
+    std::filesystem::path dir_m;
+    detail::journal_segment segment_m;
+    std::uint64_t position_m;
+
+    void open_segment_(std::uint64_t base) {
+        segment_m = detail::journal_segment::open(
+            detail::journal_segment_path(dir_m, base), false, sizeof(T));
+    }
+
+    bool next_segment_() {
+        auto path = detail::journal_segment_path(dir_m, position_m);
+        if (!std::filesystem::exists(path)) {
+            return false;
+        }
+        open_segment_(position_m);
+        return true;
+    }
+};
+
+} // namespace ptorpis
@@ -3,22 +3,102 @@
 #include <atomic>
 #include <bit>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <type_traits>
 
 namespace ptorpis {
-template <typename T> class spsc_queue_shm {
+
+// point-in-time view of a queue's control block, see spsc_queue_shm_base::stats()
+struct spsc_queue_shm_stats {
+    std::size_t capacity;
+    std::size_t head; // total number of items ever popped
+    std::size_t tail; // total number of items ever pushed
+    std::size_t size; // tail - head at the time of the snapshot
+    std::uint64_t push_full; // try_push calls that found the queue full
+    std::uint64_t pop_empty; // try_pop calls that found the queue empty
+};
+
+/**
+ * @brief Control block shared by every spsc_queue_shm<T>
+ *
+ * The layout does not depend on T, so monitoring tools can read any queue's positions
+ * and counters through this type without knowing its element type. Observers only use
+ * relaxed loads and never write, they work on a read-only mapping of the segment.
+ */
+class spsc_queue_shm_base {
+    using size_type = std::size_t;
+
+public:
+    spsc_queue_shm_stats stats() const noexcept {
+        // head first, tail never falls behind a head that was already observed
+        size_type head = head_m.load(std::memory_order_relaxed);
+        size_type tail = tail_m.load(std::memory_order_relaxed);
+        return {buffer_size_m - 1,
+                head,
+                tail,
+                tail >= head ? tail - head : 0,
+                push_full_m.load(std::memory_order_relaxed),
+                pop_empty_m.load(std::memory_order_relaxed)};
+    }
+
+    size_type capacity() const noexcept { return buffer_size_m - 1; }
+
+    // number of bytes between the control block and the first slot
+    size_type buffer_offset() const noexcept { return buffer_offset_m; }
+
+    // sizeof(T) of the queue's elements, each slot is that many bytes
+    size_type element_size() const noexcept { return element_size_m; }
+
+    spsc_queue_shm_base() = delete;
+    ~spsc_queue_shm_base() = delete;
+    spsc_queue_shm_base(const spsc_queue_shm_base&) = delete;
+    spsc_queue_shm_base& operator=(const spsc_queue_shm_base&) = delete;
+
+protected:
+    size_type buffer_offset_m; // offset from object pointer to the buffer
+    size_type element_size_m;
+    size_type buffer_size_m;
+    size_type mask_m;
+
+    alignas(64) std::atomic<size_type> head_m; // consumer position
+    alignas(64) std::atomic<size_type> tail_m; // producer position
+
+    /*
+     * Each counter has a cache line of its own and is bumped with a relaxed load + store,
+     * only when an operation fails. A side spinning on a full or empty queue keeps
+     * writing its counter, next to head_m or tail_m that would invalidate the line the
+     * other side polls on every operation.
+     */
+    alignas(64) std::atomic<std::uint64_t> pop_empty_m;  // written by the consumer
+    alignas(64) std::atomic<std::uint64_t> push_full_m; // written by the producer
+
+    static void bump_(std::atomic<std::uint64_t>& counter) noexcept {
+        counter.store(counter.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    }
+};
+
+template <typename T> class spsc_queue_shm : public spsc_queue_shm_base {
     static_assert(std::is_trivially_copyable_v<T>,
                   "spsc_queue_shm requires trivially copyable types");
     using size_type = std::size_t;
 
 public:
+    // number of bytes the shared segment needs for a queue of this capacity
+    static constexpr size_type required_size(size_type capacity) noexcept {
+        return sizeof(spsc_queue_shm) + sizeof(T) * std::bit_ceil(capacity + 1);
+    }
+
     void init(size_type capacity) {
         buffer_size_m = std::bit_ceil(capacity + 1);
         mask_m = buffer_size_m - 1;
         buffer_offset_m = sizeof(spsc_queue_shm);
+        element_size_m = sizeof(T);
         head_m.store(0, std::memory_order_relaxed);
         tail_m.store(0, std::memory_order_relaxed);
+        pop_empty_m.store(0, std::memory_order_relaxed);
+        push_full_m.store(0, std::memory_order_relaxed);
     }
 
     // producer calls this
@@ -29,6 +109,7 @@ public:
         size_type next_tail = current_tail + 1;
 
         if (next_tail - current_head >= buffer_size_m) {
+            bump_(push_full_m);
             return false;
         }
 
@@ -45,6 +126,7 @@ public:
         size_type current_tail = tail_m.load(std::memory_order_acquire);
 
         if (current_head == current_tail) {
+            bump_(pop_empty_m);
             return false;
         }
 
@@ -68,13 +150,6 @@ public:
     spsc_queue_shm& operator=(spsc_queue_shm&&) = delete;
 
 private:
-    size_type buffer_offset_m; // offset from object pointer to the buffer
-    size_type buffer_size_m;
-    size_type mask_m;
-
-    alignas(64) std::atomic<size_type> head_m; // consumer position
-    alignas(64) std::atomic<size_type> tail_m; // producer position
-
     T* get_buf_() {
         return reinterpret_cast<T*>(reinterpret_cast<char*>(this) + buffer_offset_m);
     }
@@ -0,0 +1,203 @@
+/**
+ * @file data-structures/spsc_queue/include/spsc_varqueue_shm.hpp
+ * @brief Shared memory SPSC queue of variable-length records, filled through codecs
+ * @author ptorpis -- Peter Torpis
+ *
+ * spsc_queue_shm only accepts trivially copyable types with a fixed size. This queue is
+ * a ring of bytes instead: every push reserves exactly as many bytes as the codec asks
+ * for and encodes the value straight into the ring, without an intermediate buffer. The
+ * consumer can either decode into an owning object or look at the record in place
+ * through the codec's view type.
+ *
+ * Record layout: an 8 byte header (payload length + kind) followed by the payload, padded
+ * to record_alignment. A record never wraps around the end of the ring, if it does not
+ * fit the producer fills the rest of the ring with a padding record and starts over at
+ * offset 0.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "shm_codec.hpp"
+
+namespace ptorpis {
+class spsc_varqueue_shm {
+    using size_type = std::size_t;
+
+    struct record_header {
+        std::uint32_t length; // payload bytes, without padding
+        std::uint32_t kind;
+    };
+
+    static constexpr std::uint32_t DATA = 0;
+    static constexpr std::uint32_t PADDING = 1;
+    static constexpr size_type HEADER_SIZE = sizeof(record_header);
+    static_assert(HEADER_SIZE == record_alignment);
+
+public:
+    /**
+     * @brief Number of bytes the shared segment needs for a ring of capacity_bytes
+     */
+    static constexpr size_type required_size(size_type capacity_bytes) noexcept {
+        return sizeof(spsc_varqueue_shm) + ring_size_(capacity_bytes);
+    }
+
+    void init(size_type capacity_bytes) {
+        buffer_size_m = ring_size_(capacity_bytes);
+        mask_m = buffer_size_m - 1;
+        buffer_offset_m = sizeof(spsc_varqueue_shm);
+        head_m.store(0, std::memory_order_relaxed);
+        tail_m.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Encodes item directly into the ring (producer calls this)
+     * @return false if there is not enough free space right now, or if the encoded item
+     * is larger than half the ring (a bigger record could need more than the whole ring
+     * once padding at the wrap point is accounted for)
+     */
+    template <typename T, typename Codec = codec<T>>
+        requires codec_for<Codec, T>
+    bool try_push(const T& item) {
+        size_type payload = Codec::encoded_size(item, 0);
+        size_type record = record_size_(payload);
+        if (record > buffer_size_m / 2 || payload > UINT32_MAX) {
+            return false;
+        }
+
+        size_type current_tail = tail_m.load(std::memory_order_relaxed);
+        size_type current_head = head_m.load(std::memory_order_acquire);
+
+        size_type offset = current_tail & mask_m;
+        size_type until_end = buffer_size_m - offset;
+        size_type padding = record > until_end ? until_end : 0;
+
+        if (current_tail + padding + record - current_head > buffer_size_m) {
+            return false;
+        }
+
+        std::byte* buffer = get_buf_();
+        if (padding != 0) {
+            write_header_(buffer + offset,
+                          static_cast<std::uint32_t>(padding - HEADER_SIZE), PADDING);
+            offset = 0;
+        }
+
+        Codec::encode_into(item, buffer + offset + HEADER_SIZE, 0);
+        write_header_(buffer + offset, static_cast<std::uint32_t>(payload), DATA);
+
+        tail_m.store(current_tail + padding + record, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Decodes the next record into an owning object (consumer calls this)
+     */
+    template <typename T, typename Codec = codec<T>>
+        requires codec_for<Codec, T>
+    bool try_pop(T& item) {
+        return consume_([&](const std::byte* payload) {
+            size_type pos{};
+            item = Codec::decode_from(payload, pos);
+        });
+    }
+
+    /**
+     * @brief Hands a zero-copy view of the next record to f (consumer calls this)
+     *
+     * The view points into the ring and is only valid until f returns, the slot is
+     * released afterwards.
+     */
+    template <typename T, typename Codec = codec<T>, typename F>
+        requires codec_for<Codec, T>
+    bool try_consume(F&& f) {
+        return consume_([&](const std::byte* payload) {
+            size_type pos{};
+            std::forward<F>(f)(Codec::view_from(payload, pos));
+        });
+    }
+
+    size_type capacity_bytes() const noexcept { return buffer_size_m; }
+
+    bool empty() const noexcept {
+        return head_m.load(std::memory_order_relaxed) ==
+               tail_m.load(std::memory_order_acquire);
+    }
+
+    /*
+     * Since this object is meant to exist in a shared memory space, regular RAII rules
+     * don't apply, dtor, ctor and other special members are deleted, since they would
+     * cause UB
+     */
+    spsc_varqueue_shm() = delete;
+    ~spsc_varqueue_shm() = delete;
+    spsc_varqueue_shm(const spsc_varqueue_shm&) = delete;
+    spsc_varqueue_shm(spsc_varqueue_shm&&) = delete;
+    spsc_varqueue_shm& operator=(const spsc_varqueue_shm&) = delete;
+    spsc_varqueue_shm& operator=(spsc_varqueue_shm&&) = delete;
+
+private:
+    size_type buffer_offset_m; // offset from object pointer to the buffer
+    size_type buffer_size_m;
+    size_type mask_m;
+
+    alignas(64) std::atomic<size_type> head_m; // consumer position, in bytes
+    alignas(64) std::atomic<size_type> tail_m; // producer position, in bytes
+
+    std::byte* get_buf_() {
+        return reinterpret_cast<std::byte*>(this) + buffer_offset_m;
+    }
+
+    static constexpr size_type ring_size_(size_type capacity_bytes) noexcept {
+        size_type size = std::bit_ceil(capacity_bytes);
+        return size < 2 * HEADER_SIZE ? 2 * HEADER_SIZE : size;
+    }
+
+    static constexpr size_type record_size_(size_type payload) noexcept {
+        return HEADER_SIZE + detail::codec_align_up(payload, record_alignment);
+    }
+
+    static void write_header_(std::byte* at, std::uint32_t length, std::uint32_t kind) {
+        record_header header{length, kind};
+        std::memcpy(at, &header, HEADER_SIZE);
+    }
+
+    static record_header read_header_(const std::byte* at) {
+        record_header header;
+        std::memcpy(&header, at, HEADER_SIZE);
+        return header;
+    }
+
+    template <typename F> bool consume_(F&& f) {
+        size_type current_head = head_m.load(std::memory_order_relaxed);
+        size_type current_tail = tail_m.load(std::memory_order_acquire);
+
+        if (current_head == current_tail) {
+            return false;
+        }
+
+        std::byte* buffer = get_buf_();
+        size_type offset = current_head & mask_m;
+        record_header header = read_header_(buffer + offset);
+
+        // padding is always published together with the record that follows it
+        if (header.kind == PADDING) {
+            current_head += HEADER_SIZE + header.length;
+            offset = 0;
+            header = read_header_(buffer);
+        }
+
+        f(static_cast<const std::byte*>(buffer + offset + HEADER_SIZE));
+        head_m.store(current_head + record_size_(header.length),
+                     std::memory_order_release);
+        return true;
+    }
+};
+
+} // namespace ptorpis
@@ -0,0 +1,177 @@
+/**
+ * @file data-structures/spsc_queue/src/inspect.cpp
+ * @brief Live view of shared memory queues, for finding where a pipeline stalls
+ *
+ * Maps a segment read-only and periodically prints, for every queue in it, the capacity,
+ * head/tail positions, occupancy, enqueue/dequeue rates over the last interval and the
+ * push-full/pop-empty counters. It only performs relaxed loads on the control blocks, so
+ * it never takes a cache line away from the producer or consumer in exclusive state.
+ *
+ * Usage: spscq_inspect (--queue NAME | --registry NAME) [--interval MS] [--count N]
+ *
+ * --queue expects a segment holding a single spsc_queue_shm at offset 0, --registry a
+ * segment created through shm_segment/shm_registry. --count 0 (the default) samples
+ * until interrupted.
+ */
+
+#include "shm_registry.hpp"
+#include "spsc_queue_shm.hpp"
+
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::string queue;
+    std::string registry;
+    std::chrono::milliseconds interval{1000};
+    std::size_t count = 0;
+};
+
+struct watched_queue {
+    std::string name;
+    const ptorpis::spsc_queue_shm_base* queue;
+    ptorpis::spsc_queue_shm_stats last;
+};
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--queue") {
+            opts.queue = value;
+        } else if (arg == "--registry") {
+            opts.registry = value;
+        } else if (arg == "--interval") {
+            opts.interval = std::chrono::milliseconds(std::strtoull(value, nullptr, 10));
+        } else if (arg == "--count") {
+            opts.count = std::strtoull(value, nullptr, 10);
+        } else {
+            std::println(stderr, "unknown option {}", arg);
+            std::exit(1);
+        }
+    }
+
+    if (opts.queue.empty() == opts.registry.empty()) {
+        std::println(stderr, "usage: spscq_inspect (--queue NAME | --registry NAME) "
+                             "[--interval MS] [--count N]");
+        std::exit(1);
+    }
+    if (opts.interval.count() == 0) {
+        std::println(stderr, "--interval must be > 0");
+        std::exit(1);
+    }
+    return opts;
+}
+
+/*
+ * Rejects segments whose first bytes clearly are not an initialized spsc_queue_shm. The
+ * slots have to fit in the segment, compared by division so a corrupt header cannot
+ * overflow the product
+ */
+bool plausible(const ptorpis::spsc_queue_shm_base* queue, std::size_t segment_size) {
+    std::size_t slots = queue->capacity() + 1;
+    std::size_t offset = queue->buffer_offset();
+    std::size_t element_size = queue->element_size();
+    return offset >= sizeof(ptorpis::spsc_queue_shm_base) && offset <= segment_size &&
+           element_size != 0 && std::has_single_bit(slots) &&
+           slots <= (segment_size - offset) / element_size;
+}
+
+std::vector<watched_queue> collect(const options& opts,
+                                   const ptorpis::shm_segment& segment) {
+    std::vector<watched_queue> queues;
+
+    if (!opts.queue.empty()) {
+        auto* queue = static_cast<const ptorpis::spsc_queue_shm_base*>(segment.data());
+        if (segment.size() < sizeof(ptorpis::spsc_queue_shm_base) ||
+            !plausible(queue, segment.size())) {
+            std::println(stderr, "{} does not look like an initialized spsc_queue_shm",
+                         opts.queue);
+            std::exit(1);
+        }
+        queues.push_back({opts.queue, queue, queue->stats()});
+        return queues;
+    }
+
+    const ptorpis::shm_registry* registry = segment.registry();
+    registry->for_each_queue([&](const ptorpis::shm_registry::queue_info& info) {
+        const auto* queue = registry->inspect(info);
+        queues.push_back({std::string(info.name), queue, queue->stats()});
+    });
+    std::println("{}: {} queues, {} of {} bytes used", opts.registry, queues.size(),
+                 registry->bytes_used(), registry->region_size());
+    return queues;
+}
+
+void print_header() {
+    std::println("{:<24} {:>10} {:>14} {:>14} {:>10} {:>6} {:>12} {:>12} {:>12} {:>12}",
+                 "queue", "capacity", "head", "tail", "size", "occ%", "enq/s", "deq/s",
+                 "push_full", "pop_empty");
+}
+
+void print_row(const watched_queue& w, const ptorpis::spsc_queue_shm_stats& now,
+               double seconds) {
+    double occupancy = now.capacity ? 100.0 * static_cast<double>(now.size) /
+                                          static_cast<double>(now.capacity)
+                                    : 0.0;
+    double enqueue_rate = static_cast<double>(now.tail - w.last.tail) / seconds;
+    double dequeue_rate = static_cast<double>(now.head - w.last.head) / seconds;
+
+    std::println("{:<24} {:>10} {:>14} {:>14} {:>10} {:>6.1f} {:>12.0f} {:>12.0f} {:>12} "
+                 "{:>12}",
+                 w.name, now.capacity, now.head, now.tail, now.size, occupancy,
+                 enqueue_rate, dequeue_rate, now.push_full, now.pop_empty);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+    const std::string& name = opts.queue.empty() ? opts.registry : opts.queue;
+
+    ptorpis::shm_segment segment;
+    try {
+        segment = ptorpis::shm_segment::open(name, /*read_only=*/true);
+    } catch (const std::system_error& e) {
+        std::println(stderr, "cannot open {}: {}", name, e.what());
+        return 1;
+    }
+
+    std::vector<watched_queue> queues = collect(opts, segment);
+    auto last_sample = clock_type::now();
+
+    for (std::size_t sample{}; opts.count == 0 || sample < opts.count; ++sample) {
+        std::this_thread::sleep_for(opts.interval);
+        auto now = clock_type::now();
+        double seconds = std::chrono::duration<double>(now - last_sample).count();
+        last_sample = now;
+
+        print_header();
+        for (auto& w : queues) {
+            ptorpis::spsc_queue_shm_stats stats = w.queue->stats();
+            print_row(w, stats, seconds);
+            w.last = stats;
+        }
+        std::println("");
+    }
+
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include "broadcast_queue_shm.hpp"
+#include "shm_helper.hpp"
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <thread>
+
+using Queue = ptorpis::broadcast_queue_shm<int, 8>;
+
+// Single Process Tests
+
+TEST(BroadcastQueueShm, EveryReaderSeesEveryMessage) {
+    const size_t capacity = 16;
+    ShmHelper shm("/test_bcast_basic", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    size_t r1, r2;
+    ASSERT_TRUE(queue->attach_reader(r1));
+    ASSERT_TRUE(queue->attach_reader(r2));
+    EXPECT_NE(r1, r2);
+    EXPECT_EQ(queue->active_readers(), 2u);
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_TRUE(queue->try_push(i));
+    }
+
+    for (size_t reader : {r1, r2}) {
+        for (int i = 0; i < 10; ++i) {
+            int value;
+            ASSERT_TRUE(queue->try_pop(reader, value));
+            EXPECT_EQ(value, i);
+        }
+        int value;
+        EXPECT_FALSE(queue->try_pop(reader, value));
+    }
+}
+
+TEST(BroadcastQueueShm, ReaderStartsAtCurrentTail) {
+    const size_t capacity = 16;
+    ShmHelper shm("/test_bcast_late", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    size_t early;
+    ASSERT_TRUE(queue->attach_reader(early));
+    queue->try_push(1);
+    queue->try_push(2);
+
+    size_t late;
+    ASSERT_TRUE(queue->attach_reader(late));
+    queue->try_push(3);
+
+    int value;
+    ASSERT_TRUE(queue->try_pop(late, value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(queue->try_pop(late, value));
+
+    ASSERT_TRUE(queue->try_pop(early, value));
+    EXPECT_EQ(value, 1);
+}
+
+TEST(BroadcastQueueShm, NoReadersNeverBlocks) {
+    const size_t capacity = 8;
+    ShmHelper shm("/test_bcast_noreaders", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_TRUE(queue->try_push(i));
+    }
+}
+
+TEST(BroadcastQueueShm, BackpressureOnSlowestReader) {
+    const size_t capacity = 8;
+    ShmHelper shm("/test_bcast_backpressure", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    size_t fast, slow;
+    ASSERT_TRUE(queue->attach_reader(fast));
+    ASSERT_TRUE(queue->attach_reader(slow));
+
+    size_t pushed = 0;
+    while (queue->try_push(static_cast<int>(pushed))) {
+        int value;
+        ASSERT_TRUE(queue->try_pop(fast, value));
+        ++pushed;
+    }
+    EXPECT_EQ(pushed, queue->capacity());
+    EXPECT_FALSE(queue->detached(slow));
+
+    // draining the slow reader frees up room again
+    int value;
+    ASSERT_TRUE(queue->try_pop(slow, value));
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(queue->try_push(999));
+}
+
+TEST(BroadcastQueueShm, DetachedReaderNoLongerGates) {
+    const size_t capacity = 8;
+    ShmHelper shm("/test_bcast_gate", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    size_t reader;
+    ASSERT_TRUE(queue->attach_reader(reader));
+    for (size_t i = 0; i < queue->capacity(); ++i) {
+        ASSERT_TRUE(queue->try_push(static_cast<int>(i)));
+    }
+    EXPECT_FALSE(queue->try_push(0));
+
+    queue->detach_reader(reader);
+    EXPECT_EQ(queue->active_readers(), 0u);
+    EXPECT_TRUE(queue->try_push(0));
+}
+
+TEST(BroadcastQueueShm, LaggingReaderIsDetached) {
+    const size_t capacity = 16;
+    ShmHelper shm("/test_bcast_lag", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity, 4);
+
+    size_t fast, slow;
+    ASSERT_TRUE(queue->attach_reader(fast));
+    ASSERT_TRUE(queue->attach_reader(slow));
+
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(queue->try_push(i));
+        int value;
+        ASSERT_TRUE(queue->try_pop(fast, value));
+        EXPECT_EQ(value, i);
+    }
+
+    EXPECT_TRUE(queue->detached(slow));
+    EXPECT_FALSE(queue->detached(fast));
+
+    int value;
+    EXPECT_FALSE(queue->try_pop(slow, value));
+
+    // the slot is reusable once the reader acknowledges the detach
+    queue->detach_reader(slow);
+    size_t again;
+    ASSERT_TRUE(queue->attach_reader(again));
+    EXPECT_EQ(again, slow);
+    queue->try_push(100);
+    ASSERT_TRUE(queue->try_pop(again, value));
+    EXPECT_EQ(value, 100);
+}
+
+TEST(BroadcastQueueShm, ReaderTableFull) {
+    const size_t capacity = 8;
+    ShmHelper shm("/test_bcast_full", Queue::required_size(capacity));
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    size_t id;
+    for (int i = 0; i < 8; ++i) {
+        ASSERT_TRUE(queue->attach_reader(id));
+    }
+    EXPECT_FALSE(queue->attach_reader(id));
+
+    queue->detach_reader(3);
+    ASSERT_TRUE(queue->attach_reader(id));
+    EXPECT_EQ(id, 3u);
+}
+
+// Multi-Process Tests
+
+TEST(BroadcastQueueShm, MultipleReaderProcesses) {
+    const size_t capacity = 64;
+    const size_t shm_size = Queue::required_size(capacity);
+    const char* shm_name = "/test_bcast_multi";
+    const int NUM_READERS = 3;
+    const int NUM_ITEMS = 20000;
+
+    ShmHelper shm(shm_name, shm_size);
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity);
+
+    // readers are attached up front so none of them misses the start of the stream
+    size_t ids[NUM_READERS];
+    for (auto& id : ids) {
+        ASSERT_TRUE(queue->attach_reader(id));
+    }
+
+    pid_t pids[NUM_READERS];
+    for (int r = 0; r < NUM_READERS; ++r) {
+        pids[r] = fork();
+        ASSERT_NE(pids[r], -1);
+
+        if (pids[r] == 0) {
+            void* ptr = ShmHelper::open(shm_name, shm_size);
+            auto* child_queue = static_cast<Queue*>(ptr);
+
+            for (int i = 0; i < NUM_ITEMS; ++i) {
+                int value;
+                while (!child_queue->try_pop(ids[r], value)) {
+                    if (child_queue->detached(ids[r])) {
+                        std::_Exit(2);
+                    }
+                    std::this_thread::yield();
+                }
+                if (value != i) {
+                    std::_Exit(1);
+                }
+            }
+
+            child_queue->detach_reader(ids[r]);
+            munmap(ptr, shm_size);
+            std::_Exit(0);
+        }
+    }
+
+    for (int i = 0; i < NUM_ITEMS; ++i) {
+        while (!queue->try_push(i)) {
+            std::this_thread::yield();
+        }
+    }
+
+    for (pid_t pid : pids) {
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+    EXPECT_EQ(queue->active_readers(), 0u);
+}
+
+TEST(BroadcastQueueShm, SlowReaderProcessDetachedPublisherKeepsGoing) {
+    const size_t capacity = 32;
+    const size_t shm_size = Queue::required_size(capacity);
+    const char* shm_name = "/test_bcast_slow_proc";
+    const int NUM_ITEMS = 5000;
+
+    ShmHelper shm(shm_name, shm_size);
+    auto* queue = static_cast<Queue*>(shm.get());
+    queue->init(capacity, capacity);
+
+    size_t id;
+    ASSERT_TRUE(queue->attach_reader(id));
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        // Child (slow reader), every value it does get must still be in order
+        void* ptr = ShmHelper::open(shm_name, shm_size);
+        auto* child_queue = static_cast<Queue*>(ptr);
+
+        int last = -1;
+        while (!child_queue->detached(id)) {
+            int value;
+            if (child_queue->try_pop(id, value)) {
+                if (value <= last) {
+                    std::_Exit(1);
+                }
+                last = value;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+
+        munmap(ptr, shm_size);
+        std::_Exit(0);
+    } else {
+        // Parent (publisher) never blocks in detach mode
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            ASSERT_TRUE(queue->try_push(i));
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+        EXPECT_TRUE(queue->detached(id));
+    }
+}
@@ -0,0 +1,207 @@
+#include "spsc_journal.hpp"
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+// Creates a fresh journal directory per test and removes it afterwards
+class JournalDir {
+public:
+    explicit JournalDir(const char* name)
+        : path_(std::filesystem::temp_directory_path() /
+                (std::string(name) + "_" + std::to_string(getpid()))) {
+        std::filesystem::remove_all(path_);
+    }
+
+    ~JournalDir() { std::filesystem::remove_all(path_); }
+
+    const std::filesystem::path& get() const { return path_; }
+
+    size_t segment_count() const {
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(path_)) {
+            if (entry.path().extension() == ".journal") ++count;
+        }
+        return count;
+    }
+
+private:
+    std::filesystem::path path_;
+};
+
+struct Trade {
+    uint64_t id;
+    double price;
+    int32_t quantity;
+};
+
+TEST(Journal, AppendAndReplay) {
+    JournalDir dir("journal_basic");
+    ptorpis::journal_writer<int> writer(dir.get());
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(writer.append(i), static_cast<uint64_t>(i));
+    }
+    EXPECT_EQ(writer.next_sequence(), 100u);
+
+    ptorpis::journal_reader<int> reader(dir.get());
+    for (int i = 0; i < 100; ++i) {
+        int value;
+        ASSERT_TRUE(reader.try_read(value));
+        EXPECT_EQ(value, i);
+    }
+
+    int value;
+    EXPECT_FALSE(reader.try_read(value));
+    EXPECT_EQ(reader.position(), 100u);
+}
+
+TEST(Journal, ReaderStartsAtSequence) {
+    JournalDir dir("journal_start");
+    ptorpis::journal_writer<Trade> writer(dir.get(), {.records_per_segment = 16});
+
+    for (uint64_t i = 0; i < 50; ++i) {
+        writer.append(Trade{i, 100.0 + i, static_cast<int32_t>(i)});
+    }
+
+    // 37 lives in the third segment
+    ptorpis::journal_reader<Trade> reader(dir.get(), 37);
+    for (uint64_t i = 37; i < 50; ++i) {
+        Trade t;
+        ASSERT_TRUE(reader.try_read(t));
+        EXPECT_EQ(t.id, i);
+        EXPECT_DOUBLE_EQ(t.price, 100.0 + i);
+    }
+
+    Trade t;
+    EXPECT_FALSE(reader.try_read(t));
+}
+
+TEST(Journal, SegmentRollover) {
+    JournalDir dir("journal_rollover");
+    ptorpis::journal_writer<int> writer(dir.get(), {.records_per_segment = 8});
+
+    for (int i = 0; i < 8; ++i) writer.append(i);
+    EXPECT_EQ(dir.segment_count(), 1u);
+
+    // the first append past a full segment creates the next one
+    writer.append(8);
+    EXPECT_EQ(dir.segment_count(), 2u);
+
+    for (int i = 9; i < 30; ++i) writer.append(i);
+    EXPECT_EQ(dir.segment_count(), 4u);
+
+    ptorpis::journal_reader<int> reader(dir.get());
+    for (int i = 0; i < 30; ++i) {
+        int value;
+        ASSERT_TRUE(reader.try_read(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(Journal, RetentionDropsOldSegments) {
+    JournalDir dir("journal_retention");
+    ptorpis::journal_writer<int> writer(
+        dir.get(), {.records_per_segment = 8, .retained_segments = 2});
+
+    for (int i = 0; i < 40; ++i) writer.append(i);
+    EXPECT_EQ(dir.segment_count(), 2u);
+
+    EXPECT_THROW(ptorpis::journal_reader<int>(dir.get(), 0), std::out_of_range);
+
+    // oldest retained segment starts at 24
+    ptorpis::journal_reader<int> reader(dir.get(), 24);
+    int value;
+    ASSERT_TRUE(reader.try_read(value));
+    EXPECT_EQ(value, 24);
+}
+
+TEST(Journal, StartPastEndThrows) {
+    JournalDir dir("journal_past_end");
+    ptorpis::journal_writer<int> writer(dir.get());
+    writer.append(1);
+
+    EXPECT_NO_THROW(ptorpis::journal_reader<int>(dir.get(), 1));
+    EXPECT_THROW(ptorpis::journal_reader<int>(dir.get(), 5), std::out_of_range);
+}
+
+TEST(Journal, WriterResumesAfterReopen) {
+    JournalDir dir("journal_resume");
+    {
+        ptorpis::journal_writer<int> writer(dir.get(), {.records_per_segment = 8});
+        for (int i = 0; i < 12; ++i) writer.append(i);
+    }
+
+    ptorpis::journal_writer<int> writer(dir.get(), {.records_per_segment = 8});
+    EXPECT_EQ(writer.next_sequence(), 12u);
+    for (int i = 12; i < 20; ++i) writer.append(i);
+
+    ptorpis::journal_reader<int> reader(dir.get());
+    for (int i = 0; i < 20; ++i) {
+        int value;
+        ASSERT_TRUE(reader.try_read(value));
+        EXPECT_EQ(value, i);
+    }
+}
+
+TEST(Journal, RecordSizeMismatchThrows) {
+    JournalDir dir("journal_mismatch");
+    {
+        ptorpis::journal_writer<int> writer(dir.get());
+        writer.append(1);
+    }
+
+    EXPECT_THROW(ptorpis::journal_reader<Trade>(dir.get()), std::runtime_error);
+}
+
+TEST(Journal, PeriodicSync) {
+    JournalDir dir("journal_sync");
+    ptorpis::journal_writer<int> writer(
+        dir.get(), {.records_per_segment = 64,
+                    .sync_every = 10,
+                    .sync_mode = ptorpis::journal_sync::fdatasync});
+
+    for (int i = 0; i < 200; ++i) writer.append(i);
+    writer.sync();
+
+    ptorpis::journal_reader<int> reader(dir.get(), 150);
+    int value;
+    ASSERT_TRUE(reader.try_read(value));
+    EXPECT_EQ(value, 150);
+}
+
+TEST(Journal, ReaderFollowsLiveWriter) {
+    JournalDir dir("journal_live");
+    const int NUM_ITEMS = 10000;
+
+    // the writer must exist before the reader can position itself
+    ptorpis::journal_writer<int> writer(dir.get(), {.records_per_segment = 256});
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        // Child (reader), tails the journal across segment boundaries
+        ptorpis::journal_reader<int> reader(dir.get());
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            int value;
+            while (!reader.try_read(value)) {
+                std::this_thread::yield();
+            }
+            if (value != i) {
+                std::_Exit(1);
+            }
+        }
+        std::_Exit(0);
+    } else {
+        // Parent (writer)
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            writer.append(i);
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
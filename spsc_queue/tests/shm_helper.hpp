@@ -0,0 +1,56 @@
+#pragma once
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Helper to create shared memory for tests
+class ShmHelper {
+public:
+    ShmHelper(const char* name, size_t size)
+        : name_(name), size_(size), ptr_(nullptr), fd_(-1) {
+
+        shm_unlink(name_);
+
+        fd_ = shm_open(name_, O_CREAT | O_RDWR, 0666);
+        if (fd_ == -1) {
+            throw std::runtime_error("shm_open failed");
+        }
+
+        if (ftruncate(fd_, size_) == -1) {
+            close(fd_);
+            throw std::runtime_error("ftruncate failed");
+        }
+
+        ptr_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (ptr_ == MAP_FAILED) {
+            close(fd_);
+            throw std::runtime_error("mmap failed");
+        }
+    }
+
+    ~ShmHelper() {
+        if (ptr_) munmap(ptr_, size_);
+        if (fd_ != -1) close(fd_);
+        shm_unlink(name_);
+    }
+
+    void* get() { return ptr_; }
+
+    // For child process to open existing shared memory
+    static void* open(const char* name, size_t size) {
+        int fd = shm_open(name, O_RDWR, 0666);
+        if (fd == -1) return nullptr;
+
+        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        return ptr == MAP_FAILED ? nullptr : ptr;
+    }
+
+private:
+    const char* name_;
+    size_t size_;
+    void* ptr_;
+    int fd_;
+};
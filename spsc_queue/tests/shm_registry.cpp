@@ -0,0 +1,221 @@
+#include "shm_registry.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+
+// Creates a fresh segment per test and unlinks it afterwards
+class RegistrySegment {
+public:
+    RegistrySegment(const char* name, size_t bytes, size_t max_queues) : name_(name) {
+        ptorpis::shm_segment::unlink(name_);
+        segment_ = ptorpis::shm_segment::create(name_, bytes);
+        segment_.registry()->init(segment_.size(), max_queues);
+    }
+
+    ~RegistrySegment() { ptorpis::shm_segment::unlink(name_); }
+
+    ptorpis::shm_registry* registry() { return segment_.registry(); }
+    const std::string& name() const { return name_; }
+
+private:
+    std::string name_;
+    ptorpis::shm_segment segment_;
+};
+
+struct Quote {
+    uint64_t instrument;
+    double bid;
+    double ask;
+};
+
+// Single Process Tests
+
+TEST(ShmRegistry, CreateAndAttach) {
+    RegistrySegment seg("/test_registry_basic", 1 << 20, 16);
+    auto* registry = seg.registry();
+
+    auto* created = registry->create<int>("orders", 64);
+    ASSERT_NE(created, nullptr);
+    EXPECT_EQ(registry->size(), 1u);
+
+    auto* attached = registry->attach<int>("orders");
+    EXPECT_EQ(attached, created);
+
+    EXPECT_TRUE(created->try_push(7));
+    int value;
+    ASSERT_TRUE(attached->try_pop(value));
+    EXPECT_EQ(value, 7);
+}
+
+TEST(ShmRegistry, UnknownNameAndTypeMismatch) {
+    RegistrySegment seg("/test_registry_lookup", 1 << 20, 16);
+    auto* registry = seg.registry();
+
+    ASSERT_NE(registry->create<Quote>("quotes", 32), nullptr);
+
+    EXPECT_EQ(registry->attach<Quote>("trades"), nullptr);
+    EXPECT_EQ(registry->attach<int>("quotes"), nullptr);
+    EXPECT_NE(registry->attach<Quote>("quotes"), nullptr);
+}
+
+TEST(ShmRegistry, DuplicateAndLongNamesRejected) {
+    RegistrySegment seg("/test_registry_dup", 1 << 20, 16);
+    auto* registry = seg.registry();
+
+    ASSERT_NE(registry->create<int>("a", 8), nullptr);
+    EXPECT_EQ(registry->create<int>("a", 8), nullptr);
+    EXPECT_EQ(registry->create<double>("a", 8), nullptr);
+
+    std::string long_name(ptorpis::shm_registry::max_name_length + 1, 'x');
+    EXPECT_EQ(registry->create<int>(long_name, 8), nullptr);
+    long_name.pop_back();
+    EXPECT_NE(registry->create<int>(long_name, 8), nullptr);
+}
+
+TEST(ShmRegistry, QueuesAreCacheLineAlignedAndDisjoint) {
+    RegistrySegment seg("/test_registry_layout", 4 << 20, 256);
+    auto* registry = seg.registry();
+
+    for (int i = 0; i < 200; ++i) {
+        size_t capacity = 1 + static_cast<size_t>(i % 13) * 7;
+        std::string name = "channel." + std::to_string(i);
+        if (i % 2) {
+            ASSERT_NE(registry->create<Quote>(name, capacity), nullptr) << name;
+        } else {
+            ASSERT_NE(registry->create<char>(name, capacity), nullptr) << name;
+        }
+    }
+    EXPECT_EQ(registry->size(), 200u);
+
+    std::vector<std::pair<size_t, size_t>> ranges;
+    registry->for_each_queue([&](const ptorpis::shm_registry::queue_info& info) {
+        EXPECT_EQ(info.offset % 64, 0u) << info.name;
+        size_t bytes = info.element_size == sizeof(Quote)
+                           ? ptorpis::spsc_queue_shm<Quote>::required_size(info.capacity)
+                           : ptorpis::spsc_queue_shm<char>::required_size(info.capacity);
+        ranges.emplace_back(info.offset, info.offset + bytes);
+    });
+    ASSERT_EQ(ranges.size(), 200u);
+
+    // no two queues touch the same cache line
+    std::sort(ranges.begin(), ranges.end());
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        EXPECT_LE((ranges[i - 1].second + 63) / 64, ranges[i].first / 64);
+    }
+    EXPECT_LE(ranges.back().second, registry->region_size());
+}
+
+TEST(ShmRegistry, OutOfSpaceAndTableFull) {
+    const size_t max_queues = 4;
+    const size_t bytes = ptorpis::shm_registry::required_size(max_queues) +
+                         ptorpis::spsc_queue_shm<int>::required_size(1000);
+    RegistrySegment seg("/test_registry_space", bytes, max_queues);
+    auto* registry = seg.registry();
+
+    EXPECT_EQ(registry->create<int>("too_big", 5000), nullptr);
+    EXPECT_NE(registry->create<int>("fits", 1000), nullptr);
+    EXPECT_EQ(registry->create<int>("no_room", 1), nullptr);
+
+    // a failed create does not hide later names that probe through its slot
+    EXPECT_NE(registry->attach<int>("fits"), nullptr);
+}
+
+TEST(ShmRegistry, SegmentFallsBackWithoutHugePages) {
+    const char* name = "/test_registry_segment";
+    ptorpis::shm_segment::unlink(name);
+
+    auto segment = ptorpis::shm_segment::create(name, 1 << 16);
+    ASSERT_NE(segment.data(), nullptr);
+    EXPECT_GE(segment.size(), size_t{1 << 16});
+
+    auto reopened = ptorpis::shm_segment::open(name);
+    EXPECT_EQ(reopened.size(), segment.size());
+    EXPECT_EQ(reopened.huge_pages(), segment.huge_pages());
+
+    ptorpis::shm_segment::unlink(name);
+    EXPECT_THROW(ptorpis::shm_segment::open(name), std::system_error);
+}
+
+TEST(ShmRegistry, ReadOnlyInspection) {
+    RegistrySegment seg("/test_registry_inspect", 1 << 20, 16);
+    auto* queue = seg.registry()->create<Quote>("book", 16);
+    ASSERT_NE(queue, nullptr);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_TRUE(queue->try_push(Quote{static_cast<uint64_t>(i), 0.0, 0.0}));
+    }
+
+    auto observer = ptorpis::shm_segment::open(seg.name(), /*read_only=*/true);
+    const ptorpis::shm_registry* registry = observer.registry();
+
+    size_t seen = 0;
+    registry->for_each_queue([&](const ptorpis::shm_registry::queue_info& info) {
+        ptorpis::spsc_queue_shm_stats stats = registry->inspect(info)->stats();
+        EXPECT_EQ(info.name, "book");
+        EXPECT_GE(stats.capacity, info.capacity);
+        EXPECT_EQ(stats.size, 5u);
+        ++seen;
+    });
+    EXPECT_EQ(seen, 1u);
+}
+
+// Multi-Process Tests
+
+TEST(ShmRegistry, ManyChannelsAcrossProcesses) {
+    const int NUM_CHANNELS = 200;
+    const int NUM_ITEMS = 50;
+    RegistrySegment seg("/test_registry_multi", 8 << 20, NUM_CHANNELS);
+    auto* registry = seg.registry();
+
+    for (int c = 0; c < NUM_CHANNELS; ++c) {
+        ASSERT_NE(registry->create<Quote>("md." + std::to_string(c), 64), nullptr);
+    }
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        // Child maps the segment by name and attaches to every channel by name
+        auto segment = ptorpis::shm_segment::open(seg.name());
+        auto* child_registry = segment.registry();
+
+        std::vector<ptorpis::spsc_queue_shm<Quote>*> queues;
+        for (int c = 0; c < NUM_CHANNELS; ++c) {
+            auto* q = child_registry->attach<Quote>("md." + std::to_string(c));
+            if (!q) {
+                std::_Exit(2);
+            }
+            queues.push_back(q);
+        }
+
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            for (int c = 0; c < NUM_CHANNELS; ++c) {
+                Quote quote;
+                while (!queues[c]->try_pop(quote)) {
+                    std::this_thread::yield();
+                }
+                if (quote.instrument != static_cast<uint64_t>(c) ||
+                    quote.bid != static_cast<double>(i)) {
+                    std::_Exit(1);
+                }
+            }
+        }
+        std::_Exit(0);
+    } else {
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            for (int c = 0; c < NUM_CHANNELS; ++c) {
+                auto* q = registry->attach<Quote>("md." + std::to_string(c));
+                Quote quote{static_cast<uint64_t>(c), static_cast<double>(i), 0.0};
+                while (!q->try_push(quote)) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
@@ -0,0 +1,210 @@
+#include "shm_helper.hpp"
+#include "shm_slab_pool.hpp"
+#include "spsc_queue_shm.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <set>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+
+using Pool = ptorpis::shm_slab_pool<>;
+
+// Single Process Tests
+
+TEST(ShmSlabPool, AllocatePicksSmallestClass) {
+    const size_t blocks = 4;
+    ShmHelper shm("/test_slab_class", Pool::required_size(blocks));
+    auto* pool = static_cast<Pool*>(shm.get());
+    pool->init(blocks);
+
+    ptorpis::shm_block block;
+
+    ASSERT_TRUE(pool->try_allocate(100, block));
+    EXPECT_EQ(block.size_class, 0u);
+    EXPECT_EQ(block.size, 100u);
+
+    ASSERT_TRUE(pool->try_allocate(4096, block));
+    EXPECT_EQ(block.size_class, 0u);
+
+    ASSERT_TRUE(pool->try_allocate(4097, block));
+    EXPECT_EQ(block.size_class, 1u);
+
+    ASSERT_TRUE(pool->try_allocate(20000, block));
+    EXPECT_EQ(block.size_class, 3u);
+
+    ASSERT_TRUE(pool->try_allocate(65536, block));
+    EXPECT_EQ(block.size_class, 4u);
+
+    EXPECT_FALSE(pool->try_allocate(65537, block));
+}
+
+TEST(ShmSlabPool, BlocksAreDistinctAndAligned) {
+    const size_t blocks = 8;
+    ShmHelper shm("/test_slab_distinct", Pool::required_size(blocks));
+    auto* pool = static_cast<Pool*>(shm.get());
+    pool->init(blocks);
+
+    std::set<uint64_t> offsets;
+    for (size_t i = 0; i < blocks; ++i) {
+        ptorpis::shm_block block;
+        ASSERT_TRUE(pool->try_allocate(8192, block));
+        EXPECT_EQ(block.offset % 4096, 0u);
+        EXPECT_LE(block.offset + Pool::block_size(block.size_class),
+                  Pool::required_size(blocks));
+        offsets.insert(block.offset);
+    }
+    EXPECT_EQ(offsets.size(), blocks);
+}
+
+TEST(ShmSlabPool, ExhaustedClassFallsBackToLarger) {
+    const size_t blocks = 2;
+    ShmHelper shm("/test_slab_fallback", Pool::required_size(blocks));
+    auto* pool = static_cast<Pool*>(shm.get());
+    pool->init(blocks);
+
+    ptorpis::shm_block block;
+    ASSERT_TRUE(pool->try_allocate(10, block));
+    ASSERT_TRUE(pool->try_allocate(10, block));
+    EXPECT_EQ(pool->free_blocks(0), 0u);
+
+    ASSERT_TRUE(pool->try_allocate(10, block));
+    EXPECT_EQ(block.size_class, 1u);
+}
+
+TEST(ShmSlabPool, DeallocateMakesBlockReusable) {
+    const size_t blocks = 1;
+    using TinyPool = ptorpis::shm_slab_pool<4096, 1>;
+    ShmHelper shm("/test_slab_reuse", TinyPool::required_size(blocks));
+    auto* pool = static_cast<TinyPool*>(shm.get());
+    pool->init(blocks);
+
+    ptorpis::shm_block first, second;
+    ASSERT_TRUE(pool->try_allocate(64, first));
+    EXPECT_FALSE(pool->try_allocate(64, second));
+
+    pool->deallocate(first);
+    EXPECT_EQ(pool->free_blocks(0), 1u);
+    ASSERT_TRUE(pool->try_allocate(64, second));
+    EXPECT_EQ(second.offset, first.offset);
+}
+
+TEST(ShmSlabPool, ConcurrentAllocateDeallocate) {
+    const size_t blocks = 16;
+    const int NUM_THREADS = 4;
+    const int ITERATIONS = 20000;
+    ShmHelper shm("/test_slab_threads", Pool::required_size(blocks));
+    auto* pool = static_cast<Pool*>(shm.get());
+    pool->init(blocks);
+
+    std::vector<std::thread> threads;
+    std::atomic<bool> corrupted{false};
+
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.emplace_back([&, t]() {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                ptorpis::shm_block block;
+                if (!pool->try_allocate(1000, block)) {
+                    continue;
+                }
+
+                // a block handed to two threads at once would get its tag overwritten
+                auto* tag = pool->resolve_as<int>(block);
+                *tag = t;
+                std::this_thread::yield();
+                if (*tag != t) {
+                    corrupted = true;
+                }
+                pool->deallocate(block);
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_FALSE(corrupted);
+    for (size_t c = 0; c < 5; ++c) {
+        EXPECT_EQ(pool->free_blocks(c), blocks);
+    }
+}
+
+// Multi-Process Tests
+
+struct Snapshot {
+    uint32_t sequence;
+    uint32_t fill;
+};
+
+TEST(ShmSlabPool, HandlesThroughQueueAcrossProcesses) {
+    const size_t capacity = 16;
+    const size_t blocks = 8;
+    const int NUM_ITEMS = 500;
+    const char* shm_name = "/test_slab_queue";
+
+    // queue first, pool on the next page boundary of the same segment
+    using Queue = ptorpis::spsc_queue_shm<ptorpis::shm_block>;
+    const size_t queue_bytes = sizeof(Queue) + sizeof(ptorpis::shm_block) *
+                                                   std::bit_ceil(capacity + 1);
+    const size_t pool_offset = (queue_bytes + 4095) & ~size_t{4095};
+    const size_t shm_size = pool_offset + Pool::required_size(blocks);
+
+    ShmHelper shm(shm_name, shm_size);
+    auto* queue = static_cast<Queue*>(shm.get());
+    auto* pool = reinterpret_cast<Pool*>(static_cast<char*>(shm.get()) + pool_offset);
+    queue->init(capacity);
+    pool->init(blocks);
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        // Child (consumer) maps the segment at a different address than the parent
+        void* ptr = ShmHelper::open(shm_name, shm_size);
+        auto* child_queue = static_cast<Queue*>(ptr);
+        auto* child_pool = reinterpret_cast<Pool*>(static_cast<char*>(ptr) + pool_offset);
+
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            ptorpis::shm_block block;
+            while (!child_queue->try_pop(block)) {
+                std::this_thread::yield();
+            }
+
+            auto* bytes = static_cast<unsigned char*>(child_pool->resolve(block));
+            Snapshot header;
+            std::memcpy(&header, bytes, sizeof(header));
+            if (header.sequence != static_cast<uint32_t>(i) ||
+                bytes[block.size - 1] != static_cast<unsigned char>(header.fill)) {
+                std::_Exit(1);
+            }
+
+            child_pool->deallocate(block);
+        }
+
+        munmap(ptr, shm_size);
+        std::_Exit(0);
+    } else {
+        // Parent (producer)
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            size_t bytes = 4096 + static_cast<size_t>(i % 8) * 7000;
+            ptorpis::shm_block block;
+            while (!pool->try_allocate(bytes, block)) {
+                std::this_thread::yield();
+            }
+
+            auto* payload = static_cast<unsigned char*>(pool->resolve(block));
+            Snapshot header{static_cast<uint32_t>(i), static_cast<uint32_t>(i & 0xff)};
+            std::memset(payload, static_cast<int>(header.fill), bytes);
+            std::memcpy(payload, &header, sizeof(header));
+
+            while (!queue->try_push(block)) {
+                std::this_thread::yield();
+            }
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
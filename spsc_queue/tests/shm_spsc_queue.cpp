@@ -1,3 +1,4 @@
+#include "shm_helper.hpp"
 #include "spsc_queue_shm.hpp"
 #include <chrono>
 #include <fcntl.h>
@@ -7,56 +8,6 @@
 #include <thread>
 #include <unistd.h>
 
-// Helper to create shared memory for tests
-class ShmHelper {
-public:
-    ShmHelper(const char* name, size_t size)
-        : name_(name), size_(size), ptr_(nullptr), fd_(-1) {
-
-        shm_unlink(name_);
-
-        fd_ = shm_open(name_, O_CREAT | O_RDWR, 0666);
-        if (fd_ == -1) {
-            throw std::runtime_error("shm_open failed");
-        }
-
-        if (ftruncate(fd_, size_) == -1) {
-            close(fd_);
-            throw std::runtime_error("ftruncate failed");
-        }
-
-        ptr_ = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
-        if (ptr_ == MAP_FAILED) {
-            close(fd_);
-            throw std::runtime_error("mmap failed");
-        }
-    }
-
-    ~ShmHelper() {
-        if (ptr_) munmap(ptr_, size_);
-        if (fd_ != -1) close(fd_);
-        shm_unlink(name_);
-    }
-
-    void* get() { return ptr_; }
-
-    // For child process to open existing shared memory
-    static void* open(const char* name, size_t size) {
-        int fd = shm_open(name, O_RDWR, 0666);
-        if (fd == -1) return nullptr;
-
-        void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-        close(fd);
-        return ptr == MAP_FAILED ? nullptr : ptr;
-    }
-
-private:
-    const char* name_;
-    size_t size_;
-    void* ptr_;
-    int fd_;
-};
-
 template <typename T> size_t calculate_queue_size(size_t capacity) {
     size_t buffer_size = std::bit_ceil(capacity + 1);
     return sizeof(ptorpis::spsc_queue_shm<T>) + sizeof(T) * buffer_size;
@@ -171,6 +122,33 @@ TEST(SPSCQueueShm, EmptyPopFails) {
     EXPECT_FALSE(queue->try_pop(value));
 }
 
+TEST(SPSCQueueShm, StatsAndFailureCounters) {
+    const size_t capacity = 3;
+    const size_t shm_size = calculate_queue_size<int>(capacity);
+
+    ShmHelper shm("/test_stats", shm_size);
+    auto* queue = static_cast<ptorpis::spsc_queue_shm<int>*>(shm.get());
+    queue->init(capacity);
+
+    int value;
+    EXPECT_FALSE(queue->try_pop(value));
+    for (int i = 0; i < 5; ++i) {
+        queue->try_push(i); // 3 fit, 2 find the queue full
+    }
+    EXPECT_TRUE(queue->try_pop(value));
+
+    // observers work through the element-type independent base
+    const ptorpis::spsc_queue_shm_base* base = queue;
+    ptorpis::spsc_queue_shm_stats stats = base->stats();
+    EXPECT_EQ(stats.capacity, 3u);
+    EXPECT_EQ(stats.head, 1u);
+    EXPECT_EQ(stats.tail, 3u);
+    EXPECT_EQ(stats.size, 2u);
+    EXPECT_EQ(stats.push_full, 2u);
+    EXPECT_EQ(stats.pop_empty, 1u);
+    EXPECT_EQ(base->element_size(), sizeof(int));
+}
+
 // Multi-Process Tests
 
 TEST(SPSCQueueShm, TwoProcessBasic) {
@@ -0,0 +1,234 @@
+#include "shm_codec.hpp"
+#include "shm_helper.hpp"
+#include "spsc_varqueue_shm.hpp"
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+
+struct Order {
+    uint64_t id;
+    std::string symbol;
+    ptorpis::vector<double> prices;
+    int32_t side;
+};
+
+template <> struct ptorpis::codec_fields<Order> {
+    static constexpr auto members =
+        std::tuple{&Order::id, &Order::symbol, &Order::prices, &Order::side};
+};
+
+// Codec Tests
+
+TEST(ShmCodec, TrivialRoundTrip) {
+    alignas(8) std::byte buffer[64];
+    size_t end = ptorpis::codec<double>::encode_into(3.5, buffer, 0);
+    EXPECT_EQ(end, sizeof(double));
+    EXPECT_EQ(ptorpis::codec<double>::encoded_size(3.5, 0), end);
+
+    size_t pos = 0;
+    EXPECT_DOUBLE_EQ(ptorpis::codec<double>::decode_from(buffer, pos), 3.5);
+    EXPECT_EQ(pos, end);
+}
+
+TEST(ShmCodec, StringViewPointsIntoBuffer) {
+    alignas(8) std::byte buffer[64];
+    std::string text = "hello";
+    size_t end = ptorpis::codec<std::string>::encode_into(text, buffer, 0);
+    EXPECT_EQ(ptorpis::codec<std::string>::encoded_size(text, 0), end);
+
+    size_t pos = 0;
+    std::string_view view = ptorpis::codec<std::string>::view_from(buffer, pos);
+    EXPECT_EQ(view, "hello");
+    EXPECT_GE(reinterpret_cast<const std::byte*>(view.data()), buffer);
+    EXPECT_LT(reinterpret_cast<const std::byte*>(view.data()), buffer + sizeof(buffer));
+}
+
+TEST(ShmCodec, VectorSpanIsAligned) {
+    alignas(8) std::byte buffer[128];
+    ptorpis::vector<int64_t> values{1, 2, 3};
+
+    // start at an odd position, the count and elements must still be aligned
+    size_t end = ptorpis::codec<ptorpis::vector<int64_t>>::encode_into(values, buffer, 3);
+    EXPECT_EQ(ptorpis::codec<ptorpis::vector<int64_t>>::encoded_size(values, 3), end);
+
+    size_t pos = 3;
+    auto span = ptorpis::codec<ptorpis::vector<int64_t>>::view_from(buffer, pos);
+    ASSERT_EQ(span.size(), 3u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(span.data()) % alignof(int64_t), 0u);
+    EXPECT_EQ(span[2], 3);
+    EXPECT_EQ(pos, end);
+}
+
+TEST(ShmCodec, StdVectorIsSupported) {
+    static_assert(ptorpis::codec_for<ptorpis::codec<std::vector<int>>, std::vector<int>>);
+
+    alignas(8) std::byte buffer[64];
+    std::vector<int> values{4, 5, 6};
+    ptorpis::codec<std::vector<int>>::encode_into(values, buffer, 0);
+
+    size_t pos = 0;
+    EXPECT_EQ(ptorpis::codec<std::vector<int>>::decode_from(buffer, pos), values);
+}
+
+TEST(ShmCodec, AggregateRoundTrip) {
+    static_assert(ptorpis::codec_for<ptorpis::codec<Order>, Order>);
+
+    alignas(8) std::byte buffer[256];
+    Order order{42, "AAPL", {101.5, 101.25}, -1};
+    size_t end = ptorpis::codec<Order>::encode_into(order, buffer, 0);
+    EXPECT_EQ(ptorpis::codec<Order>::encoded_size(order, 0), end);
+
+    size_t pos = 0;
+    Order decoded = ptorpis::codec<Order>::decode_from(buffer, pos);
+    EXPECT_EQ(pos, end);
+    EXPECT_EQ(decoded.id, 42u);
+    EXPECT_EQ(decoded.symbol, "AAPL");
+    EXPECT_EQ(decoded.prices, order.prices);
+    EXPECT_EQ(decoded.side, -1);
+
+    pos = 0;
+    auto [id, symbol, prices, side] = ptorpis::codec<Order>::view_from(buffer, pos);
+    EXPECT_EQ(id, 42u);
+    EXPECT_EQ(symbol, "AAPL");
+    ASSERT_EQ(prices.size(), 2u);
+    EXPECT_DOUBLE_EQ(prices[1], 101.25);
+    EXPECT_EQ(side, -1);
+}
+
+// Queue Tests
+
+TEST(SPSCVarQueueShm, StringsOfDifferentLengths) {
+    ShmHelper shm("/test_varq_strings", ptorpis::spsc_varqueue_shm::required_size(1024));
+    auto* queue = static_cast<ptorpis::spsc_varqueue_shm*>(shm.get());
+    queue->init(1024);
+
+    std::vector<std::string> sent{"", "a", "hello world", std::string(200, 'x')};
+    for (const auto& s : sent) {
+        EXPECT_TRUE(queue->try_push(s));
+    }
+
+    for (const auto& expected : sent) {
+        std::string received;
+        ASSERT_TRUE(queue->try_pop(received));
+        EXPECT_EQ(received, expected);
+    }
+    EXPECT_TRUE(queue->empty());
+}
+
+TEST(SPSCVarQueueShm, ZeroCopyConsume) {
+    ShmHelper shm("/test_varq_view", ptorpis::spsc_varqueue_shm::required_size(1024));
+    auto* queue = static_cast<ptorpis::spsc_varqueue_shm*>(shm.get());
+    queue->init(1024);
+
+    Order order{7, "MSFT", {1.0, 2.0, 3.0}, 1};
+    ASSERT_TRUE(queue->try_push(order));
+
+    bool called = false;
+    EXPECT_TRUE(queue->try_consume<Order>([&](auto view) {
+        auto& [id, symbol, prices, side] = view;
+        EXPECT_EQ(id, 7u);
+        EXPECT_EQ(symbol, "MSFT");
+        EXPECT_EQ(prices.size(), 3u);
+        EXPECT_EQ(side, 1);
+
+        // the view points into the shared segment itself
+        auto* first = static_cast<const char*>(shm.get());
+        EXPECT_GE(symbol.data(), first);
+        EXPECT_LT(symbol.data(), first + ptorpis::spsc_varqueue_shm::required_size(1024));
+        called = true;
+    }));
+    EXPECT_TRUE(called);
+    EXPECT_FALSE(queue->try_consume<Order>([](auto) {}));
+}
+
+TEST(SPSCVarQueueShm, FullAndOversized) {
+    ShmHelper shm("/test_varq_full", ptorpis::spsc_varqueue_shm::required_size(256));
+    auto* queue = static_cast<ptorpis::spsc_varqueue_shm*>(shm.get());
+    queue->init(256);
+
+    EXPECT_FALSE(queue->try_push(std::string(200, 'x')));
+
+    std::string item(48, 'y'); // 8 + 8 + 48 = 64 bytes per record
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(queue->try_push(item));
+    }
+    EXPECT_FALSE(queue->try_push(item));
+
+    std::string out;
+    ASSERT_TRUE(queue->try_pop(out));
+    EXPECT_TRUE(queue->try_push(item));
+}
+
+TEST(SPSCVarQueueShm, WraparoundWithPadding) {
+    ShmHelper shm("/test_varq_wrap", ptorpis::spsc_varqueue_shm::required_size(256));
+    auto* queue = static_cast<ptorpis::spsc_varqueue_shm*>(shm.get());
+    queue->init(256);
+
+    // record sizes that do not divide the ring, so wraps need padding
+    for (int i = 0; i < 500; ++i) {
+        std::string item(static_cast<size_t>(i % 37), static_cast<char>('a' + i % 26));
+        ASSERT_TRUE(queue->try_push(item));
+
+        std::string out;
+        ASSERT_TRUE(queue->try_pop(out));
+        EXPECT_EQ(out, item);
+    }
+}
+
+// Multi-Process Tests
+
+TEST(SPSCVarQueueShm, TwoProcessAggregates) {
+    const size_t capacity = 4096;
+    const size_t shm_size = ptorpis::spsc_varqueue_shm::required_size(capacity);
+    const char* shm_name = "/test_varq_two_process";
+    const int NUM_ITEMS = 5000;
+
+    ShmHelper shm(shm_name, shm_size);
+    auto* queue = static_cast<ptorpis::spsc_varqueue_shm*>(shm.get());
+    queue->init(capacity);
+
+    pid_t pid = fork();
+    ASSERT_NE(pid, -1);
+
+    if (pid == 0) {
+        // Child (consumer)
+        void* ptr = ShmHelper::open(shm_name, shm_size);
+        auto* child_queue = static_cast<ptorpis::spsc_varqueue_shm*>(ptr);
+
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            bool ok = true;
+            while (!child_queue->try_consume<Order>([&](auto view) {
+                auto& [id, symbol, prices, side] = view;
+                ok = id == static_cast<uint64_t>(i) && symbol == std::to_string(i) &&
+                     prices.size() == static_cast<size_t>(i % 5) && side == i % 2;
+            })) {
+                std::this_thread::yield();
+            }
+            if (!ok) {
+                std::_Exit(1);
+            }
+        }
+
+        munmap(ptr, shm_size);
+        std::_Exit(0);
+    } else {
+        // Parent (producer)
+        for (int i = 0; i < NUM_ITEMS; ++i) {
+            Order order{static_cast<uint64_t>(i), std::to_string(i), {}, i % 2};
+            for (int p = 0; p < i % 5; ++p) {
+                order.prices.push_back(p * 0.5);
+            }
+
+            while (!queue->try_push(order)) {
+                std::this_thread::yield();
+            }
+        }
+
+        int status;
+        waitpid(pid, &status, 0);
+        EXPECT_EQ(WEXITSTATUS(status), 0);
+    }
+}
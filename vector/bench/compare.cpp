@@ -0,0 +1,116 @@
+/**
+ * @file data-structures/vector/bench/compare.cpp
+ * @brief operator== and operator<=> on large vectors, ptorpis::vector vs std::vector
+ *
+ * Compares two snapshots of N elements that only differ in the last element, the worst
+ * case for change detection: every element has to be looked at. Prints ns per element
+ * for == and <=> of both containers, for a byte type (memcmp for both operators), int64_t
+ * (memcmp for ==, blocks of memcmp for <=>) and double (vectorized blocks).
+ *
+ * Usage: bench_compare [--count N] [--repeat R]
+ */
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 20;
+};
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+// best time of opts.repeat runs of op, in ns per element
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+template <typename Vector> void fill(Vector& a, Vector& b, std::size_t count) {
+    for (std::size_t i{}; i < count; ++i) {
+        a.push_back(static_cast<typename Vector::value_type>(i % 100));
+    }
+    b = a;
+    b.back() = static_cast<typename Vector::value_type>(101);
+}
+
+template <typename Vector> void measure(const options& opts, double& eq, double& order) {
+    Vector a;
+    Vector b;
+    fill(a, b, opts.count);
+    eq = best_of(opts, [&] { escape(a == b); });
+    order = best_of(opts, [&] { escape(a <=> b); });
+}
+
+template <typename T> void run(std::string_view name, const options& opts) {
+    double std_eq = 0;
+    double std_order = 0;
+    double ptorpis_eq = 0;
+    double ptorpis_order = 0;
+    measure<std::vector<T>>(opts, std_eq, std_order);
+    measure<ptorpis::vector<T>>(opts, ptorpis_eq, ptorpis_order);
+
+    std::println("{:<14} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}", name, std_eq, ptorpis_eq,
+                 std_order, ptorpis_order);
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_compare [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("{} elements, best of {} runs, ns per element", opts.count, opts.repeat);
+    std::println("{:<14} {:>9} {:>9} {:>9} {:>9}", "type", "std ==", "ptorpis ==",
+                 "std <=>", "ptorpis <=>");
+
+    run<unsigned char>("unsigned char", opts);
+    run<std::int64_t>("int64_t", opts);
+    run<double>("double", opts);
+
+    return 0;
+}
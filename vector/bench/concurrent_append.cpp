@@ -0,0 +1,165 @@
+/**
+ * @file data-structures/vector/bench/concurrent_append.cpp
+ * @brief Many threads appending events, a locked vector vs concurrent_append_vector
+ *
+ * W writer threads append N 24-byte events between them, for W = 1, 2, 4 ... up to
+ * --threads, into a ptorpis::vector behind a std::mutex, into a concurrent_append_vector,
+ * and into a concurrent_append_vector reserved in advance so no writer allocates. The
+ * writers start together on a flag. Prints the best of the runs, in millions of events
+ * per second over all writers. Scaling needs as many free cores as writers.
+ *
+ * Usage: bench_concurrent_append [--count N] [--repeat R] [--threads W]
+ */
+
+#include "concurrent_append_vector.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <print>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 8'000'000;
+    std::size_t repeat = 5;
+    std::size_t threads = 16;
+};
+
+struct event {
+    std::uint64_t timestamp;
+    std::uint32_t thread;
+    std::uint32_t kind;
+    std::uint64_t payload;
+};
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+/*
+ * Runs append(thread, i) for opts.count events split over writers threads, best of
+ * opts.repeat runs in million events per second. make() builds the container for a run
+ */
+template <typename Make, typename Append>
+double best_of(const options& opts, std::size_t writers, Make make, Append append) {
+    double best = 0;
+    for (std::size_t r{}; r < opts.repeat; ++r) {
+        auto target = make();
+        std::atomic<bool> go = false;
+        std::vector<std::thread> threads;
+        std::size_t per_writer = opts.count / writers;
+        for (std::size_t t{}; t < writers; ++t) {
+            threads.emplace_back([&, t] {
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                for (std::size_t i{}; i < per_writer; ++i) {
+                    append(*target, t, i);
+                }
+            });
+        }
+
+        auto start = clock_type::now();
+        go.store(true, std::memory_order_release);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        double seconds = std::chrono::duration<double>(clock_type::now() - start).count();
+        escape(target.get());
+
+        double rate = static_cast<double>(per_writer * writers) / seconds / 1e6;
+        best = std::max(best, rate);
+    }
+    return best;
+}
+
+event make_event(std::size_t thread, std::size_t i) {
+    return {i, static_cast<std::uint32_t>(thread), 1, i * 31};
+}
+
+struct locked_vector {
+    std::mutex mutex;
+    ptorpis::vector<event> events;
+};
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--threads") {
+            opts.threads = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_concurrent_append [--count N] "
+                                 "[--repeat R] [--threads W]");
+            std::exit(1);
+        }
+    }
+
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    opts.threads = std::max<std::size_t>(opts.threads, 1);
+    opts.count = std::max(opts.count, opts.threads);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+    using append_vector = ptorpis::concurrent_append_vector<event>;
+
+    std::println("{} events of {} bytes, {} hardware threads, best of {} runs, "
+                 "M events/s",
+                 opts.count, sizeof(event), std::thread::hardware_concurrency(),
+                 opts.repeat);
+    std::println("{:>7} {:>14} {:>14} {:>14}", "writers", "mutex+vector", "concurrent",
+                 "reserved");
+
+    for (std::size_t writers = 1; writers <= opts.threads; writers *= 2) {
+        double locked = best_of(
+            opts, writers, [] { return std::make_unique<locked_vector>(); },
+            [](locked_vector& target, std::size_t t, std::size_t i) {
+                std::lock_guard lock(target.mutex);
+                target.events.push_back(make_event(t, i));
+            });
+
+        double concurrent = best_of(
+            opts, writers, [] { return std::make_unique<append_vector>(); },
+            [](append_vector& target, std::size_t t, std::size_t i) {
+                target.push_back(make_event(t, i));
+            });
+
+        double reserved = best_of(
+            opts, writers,
+            [&] {
+                auto target = std::make_unique<append_vector>();
+                target->reserve(opts.count);
+                return target;
+            },
+            [](append_vector& target, std::size_t t, std::size_t i) {
+                target.push_back(make_event(t, i));
+            });
+
+        std::println("{:>7} {:>14.1f} {:>14.1f} {:>14.1f}", writers, locked, concurrent,
+                     reserved);
+    }
+
+    return 0;
+}
@@ -0,0 +1,155 @@
+/**
+ * @file data-structures/vector/bench/contiguous.cpp
+ * @brief Standard algorithms over ptorpis::vector iterators vs raw pointers
+ *
+ * Copies, fills and compares N trivially copyable elements with the standard algorithms:
+ * through raw pointers (the library's memmove/memset/memcmp paths), through
+ * ptorpis::vector iterators, and with a plain element by element loop. The iterator
+ * columns should match the pointer columns, not the loop.
+ *
+ * Where the library only special-cases raw pointers (libstdc++'s std::ranges::equal),
+ * the iterator column stays element-wise. A std::span over the vector, which the
+ * contiguous iterators make possible, gets the memcmp path back ("eq span").
+ *
+ * Usage: bench_contiguous [--count N] [--repeat R]
+ */
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <span>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 20;
+};
+
+struct pod64 {
+    long values[8];
+
+    bool operator==(const pod64&) const = default;
+};
+
+template <typename T> void escape(T* p) { asm volatile("" : : "g"(p) : "memory"); }
+
+// best time of opts.repeat runs of op, in ns per element
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+// element by element, what the algorithms fall back to for non-contiguous iterators
+template <typename T> void loop_copy(const T* first, const T* last, T* dest) {
+    for (; first != last; ++first, ++dest) {
+        *dest = *first;
+        asm volatile("" : : : "memory");
+    }
+}
+
+template <typename T> void run(std::string_view name, const options& opts) {
+    ptorpis::vector<T> source(opts.count);
+    ptorpis::vector<T> dest(opts.count);
+    const T* src = source.data();
+    T* dst = dest.data();
+    std::size_t n = opts.count;
+
+    double copy_ptr = best_of(opts, [&] {
+        std::copy(src, src + n, dst);
+        escape(dst);
+    });
+    double copy_it = best_of(opts, [&] {
+        std::copy(source.begin(), source.end(), dest.begin());
+        escape(dst);
+    });
+    double ranges_it = best_of(opts, [&] {
+        std::ranges::copy(source, dest.begin());
+        escape(dst);
+    });
+    double copy_loop = best_of(opts, [&] {
+        loop_copy(src, src + n, dst);
+        escape(dst);
+    });
+
+    double fill_ptr = best_of(opts, [&] {
+        std::fill(dst, dst + n, T{});
+        escape(dst);
+    });
+    double fill_it = best_of(opts, [&] {
+        std::ranges::fill(dest, T{});
+        escape(dst);
+    });
+
+    bool equal = true;
+    double equal_ptr = best_of(opts, [&] { equal &= std::equal(src, src + n, dst); });
+    double equal_it = best_of(opts, [&] {
+        equal &= std::ranges::equal(source, dest);
+    });
+    double equal_span = best_of(opts, [&] {
+        equal &= std::ranges::equal(std::span<const T>(source), std::span<const T>(dest));
+    });
+    if (!equal) {
+        std::abort();
+    }
+
+    std::println("{:<6} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} "
+                 "{:>9.3f} {:>9.3f}",
+                 name, copy_ptr, copy_it, ranges_it, copy_loop, fill_ptr, fill_it,
+                 equal_ptr, equal_it, equal_span);
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_contiguous [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("{} elements, best of {} runs, ns per element", opts.count, opts.repeat);
+    std::println("{:<6} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9} {:>9}", "type",
+                 "copy ptr", "copy it", "ranges", "copy loop", "fill ptr", "fill it",
+                 "eq ptr", "eq it", "eq span");
+
+    run<int>("int", opts);
+    run<pod64>("pod64", opts);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file data-structures/vector/bench/growth.cpp
+ * @brief Memory overhead vs push_back throughput of the vector growth policies
+ *
+ * For each growth policy and element size, pushes N elements one by one into a fresh
+ * vector and reports the time per push_back, how many times the buffer was reallocated,
+ * and the unused capacity: averaged over every size from 1 to N (what a vector of a
+ * random size wastes) and at the final size.
+ *
+ * Usage: bench_growth [--count N] [--repeat R]
+ */
+
+#include "growth_policy.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 5;
+};
+
+template <std::size_t N> struct element {
+    std::byte bytes[N];
+};
+
+struct result {
+    double ns_per_push = 0;
+    std::size_t reallocations = 0;
+    double mean_slack = 0;
+    double final_slack = 0;
+};
+
+template <typename Vector> double time_pushes(std::size_t count) {
+    auto start = clock_type::now();
+    Vector v;
+    for (std::size_t i{}; i < count; ++i) {
+        v.emplace_back();
+    }
+    auto elapsed = clock_type::now() - start;
+
+    // keep the loop from being optimized away
+    if (v.size() != count) {
+        std::abort();
+    }
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(count);
+}
+
+template <typename T, typename Policy> result measure(const options& opts) {
+    using vec = ptorpis::vector<T, std::allocator<T>, Policy>;
+
+    result r;
+    r.ns_per_push = time_pushes<vec>(opts.count);
+    for (std::size_t i = 1; i < opts.repeat; ++i) {
+        r.ns_per_push = std::min(r.ns_per_push, time_pushes<vec>(opts.count));
+    }
+
+    // untimed pass for the memory side
+    vec v;
+    double slack_sum = 0;
+    for (std::size_t i{}; i < opts.count; ++i) {
+        std::size_t before = v.capacity();
+        v.emplace_back();
+        if (v.capacity() != before) {
+            ++r.reallocations;
+        }
+        slack_sum += static_cast<double>(v.capacity() - v.size()) /
+                     static_cast<double>(v.capacity());
+    }
+
+    r.mean_slack = 100 * slack_sum / static_cast<double>(opts.count);
+    r.final_slack = 100 * static_cast<double>(v.capacity() - v.size()) /
+                    static_cast<double>(v.capacity());
+    return r;
+}
+
+template <typename T, typename Policy>
+void run(std::string_view name, const options& opts) {
+    result r = measure<T, Policy>(opts);
+    std::println("{:<16} {:>6} {:>10.2f} {:>8} {:>11.1f} {:>11.1f}", name, sizeof(T),
+                 r.ns_per_push, r.reallocations, r.mean_slack, r.final_slack);
+}
+
+template <typename T> void run_policies(const options& opts) {
+    run<T, ptorpis::doubling_growth>("doubling", opts);
+    run<T, ptorpis::one_and_half_growth>("1.5x", opts);
+    run<T, ptorpis::size_class_growth<>>("size_class", opts);
+    run<T, ptorpis::size_class_growth<ptorpis::one_and_half_growth>>("size_class 1.5x",
+                                                                     opts);
+    run<T, ptorpis::page_growth<>>("page", opts);
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_growth [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("{} push_backs into an empty vector, best of {} runs", opts.count,
+                 opts.repeat);
+    std::println("{:<16} {:>6} {:>10} {:>8} {:>11} {:>11}", "policy", "bytes", "ns/push",
+                 "reallocs", "mean slack%", "final slack%");
+
+    run_policies<element<8>>(opts);
+    run_policies<element<24>>(opts);
+    run_policies<element<64>>(opts);
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * @file data-structures/vector/bench/kernels.cpp
+ * @brief SIMD kernels vs the standard algorithms on vectors of int64_t and double
+ *
+ * Scans a vector of N elements with find, find_first_greater, count, min, max and sum.
+ * Each one is timed as the standard algorithm (std::find, std::find_if, std::count,
+ * std::min_element, std::max_element, std::accumulate) and as the kernel at every
+ * instruction set level the CPU supports. The searched value only matches the last
+ * element, so every column scans the whole vector. Prints ns per element and the speedup
+ * of the fastest kernel over the standard algorithm.
+ *
+ * The default N (16384 elements, 128 KiB) is a price ladder that fits in L2, much larger
+ * vectors are limited by memory bandwidth rather than by the instructions.
+ *
+ * Usage: bench_kernels [--count N] [--repeat R]
+ */
+
+#include "kernels.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <numeric>
+#include <print>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+using ptorpis::kernels::isa;
+
+struct options {
+    std::size_t count = 16384;
+    std::size_t repeat = 20;
+};
+
+// keeps the result of a scan alive
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+// best time of opts.repeat runs of op, each run scanning about 64M elements, in ns per
+// element
+template <typename Op> double best_of(const options& opts, Op op) {
+    std::size_t passes = std::max<std::size_t>(1, (std::size_t{1} << 26) / opts.count);
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        for (std::size_t pass{}; pass < passes; ++pass) {
+            op();
+        }
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count * passes);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+template <typename Std, typename Kernel>
+void row(std::string_view name, const options& opts, Std standard, Kernel kernel) {
+    double std_ns = best_of(opts, standard);
+    double ns[3]{};
+    double best = std_ns;
+    for (isa level : {isa::scalar, isa::avx2, isa::avx512}) {
+        auto i = static_cast<std::size_t>(level);
+        if (level > ptorpis::kernels::detected_isa()) {
+            continue;
+        }
+        ns[i] = best_of(opts, [&] { kernel(level); });
+        best = std::min(best, ns[i]);
+    }
+
+    std::println("{:<20} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.3f} {:>8.1f}x", name, std_ns,
+                 ns[0], ns[1], ns[2], std_ns / best);
+}
+
+template <typename T> void run(std::string_view type, const options& opts) {
+    ptorpis::vector<T> v;
+    for (std::size_t i{}; i < opts.count; ++i) {
+        // a ladder of prices around 1000, none above 2000
+        v.push_back(static_cast<T>(1000 + static_cast<long>((i * 7919) % 997) - 498));
+    }
+    const T needle = 2500;
+    v.back() = needle;
+
+    std::println("{} ({} elements)", type, opts.count);
+
+    row("find", opts, [&] { escape(std::find(v.begin(), v.end(), needle)); },
+        [&](isa level) { escape(ptorpis::kernels::find(v, needle, level)); });
+    row("find_first_greater", opts,
+        [&] { escape(std::find_if(v.begin(), v.end(), [&](T x) { return x > 2000; })); },
+        [&](isa level) {
+            escape(ptorpis::kernels::find_first_greater(v, T{2000}, level));
+        });
+    row("count", opts, [&] { escape(std::count(v.begin(), v.end(), needle)); },
+        [&](isa level) { escape(ptorpis::kernels::count(v, needle, level)); });
+    row("min", opts, [&] { escape(*std::min_element(v.begin(), v.end())); },
+        [&](isa level) { escape(ptorpis::kernels::min(v, level)); });
+    row("max", opts, [&] { escape(*std::max_element(v.begin(), v.end())); },
+        [&](isa level) { escape(ptorpis::kernels::max(v, level)); });
+    row("sum", opts, [&] { escape(std::accumulate(v.begin(), v.end(), T{})); },
+        [&](isa level) { escape(ptorpis::kernels::sum(v, level)); });
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_kernels [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("best of {} runs, ns per element (0 = not supported by this CPU)",
+                 opts.repeat);
+    std::println("{:<20} {:>8} {:>8} {:>8} {:>8} {:>9}", "operation", "std", "scalar",
+                 "avx2", "avx512", "speedup");
+
+    run<std::int64_t>("int64_t", opts);
+    run<double>("double", opts);
+
+    return 0;
+}
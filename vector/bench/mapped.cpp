@@ -0,0 +1,137 @@
+/**
+ * @file data-structures/vector/bench/mapped.cpp
+ * @brief Startup cost, rebuilding a vector from a file vs reopening a mapped_vector
+ *
+ * Writes N 16-byte quotes once as a plain binary file and once as a mapped_vector file,
+ * then times what a restart would do with each: read the binary file into a
+ * ptorpis::vector, or reopen the mapped_vector and touch its last element. Also times a
+ * full scan of the reopened mapped_vector, which is when its pages are actually faulted
+ * in. Both files are in the page cache, so this is the warm restart. Prints ms per run.
+ *
+ * Usage: bench_mapped [--count N] [--repeat R] [--dir D]
+ */
+
+#include "mapped_vector.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <print>
+#include <string>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 16'000'000;
+    std::size_t repeat = 5;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+};
+
+struct quote {
+    std::int64_t price;
+    std::int32_t qty;
+    std::int32_t venue;
+};
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+// best time of opts.repeat runs of op, in ms
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ms =
+            std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        best = i == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--dir") {
+            opts.dir = argv[++i];
+        } else {
+            std::println(stderr,
+                         "usage: bench_mapped [--count N] [--repeat R] [--dir D]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+    auto raw_path = opts.dir / "bench_mapped.bin";
+    auto mapped_path = opts.dir / "bench_mapped.vec";
+
+    {
+        ptorpis::mapped_vector<quote> table(mapped_path, ptorpis::mapped_mode::create);
+        table.reserve(opts.count);
+        for (std::size_t i{}; i < opts.count; ++i) {
+            auto n = static_cast<std::int64_t>(i);
+            table.push_back({1000 + n % 997, static_cast<std::int32_t>(n % 100), 1});
+        }
+
+        std::FILE* raw = std::fopen(raw_path.c_str(), "wb");
+        std::fwrite(table.data(), sizeof(quote), table.size(), raw);
+        std::fclose(raw);
+    }
+
+    double rebuild = best_of(opts, [&] {
+        ptorpis::vector<quote> table(opts.count);
+        std::FILE* raw = std::fopen(raw_path.c_str(), "rb");
+        escape(std::fread(table.data(), sizeof(quote), table.size(), raw));
+        std::fclose(raw);
+        escape(table.back().price);
+    });
+
+    double reopen = best_of(opts, [&] {
+        ptorpis::mapped_vector<quote> table(mapped_path, ptorpis::mapped_mode::open);
+        escape(table.back().price);
+    });
+
+    double reopen_scan = best_of(opts, [&] {
+        ptorpis::mapped_vector<quote> table(mapped_path, ptorpis::mapped_mode::open);
+        std::int64_t total = 0;
+        for (const quote& q : table) {
+            total += q.price;
+        }
+        escape(total);
+    });
+
+    std::println("{} quotes ({} MiB), best of {} runs, ms", opts.count,
+                 opts.count * sizeof(quote) >> 20, opts.repeat);
+    std::println("{:<34} {:>10.3f}", "read file into vector", rebuild);
+    std::println("{:<34} {:>10.3f}", "reopen mapped_vector", reopen);
+    std::println("{:<34} {:>10.3f}", "reopen mapped_vector + full scan", reopen_scan);
+
+    std::filesystem::remove(raw_path);
+    std::filesystem::remove(mapped_path);
+    return 0;
+}
@@ -0,0 +1,133 @@
+/**
+ * @file data-structures/vector/bench/segmented.cpp
+ * @brief Appending and reading, ptorpis::vector vs segmented_vector
+ *
+ * Appends N instrument records (64 bytes, not trivially relocatable, so a growing vector
+ * has to move each of them) without reserving, then reads the price of every record
+ * through operator[] and through the iterators. The vector moves every element about
+ * once while growing, the segmented vector never moves one. Reading costs the segmented
+ * vector a bit scan per operator[], and a block check per iterator increment. Prints ns
+ * per element.
+ *
+ * Usage: bench_segmented [--count N] [--repeat R]
+ */
+
+#include "segmented_vector.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 10;
+};
+
+struct instrument {
+    std::int64_t id = 0;
+    std::int64_t price = 0;
+    std::int64_t fields[6]{};
+
+    instrument(std::int64_t i) : id(i), price(1000 + i % 997) {}
+    // user-provided so the vector cannot memcpy the records when it grows
+    instrument(instrument&& other) noexcept : id(other.id), price(other.price) {
+        std::copy(std::begin(other.fields), std::end(other.fields), fields);
+    }
+};
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+// best time of opts.repeat runs of op, in ns per element
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+template <typename Vector> void run(std::string_view name, const options& opts) {
+    double append = best_of(opts, [&] {
+        Vector v;
+        for (std::size_t i{}; i < opts.count; ++i) {
+            v.emplace_back(static_cast<std::int64_t>(i));
+        }
+        escape(&v.back());
+    });
+
+    Vector v;
+    for (std::size_t i{}; i < opts.count; ++i) {
+        v.emplace_back(static_cast<std::int64_t>(i));
+    }
+
+    double index = best_of(opts, [&] {
+        std::int64_t total = 0;
+        for (std::size_t i{}; i < v.size(); ++i) {
+            total += v[i].price;
+        }
+        escape(total);
+    });
+
+    double iterate = best_of(opts, [&] {
+        std::int64_t total = 0;
+        for (const instrument& record : v) {
+            total += record.price;
+        }
+        escape(total);
+    });
+
+    std::println("{:<18} {:>9.3f} {:>9.3f} {:>9.3f}", name, append, index, iterate);
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_segmented [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("{} records of {} bytes, best of {} runs, ns per element", opts.count,
+                 sizeof(instrument), opts.repeat);
+    std::println("{:<18} {:>9} {:>9} {:>9}", "container", "append", "index", "iterate");
+
+    run<ptorpis::vector<instrument>>("vector", opts);
+    run<ptorpis::segmented_vector<instrument>>("segmented_vector", opts);
+
+    return 0;
+}
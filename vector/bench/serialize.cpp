@@ -0,0 +1,169 @@
+/**
+ * @file data-structures/vector/bench/serialize.cpp
+ * @brief Writing and loading a vector of records, element by element vs the binary format
+ *
+ * Writes N 16-byte quotes to a file in --dir (the page cache, so this measures the CPU
+ * side) element by element through a std::ofstream, and with ptorpis::write, which is one
+ * writev, with and without the CRC32C checksum. The file is unlinked before each write,
+ * truncating it would wait for the writeback of the previous run. Then loads them back
+ * element by element through a std::ifstream into a vector, with read_vector, and as a
+ * vector_view over the mapped file, which only reads the header. Prints ms per run.
+ *
+ * Usage: bench_serialize [--count N] [--repeat R] [--dir D]
+ */
+
+#include "serialization.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <print>
+#include <span>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 4'000'000;
+    std::size_t repeat = 5;
+    std::filesystem::path dir = std::filesystem::temp_directory_path();
+};
+
+struct quote {
+    std::int64_t price;
+    std::int32_t qty;
+    std::int32_t venue;
+};
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+// best time of opts.repeat runs of op, in ms
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ms =
+            std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+        best = i == 0 ? ms : std::min(best, ms);
+    }
+    return best;
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--dir") {
+            opts.dir = argv[++i];
+        } else {
+            std::println(stderr,
+                         "usage: bench_serialize [--count N] [--repeat R] [--dir D]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+void write_file(const std::filesystem::path& path, const ptorpis::vector<quote>& quotes,
+                ptorpis::checksum mode) {
+    std::filesystem::remove(path);
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    ptorpis::write(fd, quotes, mode);
+    ::close(fd);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+    auto loop_path = opts.dir / "bench_serialize.loop";
+    auto path = opts.dir / "bench_serialize.bin";
+
+    ptorpis::vector<quote> quotes;
+    for (std::size_t i{}; i < opts.count; ++i) {
+        auto n = static_cast<std::int64_t>(i);
+        quotes.push_back({1000 + n % 997, static_cast<std::int32_t>(n % 100), 1});
+    }
+
+    double write_loop = best_of(opts, [&] {
+        std::filesystem::remove(loop_path);
+        std::ofstream out(loop_path, std::ios::binary);
+        for (const quote& q : quotes) {
+            out.write(reinterpret_cast<const char*>(&q), sizeof(q));
+        }
+    });
+    double write_plain =
+        best_of(opts, [&] { write_file(path, quotes, ptorpis::checksum::none); });
+    double write_crc =
+        best_of(opts, [&] { write_file(path, quotes, ptorpis::checksum::crc32c); });
+
+    double read_loop = best_of(opts, [&] {
+        ptorpis::vector<quote> loaded;
+        std::ifstream in(loop_path, std::ios::binary);
+        quote q;
+        while (in.read(reinterpret_cast<char*>(&q), sizeof(q))) {
+            loaded.push_back(q);
+        }
+        escape(loaded.data());
+    });
+
+    double read_plain = best_of(opts, [&] {
+        int fd = ::open(path.c_str(), O_RDONLY);
+        auto loaded = ptorpis::read_vector<quote>(fd);
+        ::close(fd);
+        escape(loaded.data());
+    });
+
+    auto view_of = [&](bool verify) {
+        return best_of(opts, [&] {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            auto bytes = static_cast<std::size_t>(::lseek(fd, 0, SEEK_END));
+            void* map = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+            ptorpis::vector_view<quote> view(
+                std::span(static_cast<const std::byte*>(map), bytes), verify);
+            escape(view.back().price);
+            ::munmap(map, bytes);
+            ::close(fd);
+        });
+    };
+    double view = view_of(false);
+    double view_crc = view_of(true);
+
+    std::println("{} quotes ({} MiB), best of {} runs, ms", opts.count,
+                 opts.count * sizeof(quote) >> 20, opts.repeat);
+    std::println("{:<36} {:>10.3f}", "ofstream, element by element", write_loop);
+    std::println("{:<36} {:>10.3f}", "ptorpis::write", write_plain);
+    std::println("{:<36} {:>10.3f}", "ptorpis::write + crc32c", write_crc);
+    std::println("{:<36} {:>10.3f}", "ifstream, element by element", read_loop);
+    std::println("{:<36} {:>10.3f}", "read_vector + crc32c check", read_plain);
+    std::println("{:<36} {:>10.3f}", "vector_view over mmap", view);
+    std::println("{:<36} {:>10.3f}", "vector_view over mmap + crc32c check", view_crc);
+
+    std::filesystem::remove(loop_path);
+    std::filesystem::remove(path);
+    return 0;
+}
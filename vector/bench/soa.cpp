@@ -0,0 +1,153 @@
+/**
+ * @file data-structures/vector/bench/soa.cpp
+ * @brief Column scans over 12-field order records, vector of structs vs soa_vector
+ *
+ * Fills N orders and times two passes, each over ptorpis::vector<order> and over the
+ * columns of a soa_vector: the notional value (price * qty) of every order, which reads
+ * two of the twelve fields, and the sum of the prices, kernels::sum for the columns. The
+ * record is 88 bytes and the notional pass needs 12 of them, so with the default N (1M
+ * orders, 88 MB) the struct loop pulls about 7x more bytes through the cache. Prints ns
+ * per row.
+ *
+ * Usage: bench_soa [--count N] [--repeat R]
+ */
+
+#include "kernels.hpp"
+#include "soa_vector.hpp"
+#include "vector.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <span>
+#include <string_view>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 20;
+};
+
+struct order {
+    std::int64_t id;
+    std::int64_t price;
+    std::int32_t qty;
+    std::int32_t side;
+    std::int64_t timestamp;
+    std::int64_t account;
+    std::int64_t instrument;
+    double fee;
+    std::int64_t venue;
+    std::int64_t parent;
+    std::int64_t flags;
+    std::int64_t sequence;
+};
+
+// the fields of order in the same order, price is column 1 and qty column 2
+using order_columns =
+    ptorpis::soa_vector<std::int64_t, std::int64_t, std::int32_t, std::int32_t,
+                        std::int64_t, std::int64_t, std::int64_t, double, std::int64_t,
+                        std::int64_t, std::int64_t, std::int64_t>;
+
+template <typename T> void escape(T value) { asm volatile("" : : "g"(value) : "memory"); }
+
+// best time of opts.repeat runs of op, in ns per row
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_soa [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    ptorpis::vector<order> structs;
+    order_columns columns;
+    structs.reserve(opts.count);
+    columns.reserve(opts.count);
+    for (std::size_t i{}; i < opts.count; ++i) {
+        auto n = static_cast<std::int64_t>(i);
+        auto price = 1000 + n % 997;
+        auto qty = static_cast<std::int32_t>(1 + n % 100);
+        structs.push_back({n, price, qty, 0, n, 7, 42, 0.25, 1, 0, 0, n});
+        columns.emplace_back(n, price, qty, 0, n, 7, 42, 0.25, 1, 0, 0, n);
+    }
+
+    double aos = best_of(opts, [&] {
+        std::int64_t notional = 0;
+        for (const order& o : structs) {
+            notional += o.price * o.qty;
+        }
+        escape(notional);
+    });
+
+    double soa = best_of(opts, [&] {
+        std::span<const std::int64_t> prices = columns.column<1>();
+        std::span<const std::int32_t> qtys = columns.column<2>();
+        std::int64_t notional = 0;
+        for (std::size_t i{}; i < prices.size(); ++i) {
+            notional += prices[i] * qtys[i];
+        }
+        escape(notional);
+    });
+
+    double aos_sum = best_of(opts, [&] {
+        std::int64_t total = 0;
+        for (const order& o : structs) {
+            total += o.price;
+        }
+        escape(total);
+    });
+
+    double soa_sum =
+        best_of(opts, [&] { escape(ptorpis::kernels::sum(columns.column<1>())); });
+
+    std::println("{} orders of {} bytes, best of {} runs, ns per row", opts.count,
+                 sizeof(order), opts.repeat);
+    std::println("{:<22} {:>9} {:>9} {:>9}", "pass", "structs", "columns", "speedup");
+    std::println("{:<22} {:>9.3f} {:>9.3f} {:>8.1f}x", "price * qty", aos, soa,
+                 aos / soa);
+    std::println("{:<22} {:>9.3f} {:>9.3f} {:>8.1f}x", "sum of price (kernel)", aos_sum,
+                 soa_sum, aos_sum / soa_sum);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+/**
+ * @file data-structures/vector/bench/trivial.cpp
+ * @brief Bulk operations on trivial element types, ptorpis::vector vs std::vector
+ *
+ * Times the operations that have trait-dispatched fast paths (fill construction, copy
+ * construction, copy assignment into an existing buffer, clear + destruction) plus
+ * push_back, for int and a 64-byte POD, and prints ns per element for both containers.
+ *
+ * Usage: bench_trivial [--count N] [--repeat R]
+ */
+
+#include "vector.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using clock_type = std::chrono::steady_clock;
+
+struct options {
+    std::size_t count = 1'000'000;
+    std::size_t repeat = 20;
+};
+
+struct pod64 {
+    long values[8];
+};
+
+// makes the optimizer assume the container was read
+template <typename Vector> void escape(Vector& v) {
+    asm volatile("" : : "g"(v.data()) : "memory");
+}
+
+// best time of opts.repeat runs of op, in ns per element
+template <typename Op> double best_of(const options& opts, Op op) {
+    double best = 0;
+    for (std::size_t i{}; i < opts.repeat; ++i) {
+        auto start = clock_type::now();
+        op();
+        double ns = std::chrono::duration<double, std::nano>(clock_type::now() - start)
+                        .count() /
+                    static_cast<double>(opts.count);
+        best = i == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+enum class op { fill, copy, assign, destroy, push_back, count };
+
+template <typename Vector, typename T> double time_op(const options& opts, op which) {
+    const T value{};
+    Vector source(opts.count, value);
+    Vector target(opts.count, value);
+
+    switch (which) {
+    case op::fill:
+        return best_of(opts, [&] {
+            Vector v(opts.count, value);
+            escape(v);
+        });
+    case op::copy:
+        return best_of(opts, [&] {
+            Vector v(source);
+            escape(v);
+        });
+    case op::assign:
+        return best_of(opts, [&] {
+            target = source;
+            escape(target);
+        });
+    case op::destroy:
+        return best_of(opts, [&] {
+            Vector v(source);
+            escape(v);
+            v.clear();
+        });
+    default:
+        return best_of(opts, [&] {
+            Vector v;
+            for (std::size_t i{}; i < opts.count; ++i) {
+                v.push_back(value);
+            }
+            escape(v);
+        });
+    }
+}
+
+using timings = std::array<double, static_cast<std::size_t>(op::count)>;
+
+void print_row(std::string_view name, std::size_t bytes, const timings& t) {
+    std::println("{:<16} {:>6} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f} {:>9.3f}", name, bytes,
+                 t[0], t[1], t[2], t[3], t[4]);
+}
+
+/*
+ * Each operation is timed for both containers back to back, once in each order, keeping
+ * the better time. Whichever container runs second finds malloc's heap in a different
+ * state (push_back leaves it fragmented), which alone can skew a result by 4x.
+ */
+template <typename T> void run(const options& opts) {
+    timings std_ns{};
+    timings ptorpis_ns{};
+
+    for (std::size_t i{}; i < std_ns.size(); ++i) {
+        auto which = static_cast<op>(i);
+
+        double std_first = time_op<std::vector<T>, T>(opts, which);
+        double ptorpis_second = time_op<ptorpis::vector<T>, T>(opts, which);
+        double ptorpis_first = time_op<ptorpis::vector<T>, T>(opts, which);
+        double std_second = time_op<std::vector<T>, T>(opts, which);
+
+        std_ns[i] = std::min(std_first, std_second);
+        ptorpis_ns[i] = std::min(ptorpis_first, ptorpis_second);
+    }
+
+    print_row("std::vector", sizeof(T), std_ns);
+    print_row("ptorpis::vector", sizeof(T), ptorpis_ns);
+}
+
+options parse_args(int argc, char** argv) {
+    options opts;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg = argv[i];
+        if (i + 1 >= argc) {
+            std::println(stderr, "missing value for {}", arg);
+            std::exit(1);
+        }
+
+        if (arg == "--count") {
+            opts.count = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--repeat") {
+            opts.repeat = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            std::println(stderr, "usage: bench_trivial [--count N] [--repeat R]");
+            std::exit(1);
+        }
+    }
+
+    opts.count = std::max<std::size_t>(opts.count, 1);
+    opts.repeat = std::max<std::size_t>(opts.repeat, 1);
+    return opts;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    options opts = parse_args(argc, argv);
+
+    std::println("{} elements, best of {} runs, ns per element", opts.count, opts.repeat);
+    std::println("{:<16} {:>6} {:>9} {:>9} {:>9} {:>9} {:>9}", "container", "bytes",
+                 "fill", "copy", "assign", "destroy", "push_back");
+
+    run<int>(opts);
+    run<pod64>(opts);
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file data-structures/vector/include/comparison.hpp
+ * @brief Equality and lexicographic comparison of element arrays, used by the containers
+ * @author ptorpis -- Peter Torpis
+ *
+ * Comparing two vectors element by element is a loop with an early exit per element,
+ * which the compiler cannot vectorize. When comparing the bytes gives the same answer as
+ * comparing the values, the containers call memcmp instead, which compares many elements
+ * per instruction:
+ *
+ * - equality, for types whose == is the same as comparing their bytes
+ *   (is_trivially_equality_comparable_v: integers, enums, pointers, and opted-in types)
+ * - ordering, only for unsigned byte-sized types (unsigned char, std::byte, char8_t...),
+ *   since memcmp orders bytes, not little-endian integers
+ *
+ * Otherwise, for 4 and 8 byte integers and floating point (where NaN and -0.0 make bytes
+ * and values disagree), the first mismatch is found with the SIMD kernel from kernels.hpp.
+ * Other trivially equality comparable types skip equal blocks with memcmp.
+ *
+ * Aggregates whose == compares every member, and that have no padding, can opt in with
+ *
+ *     template <>
+ *     struct ptorpis::is_trivially_equality_comparable<MyType> : std::true_type {};
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include "kernels.hpp"
+
+namespace ptorpis {
+
+template <typename T>
+struct is_trivially_equality_comparable
+    : std::bool_constant<std::is_scalar_v<T> && !std::is_member_pointer_v<T> &&
+                         std::has_unique_object_representations_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_equality_comparable_v =
+    is_trivially_equality_comparable<T>::value;
+
+namespace detail {
+
+// memcmp orders these the same way as their own operator<=>
+template <typename T>
+inline constexpr bool is_bytewise_orderable_v =
+    sizeof(T) == 1 && is_trivially_equality_comparable_v<T> &&
+    (std::is_unsigned_v<T> || std::same_as<T, std::byte>);
+
+// the comparison the standard containers use: <=> when T has it, otherwise built from <
+template <typename T> constexpr auto synth_three_way(const T& a, const T& b) {
+    if constexpr (std::three_way_comparable<T>) {
+        return a <=> b;
+    } else {
+        if (a < b) {
+            return std::weak_ordering::less;
+        }
+        if (b < a) {
+            return std::weak_ordering::greater;
+        }
+        return std::weak_ordering::equivalent;
+    }
+}
+
+template <typename T>
+concept synth_comparable =
+    std::three_way_comparable<T> || requires(const T& a, const T& b) {
+        { a < b } -> std::convertible_to<bool>;
+    };
+
+// index of the first i where !(a[i] == b[i]), or count
+template <typename T>
+constexpr std::size_t mismatch(const T* a, const T* b, std::size_t count) {
+    constexpr std::size_t block = std::max<std::size_t>(256 / sizeof(T), 1);
+
+    std::size_t i = 0;
+    if !consteval {
+        if constexpr (kernels::detail::has_simd_v<T>) {
+            return kernels::detail::mismatch(a, b, count, kernels::detected_isa());
+        } else if constexpr (is_trivially_equality_comparable_v<T>) {
+            // skip equal blocks with memcmp, then find the element in the block below
+            for (; i + block <= count; i += block) {
+                if (std::memcmp(a + i, b + i, block * sizeof(T)) != 0) {
+                    break;
+                }
+            }
+        }
+    }
+
+    while (i < count && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+template <typename T>
+constexpr bool equal_elements(const T* a, const T* b, std::size_t count) {
+    if constexpr (is_trivially_equality_comparable_v<T>) {
+        if !consteval {
+            return count == 0 || std::memcmp(a, b, count * sizeof(T)) == 0;
+        }
+    }
+    if constexpr (std::is_arithmetic_v<T>) {
+        return mismatch(a, b, count) == count;
+    } else {
+        return std::equal(a, a + count, b);
+    }
+}
+
+/**
+ * Lexicographic comparison of [a, a + a_count) and [b, b + b_count), the same result as
+ * std::lexicographical_compare_three_way with synth_three_way
+ */
+template <typename T>
+constexpr auto compare_elements(const T* a, std::size_t a_count, const T* b,
+                                std::size_t b_count) {
+    using result = decltype(synth_three_way(*a, *b));
+    std::size_t common = std::min(a_count, b_count);
+
+    if constexpr (is_bytewise_orderable_v<T>) {
+        if !consteval {
+            int order = common == 0 ? 0 : std::memcmp(a, b, common);
+            if (order != 0) {
+                return result(order <=> 0);
+            }
+            return result(a_count <=> b_count);
+        }
+    }
+    if constexpr (std::is_arithmetic_v<T> || is_trivially_equality_comparable_v<T>) {
+        std::size_t i = mismatch(a, b, common);
+        if (i != common) {
+            return result(synth_three_way(a[i], b[i]));
+        }
+        return result(a_count <=> b_count);
+    } else {
+        for (std::size_t i = 0; i < common; ++i) {
+            if (auto order = synth_three_way(a[i], b[i]); order != 0) {
+                return result(order);
+            }
+        }
+        return result(a_count <=> b_count);
+    }
+}
+
+} // namespace detail
+
+} // namespace ptorpis
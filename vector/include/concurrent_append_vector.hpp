@@ -0,0 +1,442 @@
+/**
+ * @file data-structures/vector/include/concurrent_append_vector.hpp
+ * @brief Append-only array that many threads can append to at once, without a lock
+ * @author ptorpis -- Peter Torpis
+ *
+ * A writer claims the next index with one fetch_add, constructs the element in place and
+ * publishes it by setting the element's ready flag. Writers never wait for each other,
+ * the only location they all write is the counter.
+ *
+ * The elements are stored in blocks that double in size, the same layout as
+ * segmented_vector (block k holds FirstBlockSize << k elements and starts at index
+ * FirstBlockSize * (2^k - 1)), so an element never moves once it is constructed. The
+ * block table is a fixed array of atomic pointers. The first writer to claim an index in
+ * a block that is not allocated yet allocates it and installs it with a compare
+ * exchange, a writer that loses the race frees its block and uses the winner's. reserve()
+ * allocates the blocks in advance, so the writers never allocate.
+ *
+ * Each block is followed by one ready flag per element in the same allocation. Readers
+ * see an element once its flag is set: is_published(i) tests one index, and size()
+ * returns the length of the published prefix, the watermark below which every element
+ * is ready. size() moves the watermark forward over the flags that were set since the
+ * last call, so readers do the scanning and writers only ever set their own flag.
+ *
+ * The element type must be nothrow destructible. An element is built before its index is
+ * claimed when its constructor may throw (and then moved into place, so the move must not
+ * throw), so every claimed index is published. The exceptions are a failed block
+ * allocation and exceeding max_size(): the claimed index is then never published and the
+ * watermark stops before it. The allocator must be safe to call from several threads.
+ *
+ * Appending is the only thread safe modification. clear() and destruction need every
+ * writer to have finished.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "segmented_vector.hpp"
+
+namespace ptorpis {
+
+/**
+ * @brief Append-only dynamic array with lock-free appends from many threads
+ * @tparam T The type of the elements
+ * @tparam Allocator The allocator the blocks come from, must be thread safe
+ * @tparam FirstBlockSize Elements in the first block, a power of two, every following
+ * block is twice as large as the one before it
+ */
+template <typename T, typename Allocator = std::allocator<T>,
+          std::size_t FirstBlockSize = detail::default_first_block_size<T>>
+class concurrent_append_vector {
+    static_assert(std::has_single_bit(FirstBlockSize),
+                  "FirstBlockSize must be a power of two");
+    static_assert(std::is_nothrow_destructible_v<T>,
+                  "concurrent_append_vector requires nothrow destructible elements");
+    static_assert(std::atomic<bool>::is_always_lock_free);
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+    using flag = std::atomic<bool>;
+
+    template <bool Const> class basic_iterator;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    static constexpr size_type first_block_size = FirstBlockSize;
+
+    // enough blocks for every index a size_type can hold
+    static constexpr size_type max_blocks =
+        std::numeric_limits<size_type>::digits - std::countr_zero(FirstBlockSize);
+
+    constexpr size_type max_size() const noexcept {
+        constexpr auto max_bytes =
+            static_cast<size_type>(std::numeric_limits<difference_type>::max());
+        return std::min(max_bytes / (sizeof(T) + sizeof(flag)),
+                        capacity_of_(max_blocks - 1));
+    }
+
+    /*
+     * Constructors. The container is neither copyable nor movable, other threads hold
+     * references to it and to its elements
+     */
+
+    concurrent_append_vector() noexcept = default;
+
+    explicit concurrent_append_vector(const Allocator& allocator) noexcept
+        : alloc_m(allocator) {}
+
+    concurrent_append_vector(const concurrent_append_vector&) = delete;
+    concurrent_append_vector& operator=(const concurrent_append_vector&) = delete;
+
+    ~concurrent_append_vector() { release_(); }
+
+    allocator_type get_allocator() const noexcept { return alloc_m; }
+
+    /*
+     * Capacity
+     */
+
+    /**
+     * @brief Length of the published prefix, every element below it is ready to read
+     *
+     * Elements past it may be published too, behind one that is still being constructed.
+     * The value only grows while writers append.
+     */
+    size_type size() const noexcept {
+        size_type watermark = published_m.load(std::memory_order_acquire);
+        size_type end = watermark;
+        while (is_published(end)) {
+            ++end;
+        }
+
+        while (watermark < end &&
+               !published_m.compare_exchange_weak(watermark, end,
+                                                  std::memory_order_release,
+                                                  std::memory_order_acquire)) {
+        }
+        return std::max(watermark, end);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    // indices handed out to writers so far, published or not
+    size_type claimed() const noexcept {
+        return claimed_m.load(std::memory_order_relaxed);
+    }
+
+    // elements that fit in the blocks allocated from the start without a gap
+    size_type capacity() const noexcept {
+        size_type count = 0;
+        while (count < max_blocks &&
+               blocks_m[count].load(std::memory_order_acquire) != nullptr) {
+            ++count;
+        }
+        return capacity_of_(count);
+    }
+
+    /**
+     * @brief Allocates blocks until new_capacity elements fit, thread safe
+     * @throws std::length_error if new_capacity > max_size()
+     */
+    void reserve(size_type new_capacity) {
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        for (size_type k = 0; capacity_of_(k) < new_capacity; ++k) {
+            block_(k);
+        }
+    }
+
+    /*
+     * Modifiers
+     */
+
+    /**
+     * @brief Appends an element constructed from args, thread safe
+     * @return Reference to the new element, it stays valid until clear()
+     *
+     * The element is published when this returns. If constructing it may throw, it is
+     * built on the stack first and moved into its slot, so a throwing constructor
+     * claims no index.
+     */
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible_v<T, Args...>) {
+            size_type index = claimed_m.fetch_add(1, std::memory_order_relaxed);
+            if (index >= max_size()) [[unlikely]] {
+                throw std::length_error("Requested capacity exceeded max size.");
+            }
+
+            auto [block, offset] = locate_(index);
+            T* first = block_(block);
+            T* slot = first + offset;
+            alloc_traits::construct(alloc_m, slot, std::forward<Args>(args)...);
+            flags_(first, block)[offset].store(true, std::memory_order_release);
+            return *slot;
+        } else {
+            static_assert(std::is_nothrow_move_constructible_v<T>,
+                          "elements with a throwing constructor need a nothrow move");
+            T value(std::forward<Args>(args)...);
+            return emplace_back(std::move(value));
+        }
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    // destroys every element, the blocks are kept, not thread safe
+    void clear() noexcept {
+        for_each_block_([this](T* first, size_type block) {
+            flag* flags = flags_(first, block);
+            for (size_type i = 0; i < block_size(block); ++i) {
+                if (flags[i].load(std::memory_order_relaxed)) {
+                    alloc_traits::destroy(alloc_m, first + i);
+                    flags[i].store(false, std::memory_order_relaxed);
+                }
+            }
+        });
+        claimed_m.store(0, std::memory_order_relaxed);
+        published_m.store(0, std::memory_order_relaxed);
+    }
+
+    /*
+     * Element access, for published indices
+     */
+
+    // true once the element at index is constructed, its contents are then visible
+    bool is_published(size_type index) const noexcept {
+        if (index >= max_size()) {
+            return false;
+        }
+
+        auto [block, offset] = locate_(index);
+        const T* first = blocks_m[block].load(std::memory_order_acquire);
+        return first != nullptr &&
+               flags_(first, block)[offset].load(std::memory_order_acquire);
+    }
+
+    reference operator[](size_type index) noexcept { return *address_(index); }
+    const_reference operator[](size_type index) const noexcept {
+        return *address_(index);
+    }
+
+    /**
+     * @brief Bounds checked element access
+     * @throws std::out_of_range if the element at index is not published
+     */
+    reference at(size_type index) {
+        if (!is_published(index)) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return *address_(index);
+    }
+
+    const_reference at(size_type index) const {
+        if (!is_published(index)) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return *address_(index);
+    }
+
+    static constexpr size_type block_size(size_type block) noexcept {
+        return FirstBlockSize << block;
+    }
+
+    /*
+     * Iterators, over the published prefix when end() is called
+     */
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size()); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    [[no_unique_address]] Allocator alloc_m;
+    std::array<std::atomic<T*>, max_blocks> blocks_m{};
+
+    // written by every writer, and by readers moving the watermark, one line each
+    alignas(64) std::atomic<size_type> claimed_m = 0;
+    alignas(64) mutable std::atomic<size_type> published_m = 0;
+
+    using position = detail::segment_position;
+
+    static constexpr size_type capacity_of_(size_type count) noexcept {
+        return detail::segmented_capacity<FirstBlockSize>(count);
+    }
+
+    static constexpr position locate_(size_type index) noexcept {
+        return detail::segmented_locate<FirstBlockSize>(index);
+    }
+
+    // a block is allocated as T's, the flags take the slots past its elements
+    static constexpr size_type allocation_size_(size_type block) noexcept {
+        return block_size(block) + (block_size(block) * sizeof(flag) + sizeof(T) - 1) /
+                                       sizeof(T);
+    }
+
+    static flag* flags_(T* first, size_type block) noexcept {
+        return std::launder(reinterpret_cast<flag*>(first + block_size(block)));
+    }
+
+    static const flag* flags_(const T* first, size_type block) noexcept {
+        return std::launder(reinterpret_cast<const flag*>(first + block_size(block)));
+    }
+
+    T* address_(size_type index) const noexcept {
+        auto [block, offset] = locate_(index);
+        return blocks_m[block].load(std::memory_order_acquire) + offset;
+    }
+
+    // the block, allocated by this call if no thread has allocated it yet
+    T* block_(size_type block) {
+        T* first = blocks_m[block].load(std::memory_order_acquire);
+        if (first != nullptr) [[likely]] {
+            return first;
+        }
+
+        first = alloc_traits::allocate(alloc_m, allocation_size_(block));
+        flag* flags = flags_(first, block);
+        for (size_type i = 0; i < block_size(block); ++i) {
+            ::new (static_cast<void*>(flags + i)) flag(false);
+        }
+
+        T* installed = nullptr;
+        if (!blocks_m[block].compare_exchange_strong(installed, first,
+                                                     std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+            alloc_traits::deallocate(alloc_m, first, allocation_size_(block));
+            return installed;
+        }
+        return first;
+    }
+
+    // calls f(first, k) for every allocated block k
+    template <typename F> void for_each_block_(F&& f) {
+        for (size_type k = 0; k < max_blocks; ++k) {
+            T* first = blocks_m[k].load(std::memory_order_relaxed);
+            if (first != nullptr) {
+                f(first, k);
+            }
+        }
+    }
+
+    void release_() noexcept {
+        clear();
+        for_each_block_([this](T* first, size_type block) {
+            alloc_traits::deallocate(alloc_m, first, allocation_size_(block));
+            blocks_m[block].store(nullptr, std::memory_order_relaxed);
+        });
+    }
+};
+
+/*
+ * Random access iterator over indices, each dereference finds the block with a bit scan
+ */
+template <typename T, typename Allocator, std::size_t FirstBlockSize>
+template <bool Const>
+class concurrent_append_vector<T, Allocator, FirstBlockSize>::basic_iterator {
+    using owner = std::conditional_t<Const, const concurrent_append_vector,
+                                     concurrent_append_vector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    basic_iterator() noexcept = default;
+    basic_iterator(owner* vector, size_type index) noexcept
+        : vector_m(vector), index_m(index) {}
+
+    // iterator converts to const_iterator
+    operator basic_iterator<true>() const noexcept
+        requires(!Const)
+    {
+        return basic_iterator<true>(vector_m, index_m);
+    }
+
+    reference operator*() const noexcept { return (*vector_m)[index_m]; }
+    pointer operator->() const noexcept { return &(*vector_m)[index_m]; }
+    reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+    basic_iterator& operator++() noexcept {
+        ++index_m;
+        return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+        basic_iterator old = *this;
+        ++index_m;
+        return old;
+    }
+    basic_iterator& operator--() noexcept {
+        --index_m;
+        return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+        basic_iterator old = *this;
+        --index_m;
+        return old;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+        index_m = static_cast<size_type>(static_cast<difference_type>(index_m) + n);
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& a,
+                                     const basic_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_m) -
+               static_cast<difference_type>(b.index_m);
+    }
+
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m == b.index_m;
+    }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m <=> b.index_m;
+    }
+
+private:
+    owner* vector_m = nullptr;
+    size_type index_m = 0;
+};
+
+} // namespace ptorpis
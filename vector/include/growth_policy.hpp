@@ -0,0 +1,114 @@
+/**
+ * @file data-structures/vector/include/growth_policy.hpp
+ * @brief Policies that decide how much a vector grows when it runs out of capacity
+ * @author ptorpis -- Peter Torpis
+ *
+ * A growth policy is a type with a static
+ *
+ *     std::size_t next_capacity(std::size_t current, std::size_t required,
+ *                               std::size_t element_size);
+ *
+ * that returns the new capacity (in elements) for a vector holding current slots that
+ * needs room for at least required elements. The vector never asks for less than
+ * required, so a policy only has to decide how much slack to add.
+ *
+ * - doubling_growth: the classic factor of 2, fewest reallocations.
+ * - one_and_half_growth: factor 1.5, a freed block can be reused by a later growth step
+ *   because the sum of the previous blocks eventually exceeds the next request.
+ * - size_class_growth: grows like Base, then rounds the block up to the next allocator
+ *   size class (4 classes per power of two, as in jemalloc/tcmalloc) so the bytes the
+ *   allocator would waste on rounding become usable capacity.
+ * - page_growth: like size_class_growth for small blocks, whole pages from PageSize up.
+ *   The first allocation is at least MinBytes, so a vector of 24-byte elements starts at
+ *   170 elements and then grows in whole 4 KiB pages.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+
+namespace ptorpis {
+
+template <typename Policy>
+concept growth_policy = requires(std::size_t n) {
+    { Policy::next_capacity(n, n, n) } -> std::same_as<std::size_t>;
+};
+
+/**
+ * @brief Multiplies the capacity by Num / Den
+ * @tparam MinCapacity Capacity of the first allocation
+ */
+template <std::size_t Num, std::size_t Den, std::size_t MinCapacity = 1>
+struct factor_growth {
+    static_assert(Num > Den, "the growth factor has to be larger than 1");
+
+    static constexpr std::size_t next_capacity(std::size_t current, std::size_t required,
+                                               std::size_t /*element_size*/) noexcept {
+        // current * Num / Den without overflowing for large capacities
+        std::size_t grown = current / Den * Num + current % Den * Num / Den;
+        return std::max({grown, current + 1, required, MinCapacity});
+    }
+};
+
+using doubling_growth = factor_growth<2, 1>;
+using one_and_half_growth = factor_growth<3, 2>;
+
+namespace detail {
+
+inline constexpr std::size_t smallest_size_class = 16;
+
+// rounds bytes up to the next size class, classes are a quarter of a power of two apart
+constexpr std::size_t size_class_ceil(std::size_t bytes) noexcept {
+    if (bytes <= smallest_size_class) {
+        return smallest_size_class;
+    }
+
+    std::size_t step = std::max(std::bit_floor(bytes - 1) / 4, smallest_size_class);
+    return (bytes + step - 1) / step * step;
+}
+
+constexpr std::size_t round_up(std::size_t bytes, std::size_t multiple) noexcept {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+} // namespace detail
+
+/**
+ * @brief Grows like Base, then fills the allocator size class the block lands in
+ * @tparam MinBytes Size of the first allocation in bytes
+ */
+template <growth_policy Base = doubling_growth, std::size_t MinBytes = 64>
+struct size_class_growth {
+    static constexpr std::size_t next_capacity(std::size_t current, std::size_t required,
+                                               std::size_t element_size) noexcept {
+        std::size_t bytes =
+            std::max(Base::next_capacity(current, required, element_size) * element_size,
+                     MinBytes);
+        return detail::size_class_ceil(bytes) / element_size;
+    }
+};
+
+/**
+ * @brief Size classes for small blocks, whole pages for blocks of PageSize and above
+ * @tparam MinBytes Size of the first allocation in bytes, one page by default
+ */
+template <growth_policy Base = doubling_growth, std::size_t PageSize = 4096,
+          std::size_t MinBytes = PageSize>
+struct page_growth {
+    static_assert(std::has_single_bit(PageSize), "the page size has to be a power of 2");
+
+    static constexpr std::size_t next_capacity(std::size_t current, std::size_t required,
+                                               std::size_t element_size) noexcept {
+        std::size_t bytes =
+            std::max(Base::next_capacity(current, required, element_size) * element_size,
+                     MinBytes);
+        std::size_t rounded = bytes < PageSize ? detail::size_class_ceil(bytes)
+                                               : detail::round_up(bytes, PageSize);
+        return rounded / element_size;
+    }
+};
+
+} // namespace ptorpis
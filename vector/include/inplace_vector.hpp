@@ -0,0 +1,378 @@
+/**
+ * @file data-structures/vector/include/inplace_vector.hpp
+ * @brief Fixed capacity vector that stores its elements inside the object
+ * @author ptorpis -- Peter Torpis
+ *
+ * Same interface and iterator types as ptorpis::vector, but the capacity is the template
+ * parameter N and never changes, so the container never allocates. Operations that would
+ * need more than N elements throw std::bad_alloc, like std::inplace_vector; the try_
+ * variants return nullptr instead.
+ *
+ * For trivially copyable, trivially default constructible T the storage is a plain T[N]
+ * (value initialized), which makes the whole container trivially copyable and usable in
+ * constant expressions. It can then be embedded in messages sent through spsc_queue_shm.
+ * Other element types live in raw aligned storage and are constructed on demand.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "comparison.hpp"
+#include "iterators.hpp"
+
+namespace ptorpis {
+namespace detail {
+
+template <typename T>
+inline constexpr bool inplace_trivial_v =
+    std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>;
+
+// trivial element types: an array of live objects, every special member stays trivial
+template <typename T, std::size_t N, bool = inplace_trivial_v<T>> struct inplace_storage {
+    T elements_m[N]{};
+    std::size_t size_m{};
+
+    constexpr T* data() noexcept { return elements_m; }
+    constexpr const T* data() const noexcept { return elements_m; }
+};
+
+// other element types: raw storage, objects only exist in [0, size_m)
+template <typename T, std::size_t N> struct inplace_storage<T, N, false> {
+    alignas(T) std::byte bytes_m[N * sizeof(T)];
+    std::size_t size_m{};
+
+    inplace_storage() noexcept {}
+
+    inplace_storage(const inplace_storage& other) {
+        construct_from_(other.data(), other.size_m);
+    }
+
+    inplace_storage(inplace_storage&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        construct_from_(std::make_move_iterator(other.data()), other.size_m);
+    }
+
+    inplace_storage& operator=(const inplace_storage& other) {
+        if (this != &other) {
+            assign_from_(other.data(), other.size_m);
+        }
+        return *this;
+    }
+
+    inplace_storage& operator=(inplace_storage&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T>) {
+        if (this != &other) {
+            assign_from_(std::make_move_iterator(other.data()), other.size_m);
+        }
+        return *this;
+    }
+
+    ~inplace_storage() { std::destroy_n(data(), size_m); }
+
+    T* data() noexcept { return std::launder(reinterpret_cast<T*>(bytes_m)); }
+    const T* data() const noexcept {
+        return std::launder(reinterpret_cast<const T*>(bytes_m));
+    }
+
+private:
+    // the destructor does not run for a half-built object, clean up here instead
+    template <typename It> void construct_from_(It first, std::size_t count) {
+        try {
+            append_from_(first, count);
+        } catch (...) {
+            std::destroy_n(data(), size_m);
+            throw;
+        }
+    }
+
+    template <typename It> void append_from_(It first, std::size_t count) {
+        for (std::size_t i{}; i < count; ++i, ++first) {
+            std::construct_at(data() + size_m, *first);
+            ++size_m;
+        }
+    }
+
+    template <typename It> void assign_from_(It first, std::size_t count) {
+        std::size_t common = std::min(count, size_m);
+        for (std::size_t i{}; i < common; ++i, ++first) {
+            data()[i] = *first;
+        }
+
+        if (count < size_m) {
+            std::destroy(data() + count, data() + size_m);
+            size_m = count;
+        } else {
+            append_from_(first, count - common);
+        }
+    }
+};
+
+} // namespace detail
+
+/**
+ * @brief Fixed capacity dynamic array without heap allocation
+ * @tparam T The type of the elements
+ * @tparam N Maximum number of elements
+ */
+template <typename T, std::size_t N> class inplace_vector {
+    static_assert(N > 0, "inplace_vector needs room for at least one element");
+
+public:
+    using iterator = detail::vector_iterator<T>;
+    using const_iterator = detail::vector_const_iterator<T>;
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr size_type max_size() noexcept { return N; }
+    static constexpr size_type capacity() noexcept { return N; }
+
+    /*
+     * Constructors, the special members come from the storage and are trivial whenever T
+     * is trivially copyable
+     */
+
+    constexpr inplace_vector() noexcept = default;
+
+    constexpr explicit inplace_vector(size_type count) {
+        check_capacity_(count);
+        while (size() < count) {
+            unchecked_emplace_back();
+        }
+    }
+
+    constexpr inplace_vector(size_type count, const T& value) {
+        check_capacity_(count);
+        while (size() < count) {
+            unchecked_emplace_back(value);
+        }
+    }
+
+    constexpr inplace_vector(std::initializer_list<T> init) {
+        check_capacity_(init.size());
+        for (const T& value : init) {
+            unchecked_emplace_back(value);
+        }
+    }
+
+    /*
+     * Access methods
+     */
+
+    constexpr T& at(size_type pos) {
+        if (pos >= size()) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data()[pos];
+    }
+
+    constexpr const T& at(size_type pos) const {
+        if (pos >= size()) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data()[pos];
+    }
+
+    constexpr reference operator[](size_type pos) { return data()[pos]; }
+    constexpr const T& operator[](size_type pos) const { return data()[pos]; }
+
+    constexpr reference back() { return data()[size() - 1]; }
+    constexpr const T& back() const { return data()[size() - 1]; }
+
+    constexpr reference front() { return *data(); }
+    constexpr const T& front() const { return *data(); }
+
+    constexpr pointer data() noexcept { return storage_m.data(); }
+    constexpr const T* data() const noexcept { return storage_m.data(); }
+
+    constexpr size_type size() const noexcept { return storage_m.size_m; }
+
+    constexpr bool empty() const noexcept { return size() == 0; }
+
+    /*
+     * Modifiers
+     */
+
+    // only checks the bound, there is nothing to allocate
+    constexpr void reserve(size_type new_capacity) { check_capacity_(new_capacity); }
+
+    constexpr void shrink_to_fit() noexcept {}
+
+    constexpr void push_back(const T& value) { emplace_back(value); }
+
+    constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args> constexpr reference emplace_back(Args&&... args) {
+        check_capacity_(size() + 1);
+        return unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+
+    // @return nullptr instead of throwing when the vector is full
+    template <typename... Args> constexpr pointer try_emplace_back(Args&&... args) {
+        if (size() == N) {
+            return nullptr;
+        }
+        return &unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+
+    constexpr pointer try_push_back(const T& value) { return try_emplace_back(value); }
+
+    constexpr pointer try_push_back(T&& value) {
+        return try_emplace_back(std::move(value));
+    }
+
+    // precondition: size() < capacity()
+    template <typename... Args>
+    constexpr reference unchecked_emplace_back(Args&&... args) {
+        pointer slot = data() + size();
+        std::construct_at(slot, std::forward<Args>(args)...);
+        ++storage_m.size_m;
+        return *slot;
+    }
+
+    constexpr void pop_back() {
+        --storage_m.size_m;
+        std::destroy_at(data() + size());
+    }
+
+    constexpr void clear() noexcept {
+        std::destroy_n(data(), size());
+        storage_m.size_m = 0;
+    }
+
+    constexpr iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    constexpr iterator erase(const_iterator first, const_iterator last) {
+        size_type first_idx = first - begin();
+        size_type last_idx = last - begin();
+        size_type count = last_idx - first_idx;
+
+        std::move(data() + last_idx, data() + size(), data() + first_idx);
+        std::destroy(data() + size() - count, data() + size());
+        storage_m.size_m -= count;
+        return iterator(data() + first_idx);
+    }
+
+    /*
+     * Inserts append the new elements and rotate them into place, so a throwing
+     * constructor leaves the existing elements untouched
+     */
+
+    constexpr iterator insert(const_iterator pos, const T& value) {
+        return emplace_rotate_(pos - begin(), 1, [&] { unchecked_emplace_back(value); });
+    }
+
+    constexpr iterator insert(const_iterator pos, T&& value) {
+        return emplace_rotate_(pos - begin(), 1,
+                               [&] { unchecked_emplace_back(std::move(value)); });
+    }
+
+    constexpr iterator insert(const_iterator pos, size_type count, const T& value) {
+        return emplace_rotate_(pos - begin(), count,
+                               [&] { unchecked_emplace_back(value); });
+    }
+
+    template <std::input_iterator InputIt>
+    constexpr iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        size_type count = std::distance(first, last);
+        return emplace_rotate_(pos - begin(), count,
+                               [&] { unchecked_emplace_back(*first++); });
+    }
+
+    constexpr iterator insert(const_iterator pos, std::initializer_list<T> iList) {
+        return insert(pos, iList.begin(), iList.end());
+    }
+
+    constexpr bool operator==(const inplace_vector& other) const {
+        return size() == other.size() &&
+               detail::equal_elements(data(), other.data(), size());
+    }
+
+    constexpr auto operator<=>(const inplace_vector& other) const
+        requires detail::synth_comparable<T>
+    {
+        return detail::compare_elements(data(), size(), other.data(), other.size());
+    }
+
+    constexpr iterator begin() { return iterator(data()); }
+    constexpr iterator end() { return iterator(data() + size()); }
+
+    constexpr const_iterator begin() const { return cbegin(); }
+    constexpr const_iterator end() const { return cend(); }
+
+    constexpr const_iterator cbegin() const { return const_iterator(mutable_data_()); }
+    constexpr const_iterator cend() const {
+        return const_iterator(mutable_data_() + size());
+    }
+
+    constexpr reverse_iterator rbegin() { return reverse_iterator(end()); }
+    constexpr reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    constexpr const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    constexpr const_reverse_iterator crbegin() const {
+        return const_reverse_iterator(cend());
+    }
+    constexpr const_reverse_iterator crend() const {
+        return const_reverse_iterator(cbegin());
+    }
+
+private:
+    detail::inplace_storage<T, N> storage_m;
+
+    // const_iterator is constructed from T*, like in vector
+    constexpr pointer mutable_data_() const noexcept {
+        return const_cast<pointer>(data());
+    }
+
+    static constexpr void check_capacity_(size_type count) {
+        if (count > N) {
+            throw std::bad_alloc();
+        }
+    }
+
+    template <typename Emplace>
+    constexpr iterator emplace_rotate_(size_type index, size_type count,
+                                       Emplace&& emplace) {
+        check_capacity_(size() + count);
+
+        size_type old_size = size();
+        try {
+            for (size_type i{}; i < count; ++i) {
+                emplace();
+            }
+        } catch (...) {
+            while (size() > old_size) {
+                pop_back();
+            }
+            throw;
+        }
+
+        std::rotate(data() + index, data() + old_size, data() + size());
+        return iterator(data() + index);
+    }
+};
+
+} // namespace ptorpis
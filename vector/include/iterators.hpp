@@ -1,79 +1,100 @@
 #pragma once
 
 #include <compare>
+#include <concepts>
 #include <cstddef>
 #include <iterator>
+#include <ranges>
 
 namespace ptorpis {
 namespace detail {
 
+// ranges the containers can insert from, as in the C++23 insert_range/append_range
+template <typename R, typename T>
+concept container_compatible_range =
+    std::ranges::input_range<R> &&
+    std::convertible_to<std::ranges::range_reference_t<R>, T>;
+
+/*
+ * Both iterators are contiguous iterators (std::to_address goes through operator->), so
+ * std::span, std::ranges algorithms and the library's memmove fast paths accept them
+ */
 template <typename T> class vector_iterator {
 public:
     using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::contiguous_iterator_tag;
     using value_type = T;
+    using element_type = T;
     using difference_type = std::ptrdiff_t;
     using pointer = T*;
     using reference = T&;
 
-    vector_iterator() : ptr_(nullptr) {}
-    explicit vector_iterator(T* ptr) : ptr_(ptr) {}
+    constexpr vector_iterator() : ptr_(nullptr) {}
+    constexpr explicit vector_iterator(T* ptr) : ptr_(ptr) {}
 
-    reference operator*() const { return *ptr_; }
-    pointer operator->() const { return ptr_; }
+    constexpr reference operator*() const { return *ptr_; }
+    constexpr pointer operator->() const { return ptr_; }
 
-    vector_iterator& operator++() {
+    constexpr vector_iterator& operator++() {
         ++ptr_;
         return *this;
     }
 
-    vector_iterator operator++(int) {
+    constexpr vector_iterator operator++(int) {
         vector_iterator temp = *this;
         ++ptr_;
         return temp;
     }
 
-    vector_iterator operator--() {
+    constexpr vector_iterator& operator--() {
         --ptr_;
         return *this;
     }
 
-    vector_iterator operator--(int) {
+    constexpr vector_iterator operator--(int) {
         vector_iterator temp = *this;
         --ptr_;
         return temp;
     }
 
-    vector_iterator& operator+=(std::ptrdiff_t n) {
+    constexpr vector_iterator& operator+=(std::ptrdiff_t n) {
         ptr_ += n;
         return *this;
     }
 
-    vector_iterator& operator-=(std::ptrdiff_t n) {
+    constexpr vector_iterator& operator-=(std::ptrdiff_t n) {
         ptr_ -= n;
         return *this;
     }
 
-    vector_iterator operator+(std::ptrdiff_t n) const {
+    constexpr vector_iterator operator+(std::ptrdiff_t n) const {
         vector_iterator temp = *this;
         temp += n;
         return temp;
     }
 
-    vector_iterator operator-(std::ptrdiff_t n) const {
+    constexpr vector_iterator operator-(std::ptrdiff_t n) const {
         vector_iterator temp = *this;
         temp -= n;
         return temp;
     }
 
-    std::ptrdiff_t operator-(const vector_iterator& other) const {
+    constexpr std::ptrdiff_t operator-(const vector_iterator& other) const {
         return (ptr_ - other.ptr_);
     }
 
-    reference operator[](std::ptrdiff_t n) const { return ptr_[n]; }
+    friend constexpr vector_iterator operator+(std::ptrdiff_t n,
+                                               const vector_iterator& it) {
+        return it + n;
+    }
+
+    constexpr reference operator[](std::ptrdiff_t n) const { return ptr_[n]; }
 
-    bool operator==(const vector_iterator& other) const { return other.ptr_ == ptr_; }
+    constexpr bool operator==(const vector_iterator& other) const {
+        return other.ptr_ == ptr_;
+    }
 
-    std::strong_ordering operator<=>(const vector_iterator& other) const {
+    constexpr std::strong_ordering operator<=>(const vector_iterator& other) const {
         return ptr_ <=> other.ptr_;
     }
 
@@ -84,68 +105,83 @@ private:
 template <typename T> class vector_const_iterator {
 public:
     using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::contiguous_iterator_tag;
     using value_type = T;
+    using element_type = const T;
     using difference_type = std::ptrdiff_t;
     using pointer = const T*;
     using reference = const T&;
 
-    vector_const_iterator() : ptr_(nullptr) {}
-    explicit vector_const_iterator(T* pointer) : ptr_(pointer) {}
+    constexpr vector_const_iterator() : ptr_(nullptr) {}
+    // T* converts as well, so containers pass their buffer without a const_cast
+    constexpr explicit vector_const_iterator(const T* pointer) : ptr_(pointer) {}
 
-    vector_const_iterator(const vector_iterator<T>& it) : ptr_(&(*it)) {}
+    constexpr vector_const_iterator(const vector_iterator<T>& it)
+        : ptr_(it.operator->()) {}
 
-    reference operator*() const { return *ptr_; }
-    pointer operator->() const { return ptr_; }
+    constexpr reference operator*() const { return *ptr_; }
+    constexpr pointer operator->() const { return ptr_; }
 
-    vector_const_iterator& operator++() {
+    constexpr vector_const_iterator& operator++() {
         ++ptr_;
         return *this;
     }
 
-    vector_const_iterator operator++(int) {
+    constexpr vector_const_iterator operator++(int) {
         vector_const_iterator temp = *this;
         ++ptr_;
         return temp;
     }
 
-    vector_const_iterator operator--() {
+    constexpr vector_const_iterator& operator--() {
         --ptr_;
         return *this;
     }
 
-    vector_const_iterator operator--(int) {
+    constexpr vector_const_iterator operator--(int) {
         vector_const_iterator temp = *this;
         --ptr_;
         return temp;
     }
 
-    vector_const_iterator& operator+=(difference_type n) {
+    constexpr vector_const_iterator& operator+=(difference_type n) {
         ptr_ += n;
         return *this;
     }
 
-    vector_const_iterator& operator-=(difference_type n) {
+    constexpr vector_const_iterator& operator-=(difference_type n) {
         ptr_ -= n;
         return *this;
     }
 
-    vector_const_iterator operator+(difference_type n) const {
+    constexpr vector_const_iterator operator+(difference_type n) const {
         vector_const_iterator temp = *this;
         temp += n;
         return temp;
     }
 
-    vector_const_iterator operator-(difference_type n) const {
+    constexpr vector_const_iterator operator-(difference_type n) const {
         vector_const_iterator temp = *this;
         temp -= n;
         return temp;
     }
 
-    std::strong_ordering operator<=>(const vector_const_iterator& other) const {
+    constexpr difference_type operator-(const vector_const_iterator& other) const {
+        return ptr_ - other.ptr_;
+    }
+
+    friend constexpr vector_const_iterator operator+(difference_type n,
+                                                     const vector_const_iterator& it) {
+        return it + n;
+    }
+
+    constexpr reference operator[](difference_type n) const { return ptr_[n]; }
+
+    constexpr std::strong_ordering operator<=>(const vector_const_iterator& other) const {
         return ptr_ <=> other.ptr_;
     }
 
-    bool operator==(const vector_const_iterator& other) const {
+    constexpr bool operator==(const vector_const_iterator& other) const {
         return other.ptr_ == ptr_;
     }
 
@@ -153,32 +189,34 @@ private:
     pointer ptr_;
 };
 
-template <typename T>
-bool operator==(const vector_iterator<T>& lhs, const vector_const_iterator<T>& rhs) {
-    return &(*lhs) == &(*rhs);
+template <typename T> constexpr bool operator==(const vector_iterator<T>& lhs,
+                                               const vector_const_iterator<T>& rhs) {
+    return lhs.operator->() == rhs.operator->();
 }
-template <typename T>
-bool operator==(const vector_const_iterator<T>& lhs, const vector_iterator<T>& rhs) {
-    return &(*lhs) == &(*rhs);
+template <typename T> constexpr bool operator==(const vector_const_iterator<T>& lhs,
+                                               const vector_iterator<T>& rhs) {
+    return lhs.operator->() == rhs.operator->();
 }
 
-template <typename T> std::strong_ordering
+template <typename T> constexpr std::strong_ordering
 operator<=>(const vector_iterator<T>& lhs, const vector_const_iterator<T>& rhs) {
-    return &(*lhs) <=> &(*rhs);
+    return lhs.operator->() <=> rhs.operator->();
 }
-template <typename T> std::strong_ordering
+template <typename T> constexpr std::strong_ordering
 operator<=>(const vector_const_iterator<T>& lhs, const vector_iterator<T>& rhs) {
-    return &(*lhs) <=> &(*rhs);
+    return lhs.operator->() <=> rhs.operator->();
 }
 
-template <typename T> std::ptrdiff_t operator-(const vector_const_iterator<T>& lhs,
-                                               const vector_iterator<T>& rhs) {
-    return &(*lhs) - &(*rhs);
+template <typename T>
+constexpr std::ptrdiff_t operator-(const vector_const_iterator<T>& lhs,
+                                   const vector_iterator<T>& rhs) {
+    return lhs.operator->() - rhs.operator->();
 }
 
-template <typename T> std::ptrdiff_t operator-(const vector_iterator<T>& lhs,
-                                               const vector_const_iterator<T>& rhs) {
-    return &(*lhs) - &(*rhs);
+template <typename T>
+constexpr std::ptrdiff_t operator-(const vector_iterator<T>& lhs,
+                                   const vector_const_iterator<T>& rhs) {
+    return lhs.operator->() - rhs.operator->();
 }
 
 } // namespace detail
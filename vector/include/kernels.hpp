@@ -0,0 +1,741 @@
+/**
+ * @file data-structures/vector/include/kernels.hpp
+ * @brief SIMD search and reduction kernels over contiguous ranges of arithmetic types
+ * @author ptorpis -- Peter Torpis
+ *
+ * find, count, find_first_greater, mismatch, min, max and sum over any contiguous sized
+ * range (ptorpis::vector, small_vector, std::span...) of arithmetic elements:
+ *
+ *     ptorpis::vector<std::int64_t> prices = ...;
+ *     std::size_t level = ptorpis::kernels::find_first_greater(prices, limit);
+ *
+ * 4 and 8 byte signed integers, float and double have AVX2 and AVX-512 versions, the
+ * best one the CPU supports is picked at runtime (the library itself is built for the
+ * baseline x86-64 target, only these functions use the wider instructions). Other element
+ * types, other architectures and CPUs without AVX2 use plain loops.
+ *
+ * The results match the standard algorithms with two exceptions: floating point sums add
+ * the elements in a different order, so they can round differently than std::accumulate,
+ * and min/max of ranges containing NaN are unspecified. Integer sums wrap around instead
+ * of overflowing.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define PTORPIS_KERNELS_X86 1
+#else
+#define PTORPIS_KERNELS_X86 0
+#endif
+
+namespace ptorpis::kernels {
+
+/**
+ * @brief Instruction set used by a kernel, ordered from narrowest to widest
+ */
+enum class isa { scalar, avx2, avx512 };
+
+/**
+ * @brief Widest instruction set the kernels can use on this CPU
+ *
+ * Detected once, on the first call.
+ */
+inline isa detected_isa() noexcept {
+#if PTORPIS_KERNELS_X86
+    static const isa level = [] {
+        __builtin_cpu_init();
+        if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("bmi") ||
+            !__builtin_cpu_supports("popcnt")) {
+            return isa::scalar;
+        }
+        return __builtin_cpu_supports("avx512f") ? isa::avx512 : isa::avx2;
+    }();
+    return level;
+#else
+    return isa::scalar;
+#endif
+}
+
+template <typename T>
+concept kernel_element = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
+
+template <typename R>
+concept kernel_range = std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+                       kernel_element<std::ranges::range_value_t<R>>;
+
+namespace detail {
+
+enum class compare { equal, greater };
+enum class reduction { min, max, sum };
+
+// lane type of the SIMD implementation for T, void for types that only have the loops
+template <typename T> struct lane {
+    using type = void;
+};
+
+template <std::signed_integral T>
+    requires(sizeof(T) == 4)
+struct lane<T> {
+    using type = std::int32_t;
+};
+
+template <std::signed_integral T>
+    requires(sizeof(T) == 8)
+struct lane<T> {
+    using type = std::int64_t;
+};
+
+template <> struct lane<float> {
+    using type = float;
+};
+
+template <> struct lane<double> {
+    using type = double;
+};
+
+template <typename T> using lane_t = typename lane<T>::type;
+
+template <typename T>
+inline constexpr bool has_simd_v = PTORPIS_KERNELS_X86 && !std::is_void_v<lane_t<T>>;
+
+template <compare C, typename T> constexpr bool matches_(T element, T value) {
+    if constexpr (C == compare::equal) {
+        return element == value;
+    } else {
+        return element > value;
+    }
+}
+
+template <reduction R, typename T> constexpr T combine_(T a, T b) {
+    if constexpr (R == reduction::min) {
+        return b < a ? b : a;
+    } else if constexpr (R == reduction::max) {
+        return a < b ? b : a;
+    } else if constexpr (std::is_integral_v<T>) {
+        // wraps like the SIMD lanes do instead of overflowing
+        using unsigned_type = std::make_unsigned_t<T>;
+        return static_cast<T>(static_cast<unsigned_type>(a) +
+                              static_cast<unsigned_type>(b));
+    } else {
+        return a + b;
+    }
+}
+
+namespace scalar {
+
+template <compare C, typename T>
+std::size_t find_if(const T* data, std::size_t size, T value) noexcept {
+    auto match = [value](T element) { return matches_<C>(element, value); };
+    return static_cast<std::size_t>(std::find_if(data, data + size, match) - data);
+}
+
+template <typename T>
+std::size_t count(const T* data, std::size_t size, T value) noexcept {
+    return static_cast<std::size_t>(std::count(data, data + size, value));
+}
+
+template <typename T>
+std::size_t mismatch(const T* a, const T* b, std::size_t size) noexcept {
+    std::size_t i = 0;
+    while (i < size && a[i] == b[i]) {
+        ++i;
+    }
+    return i;
+}
+
+template <reduction R, typename T> T reduce(const T* data, std::size_t size, T init) {
+    for (std::size_t i = 0; i < size; ++i) {
+        init = combine_<R>(init, data[i]);
+    }
+    return init;
+}
+
+} // namespace scalar
+
+#if PTORPIS_KERNELS_X86
+
+/*
+ * The kernels are written once against an ops struct V (one per instruction set and lane
+ * type, defined below) and always inlined into the entry points of each instruction set.
+ * Only those entry points and the ops carry a target attribute, so the vector code is
+ * generated for the right target while the rest of the program stays baseline x86-64.
+ * The psABI warning is about passing vector registers to functions compiled for a
+ * narrower target, which cannot happen once everything is inlined.
+ *
+ * Each loop iteration handles four vectors, enough independent work to hide the latency
+ * of the compares and adds.
+ */
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+template <typename V, compare C, typename T>
+[[gnu::always_inline]] inline std::size_t find_if_(const T* data, std::size_t size,
+                                                   T value) {
+    constexpr std::size_t w = V::width;
+    const auto needle = V::broadcast(static_cast<lane_t<T>>(value));
+
+    std::size_t i = 0;
+    for (; i + 4 * w <= size; i += 4 * w) {
+        std::uint64_t mask = V::template mask<C>(V::load(data + i), needle) |
+                             V::template mask<C>(V::load(data + i + w), needle) << w |
+                             V::template mask<C>(V::load(data + i + 2 * w), needle)
+                                 << 2 * w |
+                             V::template mask<C>(V::load(data + i + 3 * w), needle)
+                                 << 3 * w;
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    for (; i + w <= size; i += w) {
+        std::uint64_t mask = V::template mask<C>(V::load(data + i), needle);
+        if (mask != 0) {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + scalar::find_if<C>(data + i, size - i, value);
+}
+
+template <typename V, typename T>
+[[gnu::always_inline]] inline std::size_t count_(const T* data, std::size_t size,
+                                                 T value) {
+    constexpr std::size_t w = V::width;
+    const auto needle = V::broadcast(static_cast<lane_t<T>>(value));
+    constexpr auto equal = compare::equal;
+
+    std::size_t total = 0;
+    std::size_t i = 0;
+    for (; i + 4 * w <= size; i += 4 * w) {
+        std::uint64_t mask = V::template mask<equal>(V::load(data + i), needle) |
+                             V::template mask<equal>(V::load(data + i + w), needle) << w |
+                             V::template mask<equal>(V::load(data + i + 2 * w), needle)
+                                 << 2 * w |
+                             V::template mask<equal>(V::load(data + i + 3 * w), needle)
+                                 << 3 * w;
+        total += static_cast<std::size_t>(std::popcount(mask));
+    }
+    for (; i + w <= size; i += w) {
+        total += static_cast<std::size_t>(
+            std::popcount(V::template mask<equal>(V::load(data + i), needle)));
+    }
+    return total + scalar::count(data + i, size - i, value);
+}
+
+// the lanes of a and b that are not equal (or NaN) are the zero bits of the equal mask
+template <typename V, typename T>
+[[gnu::always_inline]] inline std::size_t mismatch_(const T* a, const T* b,
+                                                    std::size_t size) {
+    constexpr std::size_t w = V::width;
+    constexpr auto equal = compare::equal;
+    constexpr std::uint64_t all_lanes = (std::uint64_t{1} << w) - 1;
+    constexpr std::uint64_t all_blocks = 4 * w == 64 ? ~std::uint64_t{0}
+                                                     : (std::uint64_t{1} << 4 * w) - 1;
+
+    std::size_t i = 0;
+    for (; i + 4 * w <= size; i += 4 * w) {
+        std::uint64_t same =
+            V::template mask<equal>(V::load(a + i), V::load(b + i)) |
+            V::template mask<equal>(V::load(a + i + w), V::load(b + i + w)) << w |
+            V::template mask<equal>(V::load(a + i + 2 * w), V::load(b + i + 2 * w))
+                << 2 * w |
+            V::template mask<equal>(V::load(a + i + 3 * w), V::load(b + i + 3 * w))
+                << 3 * w;
+        if (same != all_blocks) {
+            return i + static_cast<std::size_t>(std::countr_one(same));
+        }
+    }
+    for (; i + w <= size; i += w) {
+        std::uint64_t same = V::template mask<equal>(V::load(a + i), V::load(b + i));
+        if (same != all_lanes) {
+            return i + static_cast<std::size_t>(std::countr_one(same));
+        }
+    }
+    return i + scalar::mismatch(a + i, b + i, size - i);
+}
+
+// size must be at least 4 * V::width
+template <typename V, reduction R, typename T>
+[[gnu::always_inline]] inline T reduce_(const T* data, std::size_t size, T init) {
+    constexpr std::size_t w = V::width;
+
+    auto acc0 = V::load(data);
+    auto acc1 = V::load(data + w);
+    auto acc2 = V::load(data + 2 * w);
+    auto acc3 = V::load(data + 3 * w);
+
+    std::size_t i = 4 * w;
+    for (; i + 4 * w <= size; i += 4 * w) {
+        acc0 = V::template combine<R>(acc0, V::load(data + i));
+        acc1 = V::template combine<R>(acc1, V::load(data + i + w));
+        acc2 = V::template combine<R>(acc2, V::load(data + i + 2 * w));
+        acc3 = V::template combine<R>(acc3, V::load(data + i + 3 * w));
+    }
+    acc0 = V::template combine<R>(V::template combine<R>(acc0, acc1),
+                                  V::template combine<R>(acc2, acc3));
+
+    T lanes[w];
+    V::store(lanes, acc0);
+    return scalar::reduce<R>(data + i, size - i, scalar::reduce<R>(lanes, w, init));
+}
+
+#pragma GCC diagnostic pop
+
+#pragma GCC push_options
+#pragma GCC target("avx2,bmi,popcnt")
+
+namespace avx2 {
+
+template <typename L> struct ops;
+
+template <> struct ops<std::int32_t> {
+    static constexpr std::size_t width = 8;
+
+    static __m256i load(const void* p) {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    }
+    static void store(void* p, __m256i v) {
+        _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+    }
+    static __m256i broadcast(std::int32_t value) { return _mm256_set1_epi32(value); }
+
+    template <compare C> static std::uint64_t mask(__m256i a, __m256i b) {
+        __m256i hits =
+            C == compare::equal ? _mm256_cmpeq_epi32(a, b) : _mm256_cmpgt_epi32(a, b);
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(hits)));
+    }
+
+    template <reduction R> static __m256i combine(__m256i a, __m256i b) {
+        if constexpr (R == reduction::min) {
+            return _mm256_min_epi32(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm256_max_epi32(a, b);
+        } else {
+            return _mm256_add_epi32(a, b);
+        }
+    }
+};
+
+template <> struct ops<std::int64_t> {
+    static constexpr std::size_t width = 4;
+
+    static __m256i load(const void* p) {
+        return _mm256_loadu_si256(static_cast<const __m256i*>(p));
+    }
+    static void store(void* p, __m256i v) {
+        _mm256_storeu_si256(static_cast<__m256i*>(p), v);
+    }
+    static __m256i broadcast(std::int64_t value) { return _mm256_set1_epi64x(value); }
+
+    template <compare C> static std::uint64_t mask(__m256i a, __m256i b) {
+        __m256i hits =
+            C == compare::equal ? _mm256_cmpeq_epi64(a, b) : _mm256_cmpgt_epi64(a, b);
+        return static_cast<std::uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(hits)));
+    }
+
+    // AVX2 has no 64-bit min/max, select with a compare instead
+    template <reduction R> static __m256i combine(__m256i a, __m256i b) {
+        if constexpr (R == reduction::min) {
+            return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+        } else if constexpr (R == reduction::max) {
+            return _mm256_blendv_epi8(b, a, _mm256_cmpgt_epi64(a, b));
+        } else {
+            return _mm256_add_epi64(a, b);
+        }
+    }
+};
+
+template <> struct ops<float> {
+    static constexpr std::size_t width = 8;
+
+    static __m256 load(const void* p) {
+        return _mm256_loadu_ps(static_cast<const float*>(p));
+    }
+    static void store(void* p, __m256 v) { _mm256_storeu_ps(static_cast<float*>(p), v); }
+    static __m256 broadcast(float value) { return _mm256_set1_ps(value); }
+
+    template <compare C> static std::uint64_t mask(__m256 a, __m256 b) {
+        __m256 hits = C == compare::equal ? _mm256_cmp_ps(a, b, _CMP_EQ_OQ)
+                                          : _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+        return static_cast<std::uint32_t>(_mm256_movemask_ps(hits));
+    }
+
+    template <reduction R> static __m256 combine(__m256 a, __m256 b) {
+        if constexpr (R == reduction::min) {
+            return _mm256_min_ps(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm256_max_ps(a, b);
+        } else {
+            return _mm256_add_ps(a, b);
+        }
+    }
+};
+
+template <> struct ops<double> {
+    static constexpr std::size_t width = 4;
+
+    static __m256d load(const void* p) {
+        return _mm256_loadu_pd(static_cast<const double*>(p));
+    }
+    static void store(void* p, __m256d v) {
+        _mm256_storeu_pd(static_cast<double*>(p), v);
+    }
+    static __m256d broadcast(double value) { return _mm256_set1_pd(value); }
+
+    template <compare C> static std::uint64_t mask(__m256d a, __m256d b) {
+        __m256d hits = C == compare::equal ? _mm256_cmp_pd(a, b, _CMP_EQ_OQ)
+                                           : _mm256_cmp_pd(a, b, _CMP_GT_OQ);
+        return static_cast<std::uint32_t>(_mm256_movemask_pd(hits));
+    }
+
+    template <reduction R> static __m256d combine(__m256d a, __m256d b) {
+        if constexpr (R == reduction::min) {
+            return _mm256_min_pd(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm256_max_pd(a, b);
+        } else {
+            return _mm256_add_pd(a, b);
+        }
+    }
+};
+
+template <compare C, typename T>
+std::size_t find_if(const T* data, std::size_t size, T value) noexcept {
+    return find_if_<ops<lane_t<T>>, C>(data, size, value);
+}
+
+template <typename T>
+std::size_t count(const T* data, std::size_t size, T value) noexcept {
+    return count_<ops<lane_t<T>>>(data, size, value);
+}
+
+template <typename T>
+std::size_t mismatch(const T* a, const T* b, std::size_t size) noexcept {
+    return mismatch_<ops<lane_t<T>>>(a, b, size);
+}
+
+template <reduction R, typename T> T reduce(const T* data, std::size_t size, T init) {
+    if (size < 4 * ops<lane_t<T>>::width) {
+        return scalar::reduce<R>(data, size, init);
+    }
+    return reduce_<ops<lane_t<T>>, R>(data, size, init);
+}
+
+} // namespace avx2
+
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,bmi,popcnt")
+// GCC 12's AVX-512 intrinsics pass a self-initialized "undefined" vector as the unused
+// merge operand, which -Wmaybe-uninitialized reports once they are inlined
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+
+namespace avx512 {
+
+template <typename L> struct ops;
+
+template <> struct ops<std::int32_t> {
+    static constexpr std::size_t width = 16;
+
+    static __m512i load(const void* p) { return _mm512_loadu_si512(p); }
+    static void store(void* p, __m512i v) { _mm512_storeu_si512(p, v); }
+    static __m512i broadcast(std::int32_t value) { return _mm512_set1_epi32(value); }
+
+    template <compare C> static std::uint64_t mask(__m512i a, __m512i b) {
+        return C == compare::equal ? _mm512_cmpeq_epi32_mask(a, b)
+                                   : _mm512_cmpgt_epi32_mask(a, b);
+    }
+
+    template <reduction R> static __m512i combine(__m512i a, __m512i b) {
+        if constexpr (R == reduction::min) {
+            return _mm512_min_epi32(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm512_max_epi32(a, b);
+        } else {
+            return _mm512_add_epi32(a, b);
+        }
+    }
+};
+
+template <> struct ops<std::int64_t> {
+    static constexpr std::size_t width = 8;
+
+    static __m512i load(const void* p) { return _mm512_loadu_si512(p); }
+    static void store(void* p, __m512i v) { _mm512_storeu_si512(p, v); }
+    static __m512i broadcast(std::int64_t value) { return _mm512_set1_epi64(value); }
+
+    template <compare C> static std::uint64_t mask(__m512i a, __m512i b) {
+        return C == compare::equal ? _mm512_cmpeq_epi64_mask(a, b)
+                                   : _mm512_cmpgt_epi64_mask(a, b);
+    }
+
+    template <reduction R> static __m512i combine(__m512i a, __m512i b) {
+        if constexpr (R == reduction::min) {
+            return _mm512_min_epi64(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm512_max_epi64(a, b);
+        } else {
+            return _mm512_add_epi64(a, b);
+        }
+    }
+};
+
+template <> struct ops<float> {
+    static constexpr std::size_t width = 16;
+
+    static __m512 load(const void* p) { return _mm512_loadu_ps(p); }
+    static void store(void* p, __m512 v) { _mm512_storeu_ps(p, v); }
+    static __m512 broadcast(float value) { return _mm512_set1_ps(value); }
+
+    template <compare C> static std::uint64_t mask(__m512 a, __m512 b) {
+        return C == compare::equal ? _mm512_cmp_ps_mask(a, b, _CMP_EQ_OQ)
+                                   : _mm512_cmp_ps_mask(a, b, _CMP_GT_OQ);
+    }
+
+    template <reduction R> static __m512 combine(__m512 a, __m512 b) {
+        if constexpr (R == reduction::min) {
+            return _mm512_min_ps(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm512_max_ps(a, b);
+        } else {
+            return _mm512_add_ps(a, b);
+        }
+    }
+};
+
+template <> struct ops<double> {
+    static constexpr std::size_t width = 8;
+
+    static __m512d load(const void* p) { return _mm512_loadu_pd(p); }
+    static void store(void* p, __m512d v) { _mm512_storeu_pd(p, v); }
+    static __m512d broadcast(double value) { return _mm512_set1_pd(value); }
+
+    template <compare C> static std::uint64_t mask(__m512d a, __m512d b) {
+        return C == compare::equal ? _mm512_cmp_pd_mask(a, b, _CMP_EQ_OQ)
+                                   : _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ);
+    }
+
+    template <reduction R> static __m512d combine(__m512d a, __m512d b) {
+        if constexpr (R == reduction::min) {
+            return _mm512_min_pd(a, b);
+        } else if constexpr (R == reduction::max) {
+            return _mm512_max_pd(a, b);
+        } else {
+            return _mm512_add_pd(a, b);
+        }
+    }
+};
+
+template <compare C, typename T>
+std::size_t find_if(const T* data, std::size_t size, T value) noexcept {
+    return find_if_<ops<lane_t<T>>, C>(data, size, value);
+}
+
+template <typename T>
+std::size_t count(const T* data, std::size_t size, T value) noexcept {
+    return count_<ops<lane_t<T>>>(data, size, value);
+}
+
+template <typename T>
+std::size_t mismatch(const T* a, const T* b, std::size_t size) noexcept {
+    return mismatch_<ops<lane_t<T>>>(a, b, size);
+}
+
+template <reduction R, typename T> T reduce(const T* data, std::size_t size, T init) {
+    if (size < 4 * ops<lane_t<T>>::width) {
+        return scalar::reduce<R>(data, size, init);
+    }
+    return reduce_<ops<lane_t<T>>, R>(data, size, init);
+}
+
+} // namespace avx512
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+#endif // PTORPIS_KERNELS_X86
+
+// never runs wider code than the CPU supports, whatever level was asked for
+inline isa clamp_(isa level) noexcept { return std::min(level, detected_isa()); }
+
+template <compare C, typename T>
+std::size_t find_if(const T* data, std::size_t size, T value, isa level) noexcept {
+#if PTORPIS_KERNELS_X86
+    if constexpr (has_simd_v<T>) {
+        switch (clamp_(level)) {
+        case isa::avx512:
+            return avx512::find_if<C>(data, size, value);
+        case isa::avx2:
+            return avx2::find_if<C>(data, size, value);
+        case isa::scalar:
+            break;
+        }
+    }
+#endif
+    (void)level;
+    return scalar::find_if<C>(data, size, value);
+}
+
+template <typename T>
+std::size_t count(const T* data, std::size_t size, T value, isa level) noexcept {
+#if PTORPIS_KERNELS_X86
+    if constexpr (has_simd_v<T>) {
+        switch (clamp_(level)) {
+        case isa::avx512:
+            return avx512::count(data, size, value);
+        case isa::avx2:
+            return avx2::count(data, size, value);
+        case isa::scalar:
+            break;
+        }
+    }
+#endif
+    (void)level;
+    return scalar::count(data, size, value);
+}
+
+template <typename T>
+std::size_t mismatch(const T* a, const T* b, std::size_t size, isa level) noexcept {
+#if PTORPIS_KERNELS_X86
+    if constexpr (has_simd_v<T>) {
+        switch (clamp_(level)) {
+        case isa::avx512:
+            return avx512::mismatch(a, b, size);
+        case isa::avx2:
+            return avx2::mismatch(a, b, size);
+        case isa::scalar:
+            break;
+        }
+    }
+#endif
+    (void)level;
+    return scalar::mismatch(a, b, size);
+}
+
+template <reduction R, typename T>
+T reduce(const T* data, std::size_t size, T init, isa level) noexcept {
+#if PTORPIS_KERNELS_X86
+    if constexpr (has_simd_v<T>) {
+        switch (clamp_(level)) {
+        case isa::avx512:
+            return avx512::reduce<R>(data, size, init);
+        case isa::avx2:
+            return avx2::reduce<R>(data, size, init);
+        case isa::scalar:
+            break;
+        }
+    }
+#endif
+    (void)level;
+    return scalar::reduce<R>(data, size, init);
+}
+
+template <reduction R, typename T>
+T extremum(const T* data, std::size_t size, isa level, const char* name) {
+    if (size == 0) {
+        throw std::out_of_range(name);
+    }
+    return reduce<R>(data + 1, size - 1, data[0], level);
+}
+
+} // namespace detail
+
+/**
+ * @brief Index of the first element equal to value
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ * @return The index, or size() if no element is equal
+ */
+template <kernel_range R>
+std::size_t find(const R& range, std::ranges::range_value_t<R> value,
+                 isa level = detected_isa()) noexcept {
+    return detail::find_if<detail::compare::equal>(
+        std::ranges::data(range), std::ranges::size(range), value, level);
+}
+
+/**
+ * @brief Index of the first element greater than value
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ * @return The index, or size() if no element is greater
+ */
+template <kernel_range R>
+std::size_t find_first_greater(const R& range, std::ranges::range_value_t<R> value,
+                               isa level = detected_isa()) noexcept {
+    return detail::find_if<detail::compare::greater>(
+        std::ranges::data(range), std::ranges::size(range), value, level);
+}
+
+/**
+ * @brief Number of elements equal to value
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ */
+template <kernel_range R>
+std::size_t count(const R& range, std::ranges::range_value_t<R> value,
+                  isa level = detected_isa()) noexcept {
+    return detail::count(std::ranges::data(range), std::ranges::size(range), value,
+                         level);
+}
+
+/**
+ * @brief Index of the first position where the ranges hold different elements
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ * @return The index, or the smaller size if one range is a prefix of the other
+ *
+ * Elements are different when !(a == b), so NaN never matches, not even itself.
+ */
+template <kernel_range R1, kernel_range R2>
+    requires std::same_as<std::ranges::range_value_t<R1>, std::ranges::range_value_t<R2>>
+std::size_t mismatch(const R1& a, const R2& b, isa level = detected_isa()) noexcept {
+    std::size_t size = std::min<std::size_t>(std::ranges::size(a), std::ranges::size(b));
+    return detail::mismatch(std::ranges::data(a), std::ranges::data(b), size, level);
+}
+
+/**
+ * @brief Smallest element
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ * @throws std::out_of_range if the range is empty
+ */
+template <kernel_range R>
+std::ranges::range_value_t<R> min(const R& range, isa level = detected_isa()) {
+    return detail::extremum<detail::reduction::min>(
+        std::ranges::data(range), std::ranges::size(range), level,
+        "min of an empty range");
+}
+
+/**
+ * @brief Largest element
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ * @throws std::out_of_range if the range is empty
+ */
+template <kernel_range R>
+std::ranges::range_value_t<R> max(const R& range, isa level = detected_isa()) {
+    return detail::extremum<detail::reduction::max>(
+        std::ranges::data(range), std::ranges::size(range), level,
+        "max of an empty range");
+}
+
+/**
+ * @brief Sum of the elements, 0 for an empty range
+ * @param level Widest instruction set to use, clamped to detected_isa()
+ *
+ * Integer sums wrap around on overflow. Floating point sums are computed in several
+ * partial sums and can differ from std::accumulate in the last bits.
+ */
+template <kernel_range R>
+std::ranges::range_value_t<R> sum(const R& range, isa level = detected_isa()) noexcept {
+    using T = std::ranges::range_value_t<R>;
+    return detail::reduce<detail::reduction::sum>(std::ranges::data(range),
+                                                  std::ranges::size(range), T{}, level);
+}
+
+} // namespace ptorpis::kernels
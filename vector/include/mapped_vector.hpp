@@ -0,0 +1,506 @@
+/**
+ * @file data-structures/vector/include/mapped_vector.hpp
+ * @brief Vector of trivially copyable elements that lives in a memory-mapped file
+ * @author ptorpis -- Peter Torpis
+ *
+ * mapped_vector<T> keeps its elements in a file mapped with MAP_SHARED, the file is the
+ * storage. Opening an existing file maps it and checks its header, nothing is read or
+ * copied, so a restart costs the same for a few bytes or many GiB of data: the kernel
+ * pages the elements in from the page cache or the disk as they are touched.
+ *
+ *     ptorpis::mapped_vector<instrument> table("instruments.vec");
+ *     if (table.empty()) {
+ *         load_from_source(table); // only on the first run
+ *     }
+ *
+ * File layout: a 64-byte header (magic, version, sizeof(T), alignof(T), size), then the
+ * elements. The file always spans whole pages and every byte after the header is
+ * capacity. Growing allocates the new part of the file with posix_fallocate and extends
+ * the mapping with mremap, so the elements are never copied, but their addresses may
+ * change like in a vector.
+ *
+ * Writes reach the page cache right away, so they survive the process crashing. sync()
+ * waits until they are on the disk, which is needed to survive the machine crashing.
+ *
+ * The file is only meaningful to the same T on the same architecture: T must be trivially
+ * copyable and should not hold pointers, which would not be valid in the next run.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "growth_policy.hpp"
+#include "iterators.hpp"
+
+namespace ptorpis {
+
+/**
+ * @brief How mapped_vector opens its file
+ *
+ * open_or_create: opens the file if it exists, otherwise creates an empty one.
+ * create: always starts empty, truncating an existing file.
+ * open: the file has to exist.
+ */
+enum class mapped_mode { open_or_create, create, open };
+
+namespace detail {
+
+struct mapped_vector_header {
+    static constexpr std::uint64_t MAGIC = 0x43455650414d5450; // "PTMAPVEC"
+    static constexpr std::uint32_t VERSION = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t element_size;
+    std::uint32_t element_align;
+    std::uint32_t reserved;
+    std::uint64_t size; // elements in use, the rest of the file is capacity
+};
+
+inline constexpr std::size_t mapped_vector_header_size = 64;
+static_assert(sizeof(mapped_vector_header) <= mapped_vector_header_size);
+
+[[noreturn]] inline void mapped_vector_throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline std::size_t mapped_vector_page_size() noexcept {
+    static const auto page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    return page;
+}
+
+} // namespace detail
+
+/**
+ * @brief Dynamic array persisted in a memory-mapped file
+ * @tparam T The type of the elements, trivially copyable
+ */
+template <typename T> class mapped_vector {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "mapped_vector elements are stored as raw bytes in a file");
+    static_assert(alignof(T) <= detail::mapped_vector_header_size,
+                  "the elements start 64 bytes into a page aligned mapping");
+
+    using header_type = detail::mapped_vector_header;
+
+public:
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using iterator = detail::vector_iterator<T>;
+    using const_iterator = detail::vector_const_iterator<T>;
+
+    /*
+     * Constructors
+     */
+
+    // not backed by a file: is_open() is false and the container stays empty, nothing
+    // may be added until a mapped_vector is moved in
+    mapped_vector() noexcept = default;
+
+    /**
+     * @brief Maps the file at path, creating it if mode allows
+     *
+     * Opening an existing file costs the same whatever its size, the elements are paged
+     * in when they are first accessed.
+     *
+     * @throws std::system_error if the file cannot be opened, created or mapped
+     * @throws std::runtime_error if the file is not a mapped_vector of this T
+     */
+    explicit mapped_vector(const std::filesystem::path& path,
+                           mapped_mode mode = mapped_mode::open_or_create) {
+        int flags = O_RDWR;
+        if (mode == mapped_mode::open_or_create) {
+            flags |= O_CREAT;
+        } else if (mode == mapped_mode::create) {
+            flags |= O_CREAT | O_TRUNC;
+        }
+
+        fd_m = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+        if (fd_m == -1) {
+            detail::mapped_vector_throw_errno("mapped_vector: open");
+        }
+
+        try {
+            struct stat st;
+            if (::fstat(fd_m, &st) == -1) {
+                detail::mapped_vector_throw_errno("mapped_vector: fstat");
+            }
+
+            if (st.st_size == 0) {
+                create_();
+            } else {
+                open_(static_cast<std::size_t>(st.st_size), path);
+            }
+        } catch (...) {
+            close_();
+            throw;
+        }
+    }
+
+    mapped_vector(const mapped_vector&) = delete;
+    mapped_vector& operator=(const mapped_vector&) = delete;
+
+    mapped_vector(mapped_vector&& other) noexcept
+        : fd_m(std::exchange(other.fd_m, -1)), map_m(std::exchange(other.map_m, nullptr)),
+          map_size_m(std::exchange(other.map_size_m, 0)),
+          capacity_m(std::exchange(other.capacity_m, 0)) {}
+
+    mapped_vector& operator=(mapped_vector&& other) noexcept {
+        if (this != &other) {
+            close_();
+            fd_m = std::exchange(other.fd_m, -1);
+            map_m = std::exchange(other.map_m, nullptr);
+            map_size_m = std::exchange(other.map_size_m, 0);
+            capacity_m = std::exchange(other.capacity_m, 0);
+        }
+        return *this;
+    }
+
+    // unmaps the file, the data stays in the page cache and is written back by the kernel
+    ~mapped_vector() { close_(); }
+
+    void swap(mapped_vector& other) noexcept {
+        std::swap(fd_m, other.fd_m);
+        std::swap(map_m, other.map_m);
+        std::swap(map_size_m, other.map_size_m);
+        std::swap(capacity_m, other.capacity_m);
+    }
+
+    bool is_open() const noexcept { return map_m != nullptr; }
+
+    /*
+     * Capacity
+     */
+
+    size_type size() const noexcept { return map_m ? header_()->size : 0; }
+    size_type capacity() const noexcept { return capacity_m; }
+    bool empty() const noexcept { return size() == 0; }
+
+    constexpr size_type max_size() const noexcept {
+        return (static_cast<size_type>(std::numeric_limits<off_t>::max()) -
+                detail::mapped_vector_header_size) /
+               sizeof(T);
+    }
+
+    /**
+     * @brief Grows the file so new_capacity elements fit
+     * @throws std::length_error if new_capacity > max_size()
+     * @throws std::system_error if the file cannot be grown, nothing changes then
+     */
+    void reserve(size_type new_capacity) {
+        if (new_capacity <= capacity_m) {
+            return;
+        }
+
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        remap_(new_capacity);
+    }
+
+    // truncates the file to the pages the elements need
+    void shrink_to_fit() {
+        if (map_bytes_(size()) < map_size_m) {
+            remap_(size());
+        }
+    }
+
+    /*
+     * Modifiers
+     */
+
+    /**
+     * @brief Appends an element
+     *
+     * Growing may move the mapping, so the element is built before the file grows and
+     * args may refer to elements of *this.
+     */
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        size_type count = size();
+        if (count == capacity_m) [[unlikely]] {
+            T value(std::forward<Args>(args)...);
+            grow_(count + 1);
+            std::memcpy(static_cast<void*>(data() + count), &value, sizeof(T));
+        } else {
+            std::construct_at(data() + count, std::forward<Args>(args)...);
+        }
+
+        header_()->size = count + 1;
+        return data()[count];
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+
+    /**
+     * @brief Appends count elements copied from first with one memcpy
+     */
+    void append(const T* first, size_type count) {
+        size_type old_size = size();
+        if (count > capacity_m - old_size) {
+            if (count > max_size() - old_size) {
+                throw std::length_error("Requested capacity exceeded max size.");
+            }
+            // first may point into the mapping, which moves when it grows
+            const T* old_data = data();
+            bool aliases = first >= old_data && first < old_data + old_size;
+            size_type offset = aliases ? static_cast<size_type>(first - old_data) : 0;
+            grow_(old_size + count);
+            if (aliases) {
+                first = data() + offset;
+            }
+        }
+
+        if (count != 0) {
+            std::memcpy(static_cast<void*>(data() + old_size), first, count * sizeof(T));
+        }
+        header_()->size = old_size + count;
+    }
+
+    void pop_back() noexcept { --header_()->size; }
+
+    // keeps the file size, shrink_to_fit() truncates it
+    void clear() noexcept {
+        if (map_m) {
+            header_()->size = 0;
+        }
+    }
+
+    /**
+     * @brief New elements are value-initialized (zero bytes from the file for most T)
+     * @throws std::system_error if count > size() and no file is open
+     */
+    void resize(size_type count) {
+        size_type old_size = size();
+        if (count > old_size) {
+            reserve(count);
+            std::uninitialized_value_construct(data() + old_size, data() + count);
+        }
+        if (map_m) {
+            header_()->size = count;
+        }
+    }
+
+    /**
+     * @brief Waits until the elements and the size are written to the disk
+     * @throws std::system_error if msync fails
+     */
+    void sync() const {
+        if (map_m && ::msync(map_m, map_size_m, MS_SYNC) == -1) {
+            detail::mapped_vector_throw_errno("mapped_vector: msync");
+        }
+    }
+
+    /*
+     * Element access
+     */
+
+    T* data() noexcept {
+        if (!map_m) {
+            return nullptr;
+        }
+        return reinterpret_cast<T*>(static_cast<std::byte*>(map_m) +
+                                    detail::mapped_vector_header_size);
+    }
+
+    const T* data() const noexcept { return const_cast<mapped_vector*>(this)->data(); }
+
+    reference operator[](size_type index) noexcept { return data()[index]; }
+    const_reference operator[](size_type index) const noexcept { return data()[index]; }
+
+    /**
+     * @brief Bounds checked element access
+     * @throws std::out_of_range if index >= size()
+     */
+    reference at(size_type index) {
+        if (index >= size()) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data()[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= size()) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data()[index];
+    }
+
+    reference front() noexcept { return data()[0]; }
+    const_reference front() const noexcept { return data()[0]; }
+    reference back() noexcept { return data()[size() - 1]; }
+    const_reference back() const noexcept { return data()[size() - 1]; }
+
+    /*
+     * Iterators
+     */
+
+    iterator begin() noexcept { return iterator(data()); }
+    iterator end() noexcept { return iterator(data() + size()); }
+    const_iterator begin() const noexcept { return const_iterator(data()); }
+    const_iterator end() const noexcept { return const_iterator(data() + size()); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    int fd_m = -1;
+    void* map_m = nullptr;
+    size_type map_size_m = 0;
+    size_type capacity_m = 0;
+
+    header_type* header_() const noexcept { return static_cast<header_type*>(map_m); }
+
+    // whole pages holding the header and capacity elements
+    static size_type map_bytes_(size_type capacity) noexcept {
+        size_type page = detail::mapped_vector_page_size();
+        size_type bytes = detail::mapped_vector_header_size + capacity * sizeof(T);
+        return (bytes + page - 1) / page * page;
+    }
+
+    static size_type capacity_of_(size_type map_bytes) noexcept {
+        return (map_bytes - detail::mapped_vector_header_size) / sizeof(T);
+    }
+
+    void map_(size_type bytes) {
+        void* map = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_m, 0);
+        if (map == MAP_FAILED) {
+            detail::mapped_vector_throw_errno("mapped_vector: mmap");
+        }
+        map_m = map;
+        map_size_m = bytes;
+        capacity_m = capacity_of_(bytes);
+    }
+
+    void create_() {
+        size_type bytes = map_bytes_(0);
+        int error = ::posix_fallocate(fd_m, 0, static_cast<off_t>(bytes));
+        if (error != 0) {
+            throw std::system_error(error, std::generic_category(),
+                                    "mapped_vector: posix_fallocate");
+        }
+        map_(bytes);
+
+        // the new file is zero-filled, size starts at 0
+        auto* header = header_();
+        header->magic = header_type::MAGIC;
+        header->version = header_type::VERSION;
+        header->element_size = sizeof(T);
+        header->element_align = alignof(T);
+    }
+
+    void open_(size_type file_bytes, const std::filesystem::path& path) {
+        if (file_bytes < detail::mapped_vector_header_size) {
+            throw std::runtime_error("mapped_vector: truncated file " + path.string());
+        }
+        map_(file_bytes);
+
+        const auto* header = header_();
+        if (header->magic != header_type::MAGIC ||
+            header->version != header_type::VERSION) {
+            throw std::runtime_error("mapped_vector: bad header in " + path.string());
+        }
+        if (header->element_size != sizeof(T) || header->element_align != alignof(T)) {
+            throw std::runtime_error("mapped_vector: element type mismatch in " +
+                                     path.string());
+        }
+        if (header->size > capacity_m) {
+            throw std::runtime_error("mapped_vector: truncated file " + path.string());
+        }
+    }
+
+    void grow_(size_type required) {
+        if (required > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+        size_type new_capacity =
+            doubling_growth::next_capacity(capacity_m, required, sizeof(T));
+        remap_(std::clamp(new_capacity, required, max_size()));
+    }
+
+    /*
+     * Resizes the file and the mapping to hold new_capacity elements. The file is grown
+     * before the mapping and shrunk after it, so the mapping never covers bytes past the
+     * end of the file. The new part is allocated with posix_fallocate rather than left
+     * as a sparse hole by ftruncate: a write into a hole on a full disk raises SIGBUS,
+     * a failed allocation here throws std::system_error (ENOSPC) instead.
+     */
+    void remap_(size_type new_capacity) {
+        if (map_m == nullptr) {
+            throw std::system_error(EBADF, std::generic_category(),
+                                    "mapped_vector: no file is open");
+        }
+
+        size_type new_bytes = map_bytes_(new_capacity);
+        bool growing = new_bytes > map_size_m;
+
+        if (growing) {
+            int error = ::posix_fallocate(fd_m, static_cast<off_t>(map_size_m),
+                                          static_cast<off_t>(new_bytes - map_size_m));
+            if (error != 0) {
+                throw std::system_error(error, std::generic_category(),
+                                        "mapped_vector: posix_fallocate");
+            }
+        }
+
+        void* map = ::mremap(map_m, map_size_m, new_bytes, MREMAP_MAYMOVE);
+        if (map == MAP_FAILED) {
+            int error = errno;
+            if (growing) {
+                [[maybe_unused]] int ignored =
+                    ::ftruncate(fd_m, static_cast<off_t>(map_size_m));
+            }
+            throw std::system_error(error, std::generic_category(),
+                                    "mapped_vector: mremap");
+        }
+
+        if (!growing) {
+            // if this fails the file keeps its unused tail, which is still valid capacity
+            [[maybe_unused]] int ignored =
+                ::ftruncate(fd_m, static_cast<off_t>(new_bytes));
+        }
+
+        map_m = map;
+        map_size_m = new_bytes;
+        capacity_m = capacity_of_(new_bytes);
+    }
+
+    void close_() noexcept {
+        if (map_m) {
+            ::munmap(map_m, map_size_m);
+            map_m = nullptr;
+            map_size_m = 0;
+            capacity_m = 0;
+        }
+        if (fd_m != -1) {
+            ::close(fd_m);
+            fd_m = -1;
+        }
+    }
+};
+
+} // namespace ptorpis
@@ -0,0 +1,122 @@
+/**
+ * @file data-structures/vector/include/mmap_allocator.hpp
+ * @brief Allocator that grows large blocks in place with mremap
+ * @author ptorpis -- Peter Torpis
+ *
+ * Growing a vector normally means allocating a new block, copying every element and only
+ * then freeing the old block, so for a short time both blocks are resident. Blocks of at
+ * least MmapThreshold bytes are instead mapped directly with mmap, and reallocate() hands
+ * them to mremap, which grows the mapping in place when the address space after it is
+ * free and otherwise moves the page table entries, never the data itself.
+ *
+ * vector uses reallocate() automatically when the element type is trivially relocatable
+ * (see relocation.hpp), since only then may the elements change address without running
+ * their move constructors.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ptorpis {
+
+template <typename T, std::size_t MmapThreshold = 128 * 1024> class mmap_allocator {
+public:
+    using value_type = T;
+    using size_type = std::size_t;
+
+    template <typename U> struct rebind {
+        using other = mmap_allocator<U, MmapThreshold>;
+    };
+
+    mmap_allocator() noexcept = default;
+
+    template <typename U>
+    mmap_allocator(const mmap_allocator<U, MmapThreshold>&) noexcept {}
+
+    T* allocate(size_type n) {
+        size_type bytes = n * sizeof(T);
+        if (!is_mapped_(bytes)) {
+            return static_cast<T*>(::operator new(bytes, std::align_val_t{alignof(T)}));
+        }
+
+        void* ptr = ::mmap(nullptr, round_to_pages_(bytes), PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(ptr);
+    }
+
+    void deallocate(T* ptr, size_type n) noexcept {
+        size_type bytes = n * sizeof(T);
+        if (!is_mapped_(bytes)) {
+            ::operator delete(ptr, std::align_val_t{alignof(T)});
+            return;
+        }
+        ::munmap(ptr, round_to_pages_(bytes));
+    }
+
+    /**
+     * @brief Resizes a block from old_n to new_n elements, keeping the first
+     * min(old_n, new_n) elements' bytes
+     *
+     * Mapped blocks are resized with mremap, the contents never get copied. Crossing the
+     * threshold in either direction falls back to allocate + memcpy + deallocate.
+     *
+     * @throws std::bad_alloc if the new block cannot be allocated, ptr stays valid
+     */
+    T* reallocate(T* ptr, size_type old_n, size_type new_n) {
+        size_type old_bytes = old_n * sizeof(T);
+        size_type new_bytes = new_n * sizeof(T);
+
+        if (is_mapped_(old_bytes) && is_mapped_(new_bytes)) {
+            void* moved = ::mremap(ptr, round_to_pages_(old_bytes),
+                                   round_to_pages_(new_bytes), MREMAP_MAYMOVE);
+            if (moved == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(moved);
+        }
+
+        T* fresh = allocate(new_n);
+        std::memcpy(static_cast<void*>(fresh), static_cast<const void*>(ptr),
+                    old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(ptr, old_n);
+        return fresh;
+    }
+
+    /**
+     * @brief Grows a mapped block without moving it
+     * @return false if the block is not mapped or the pages after it are taken
+     */
+    bool try_expand(T* ptr, size_type old_n, size_type new_n) noexcept {
+        size_type old_bytes = old_n * sizeof(T);
+        size_type new_bytes = new_n * sizeof(T);
+        if (!is_mapped_(old_bytes) || !is_mapped_(new_bytes)) {
+            return false;
+        }
+        return ::mremap(ptr, round_to_pages_(old_bytes), round_to_pages_(new_bytes), 0) !=
+               MAP_FAILED;
+    }
+
+    template <typename U>
+    bool operator==(const mmap_allocator<U, MmapThreshold>&) const noexcept {
+        return true;
+    }
+
+private:
+    static bool is_mapped_(size_type bytes) noexcept { return bytes >= MmapThreshold; }
+
+    static size_type round_to_pages_(size_type bytes) noexcept {
+        static const size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) & ~(page - 1);
+    }
+};
+
+} // namespace ptorpis
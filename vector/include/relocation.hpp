@@ -0,0 +1,119 @@
+/**
+ * @file data-structures/vector/include/relocation.hpp
+ * @brief Trivial relocation trait and the helpers the containers use to move elements
+ * @author ptorpis -- Peter Torpis
+ *
+ * Relocating an object means moving it to a new address and ending the lifetime of the
+ * original, which is what a vector does to every element when it grows. For most types
+ * this is the same as copying the bytes and forgetting the source, even when the type is
+ * not trivially copyable (std::unique_ptr, types holding a pointer to the heap...). For
+ * those types a move construct + destroy loop can be replaced with one memcpy/memmove.
+ *
+ * Trivially copyable types are detected automatically, other types opt in with
+ *
+ *     template <> struct ptorpis::is_trivially_relocatable<MyType> : std::true_type {};
+ *
+ * Only opt in types that do not store pointers to themselves (or register their address
+ * anywhere), those are the ones that break when their bytes move.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+namespace ptorpis {
+
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+// unique_ptr with the default deleter is a single pointer, moving its bytes is safe
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+/*
+ * All helpers below work on raw memory: the destination does not hold objects before the
+ * call, and the source does not hold objects after it. The void* casts silence
+ * -Wclass-memaccess, which would otherwise fire for opted-in non-trivial types.
+ */
+
+// relocates count objects into non-overlapping storage
+template <typename T> void relocate_bytes(T* first, std::size_t count, T* dest) noexcept {
+    static_assert(is_trivially_relocatable_v<T>);
+    if (count != 0) {
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(first),
+                    count * sizeof(T));
+    }
+}
+
+// relocates count objects within the same buffer, the ranges may overlap
+template <typename T> void relocate_bytes_overlapping(T* first, std::size_t count,
+                                                      T* dest) noexcept {
+    static_assert(is_trivially_relocatable_v<T>);
+    if (count != 0) {
+        std::memmove(static_cast<void*>(dest), static_cast<const void*>(first),
+                     count * sizeof(T));
+    }
+}
+
+/*
+ * Shifts [index, size) right by count so [index, index + count) is raw memory ready for
+ * the inserted elements. Other types are moved one by one: slots past size do not hold
+ * objects yet and are move constructed, and the moved-from objects left in the gap are
+ * destroyed.
+ */
+template <typename T>
+void open_gap(T* data, std::size_t size, std::size_t index, std::size_t count) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        relocate_bytes_overlapping(data + index, size - index, data + index + count);
+    } else {
+        for (std::size_t src = size; src-- > index;) {
+            if (src + count >= size) {
+                std::construct_at(data + src + count, std::move(data[src]));
+            } else {
+                data[src + count] = std::move(data[src]);
+            }
+        }
+        std::destroy(data + index, data + std::min(index + count, size));
+    }
+}
+
+// undoes open_gap when constructing the inserted elements fails, the gap is raw again
+template <typename T>
+void close_gap(T* data, std::size_t size, std::size_t index, std::size_t count) {
+    if constexpr (is_trivially_relocatable_v<T>) {
+        relocate_bytes_overlapping(data + index + count, size - index, data + index);
+    } else {
+        for (std::size_t dest = index; dest < size; ++dest) {
+            if (dest < index + count) {
+                std::construct_at(data + dest, std::move(data[dest + count]));
+            } else {
+                data[dest] = std::move(data[dest + count]);
+            }
+        }
+        std::destroy(data + std::max(size, index + count), data + size + count);
+    }
+}
+
+/*
+ * Allocators that can resize a block themselves (mmap_allocator), the vector hands them
+ * its whole buffer instead of copying trivially relocatable elements to a new one.
+ */
+template <typename Allocator>
+concept reallocating_allocator =
+    requires(Allocator& a, typename Allocator::value_type* p, std::size_t n) {
+        { a.reallocate(p, n, n) } -> std::same_as<typename Allocator::value_type*>;
+    };
+
+} // namespace detail
+
+} // namespace ptorpis
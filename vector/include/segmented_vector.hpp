@@ -0,0 +1,616 @@
+/**
+ * @file data-structures/vector/include/segmented_vector.hpp
+ * @brief Dynamic array of power-of-two sized blocks, elements never move
+ * @author ptorpis -- Peter Torpis
+ *
+ * Growing a vector copies every element to a new buffer and invalidates every pointer to
+ * them. segmented_vector<T> grows by allocating one more block instead, so pointers and
+ * references to its elements stay valid until the element is removed, and growing never
+ * copies anything.
+ *
+ * Block k holds FirstBlockSize << k elements, so each block is as large as all of the
+ * previous ones together plus the first one:
+ *
+ *     block 0: [0, B)   block 1: [B, 3B)   block 2: [3B, 7B)   ...
+ *
+ * Index i lives in block bit_width((i >> log2(B)) + 1) - 1, so indexing is a shift, a bit
+ * scan and an add, with no loop over the blocks. The block table is a fixed array inside
+ * the object (one pointer per possible block), so it never reallocates either.
+ *
+ * Each block is contiguous: segment(k) returns the elements of block k as a std::span,
+ * and the iterators walk a block with a pointer increment, only looking up the next block
+ * at a block boundary.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "comparison.hpp"
+
+namespace ptorpis {
+namespace detail {
+
+// about 512 bytes of elements in the first block, rounded down to a power of two
+template <typename T>
+inline constexpr std::size_t default_first_block_size =
+    std::bit_floor(std::max<std::size_t>(512 / sizeof(T), 1));
+
+struct segment_position {
+    std::size_t block;
+    std::size_t offset;
+};
+
+// elements in the first count blocks, when the first block holds FirstBlockSize
+template <std::size_t FirstBlockSize>
+constexpr std::size_t segmented_capacity(std::size_t count) noexcept {
+    return (FirstBlockSize << count) - FirstBlockSize;
+}
+
+/*
+ * Block k starts at index B * (2^k - 1), so (i / B + 1) has its highest bit at k. Works
+ * for any index below segmented_capacity<B>(digits - log2(B))
+ */
+template <std::size_t FirstBlockSize>
+constexpr segment_position segmented_locate(std::size_t index) noexcept {
+    constexpr unsigned shift = std::countr_zero(FirstBlockSize);
+    auto block = static_cast<std::size_t>(std::bit_width((index >> shift) + 1) - 1);
+    return {block, index - segmented_capacity<FirstBlockSize>(block)};
+}
+
+} // namespace detail
+
+/**
+ * @brief Dynamic array with stable element addresses
+ * @tparam T The type of the elements
+ * @tparam Allocator The allocator the blocks come from
+ * @tparam FirstBlockSize Elements in the first block, a power of two, every following
+ * block is twice as large as the one before it
+ */
+template <typename T, typename Allocator = std::allocator<T>,
+          std::size_t FirstBlockSize = detail::default_first_block_size<T>>
+class segmented_vector {
+    static_assert(std::has_single_bit(FirstBlockSize),
+                  "FirstBlockSize must be a power of two");
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+    template <bool Const> class basic_iterator;
+
+public:
+    using value_type = T;
+    using allocator_type = Allocator;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type first_block_size = FirstBlockSize;
+
+    // enough blocks for every index a size_type can hold
+    static constexpr size_type max_blocks =
+        std::numeric_limits<size_type>::digits - std::countr_zero(FirstBlockSize);
+
+    constexpr size_type max_size() const noexcept {
+        constexpr auto max_bytes =
+            static_cast<size_type>(std::numeric_limits<difference_type>::max());
+        return std::min(max_bytes / sizeof(T), capacity_of_(max_blocks - 1));
+    }
+
+    /*
+     * Constructors
+     */
+
+    segmented_vector() noexcept = default;
+
+    explicit segmented_vector(const Allocator& allocator) noexcept : alloc_m(allocator) {}
+
+    segmented_vector(size_type count, const Allocator& allocator = Allocator())
+        : alloc_m(allocator) {
+        resize(count);
+    }
+
+    segmented_vector(size_type count, const T& value,
+                     const Allocator& allocator = Allocator())
+        : alloc_m(allocator) {
+        reserve(count);
+        for (size_type i = 0; i < count; ++i) {
+            emplace_back(value);
+        }
+    }
+
+    segmented_vector(std::initializer_list<T> init,
+                     const Allocator& allocator = Allocator())
+        : alloc_m(allocator) {
+        reserve(init.size());
+        for (const T& value : init) {
+            emplace_back(value);
+        }
+    }
+
+    segmented_vector(const segmented_vector& other)
+        : alloc_m(alloc_traits::select_on_container_copy_construction(other.alloc_m)) {
+        reserve(other.size_m);
+        other.for_each_segment_([this](const T* first, size_type count) {
+            for (size_type i = 0; i < count; ++i) {
+                emplace_back(first[i]);
+            }
+        });
+    }
+
+    /**
+     * @brief Move constructor, takes over other's blocks, no element is moved
+     *
+     * Pointers to other's elements now point into *this.
+     */
+    segmented_vector(segmented_vector&& other) noexcept
+        : alloc_m(std::move(other.alloc_m)),
+          blocks_m(std::exchange(other.blocks_m, {})),
+          block_count_m(std::exchange(other.block_count_m, 0)),
+          size_m(std::exchange(other.size_m, 0)) {}
+
+    /**
+     * @brief Copy assignment
+     *
+     * Copy assigns over the existing elements and keeps the blocks of *this, which are
+     * only freed by shrink_to_fit(). Basic guarantee.
+     */
+    segmented_vector& operator=(const segmented_vector& other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (alloc_m != other.alloc_m) {
+                release_();
+            }
+            alloc_m = other.alloc_m;
+        }
+
+        size_type common = std::min(size_m, other.size_m);
+        for (size_type i = 0; i < common; ++i) {
+            (*this)[i] = other[i];
+        }
+        resize_down_(common);
+        reserve(other.size_m);
+        for (size_type i = common; i < other.size_m; ++i) {
+            emplace_back(other[i]);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Move assignment, takes over other's blocks like the move constructor
+     */
+    segmented_vector& operator=(segmented_vector&& other) noexcept {
+        if (this == &other) {
+            return *this;
+        }
+
+        release_();
+
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc_m = std::move(other.alloc_m);
+        }
+
+        blocks_m = std::exchange(other.blocks_m, {});
+        block_count_m = std::exchange(other.block_count_m, 0);
+        size_m = std::exchange(other.size_m, 0);
+        return *this;
+    }
+
+    ~segmented_vector() { release_(); }
+
+    void swap(segmented_vector& other) noexcept {
+        if constexpr (alloc_traits::propagate_on_container_swap::value) {
+            std::swap(alloc_m, other.alloc_m);
+        }
+        std::swap(blocks_m, other.blocks_m);
+        std::swap(block_count_m, other.block_count_m);
+        std::swap(size_m, other.size_m);
+    }
+
+    allocator_type get_allocator() const noexcept { return alloc_m; }
+
+    /*
+     * Capacity
+     */
+
+    size_type size() const noexcept { return size_m; }
+    bool empty() const noexcept { return size_m == 0; }
+    size_type capacity() const noexcept { return capacity_of_(block_count_m); }
+
+    /**
+     * @brief Allocates blocks until new_capacity elements fit, nothing is moved
+     * @throws std::length_error if new_capacity > max_size()
+     */
+    void reserve(size_type new_capacity) {
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        while (capacity() < new_capacity) {
+            add_block_();
+        }
+    }
+
+    // frees the blocks past the one holding the last element
+    void shrink_to_fit() noexcept {
+        size_type needed = size_m == 0 ? 0 : locate_(size_m - 1).block + 1;
+        while (block_count_m > needed) {
+            --block_count_m;
+            alloc_traits::deallocate(alloc_m, blocks_m[block_count_m],
+                                     block_size(block_count_m));
+            blocks_m[block_count_m] = nullptr;
+        }
+    }
+
+    /*
+     * Modifiers
+     */
+
+    /**
+     * @brief Appends an element constructed from args
+     * @return Reference to the new element
+     *
+     * When the last block is full a new block is allocated, the existing elements stay
+     * where they are, so args may refer to elements of *this. Strong guarantee.
+     */
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        if (size_m == capacity()) [[unlikely]] {
+            if (size_m == max_size()) {
+                throw std::length_error("Requested capacity exceeded max size.");
+            }
+            add_block_();
+        }
+
+        T* slot = address_(size_m);
+        alloc_traits::construct(alloc_m, slot, std::forward<Args>(args)...);
+        ++size_m;
+        return *slot;
+    }
+
+    void push_back(const T& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    void pop_back() {
+        --size_m;
+        alloc_traits::destroy(alloc_m, address_(size_m));
+    }
+
+    // destroys every element, the blocks are kept
+    void clear() noexcept { resize_down_(0); }
+
+    void resize(size_type count) {
+        if (count <= size_m) {
+            resize_down_(count);
+            return;
+        }
+
+        reserve(count);
+        while (size_m < count) {
+            emplace_back();
+        }
+    }
+
+    void resize(size_type count, const T& value) {
+        if (count <= size_m) {
+            resize_down_(count);
+            return;
+        }
+
+        reserve(count);
+        while (size_m < count) {
+            emplace_back(value);
+        }
+    }
+
+    /*
+     * Element access
+     */
+
+    reference operator[](size_type index) noexcept { return *address_(index); }
+    const_reference operator[](size_type index) const noexcept {
+        return *address_(index);
+    }
+
+    /**
+     * @brief Bounds checked element access
+     * @throws std::out_of_range if index >= size()
+     */
+    reference at(size_type index) {
+        if (index >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return *address_(index);
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return *address_(index);
+    }
+
+    reference front() noexcept { return *blocks_m[0]; }
+    const_reference front() const noexcept { return *blocks_m[0]; }
+    reference back() noexcept { return *address_(size_m - 1); }
+    const_reference back() const noexcept { return *address_(size_m - 1); }
+
+    /*
+     * Blocks
+     */
+
+    static constexpr size_type block_size(size_type block) noexcept {
+        return FirstBlockSize << block;
+    }
+
+    // number of blocks that hold elements
+    size_type segment_count() const noexcept {
+        return size_m == 0 ? 0 : locate_(size_m - 1).block + 1;
+    }
+
+    /**
+     * @brief The elements in block k, one contiguous array
+     *
+     * Every block before the last one returned by segment_count() is full.
+     */
+    std::span<T> segment(size_type block) noexcept {
+        return {blocks_m[block], segment_size_(block)};
+    }
+
+    std::span<const T> segment(size_type block) const noexcept {
+        return {blocks_m[block], segment_size_(block)};
+    }
+
+    /*
+     * Iterators
+     */
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_m); }
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_m); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    /*
+     * Comparison, block by block: two containers with the same FirstBlockSize split
+     * their elements into blocks at the same indices
+     */
+
+    friend bool operator==(const segmented_vector& a, const segmented_vector& b) {
+        if (a.size_m != b.size_m) {
+            return false;
+        }
+
+        for (size_type k = 0, segments = a.segment_count(); k < segments; ++k) {
+            size_type count = a.segment_size_(k);
+            if (!detail::equal_elements(a.blocks_m[k], b.blocks_m[k], count)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    friend auto operator<=>(const segmented_vector& a, const segmented_vector& b)
+        requires detail::synth_comparable<T>
+    {
+        using result = decltype(detail::synth_three_way(std::declval<const T&>(),
+                                                        std::declval<const T&>()));
+        size_type common = std::min(a.size_m, b.size_m);
+        for (size_type k = 0, first = 0; first < common; first += block_size(k), ++k) {
+            size_type count = std::min(block_size(k), common - first);
+            auto order =
+                detail::compare_elements(a.blocks_m[k], count, b.blocks_m[k], count);
+            if (order != 0) {
+                return result(order);
+            }
+        }
+        return result(a.size_m <=> b.size_m);
+    }
+
+private:
+    [[no_unique_address]] Allocator alloc_m;
+    std::array<T*, max_blocks> blocks_m{};
+    size_type block_count_m = 0;
+    size_type size_m = 0;
+
+    using position = detail::segment_position;
+
+    // elements in the first count blocks
+    static constexpr size_type capacity_of_(size_type count) noexcept {
+        return detail::segmented_capacity<FirstBlockSize>(count);
+    }
+
+    // works for any index below capacity_of_(max_blocks), not only below size()
+    static constexpr position locate_(size_type index) noexcept {
+        return detail::segmented_locate<FirstBlockSize>(index);
+    }
+
+    T* address_(size_type index) const noexcept {
+        auto [block, offset] = locate_(index);
+        return blocks_m[block] + offset;
+    }
+
+    size_type segment_size_(size_type block) const noexcept {
+        return std::min(block_size(block), size_m - capacity_of_(block));
+    }
+
+    void add_block_() {
+        blocks_m[block_count_m] =
+            alloc_traits::allocate(alloc_m, block_size(block_count_m));
+        ++block_count_m;
+    }
+
+    // calls f(first, count) for the elements of each block in order
+    template <typename F> void for_each_segment_(F&& f) const {
+        for (size_type k = 0, segments = segment_count(); k < segments; ++k) {
+            f(static_cast<const T*>(blocks_m[k]), segment_size_(k));
+        }
+    }
+
+    void resize_down_(size_type count) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            while (size_m > count) {
+                --size_m;
+                alloc_traits::destroy(alloc_m, address_(size_m));
+            }
+        }
+        size_m = count;
+    }
+
+    void release_() noexcept {
+        resize_down_(0);
+        for (size_type k = 0; k < block_count_m; ++k) {
+            alloc_traits::deallocate(alloc_m, blocks_m[k], block_size(k));
+            blocks_m[k] = nullptr;
+        }
+        block_count_m = 0;
+    }
+};
+
+/*
+ * Random access iterator. It keeps a pointer into the current block and the end of that
+ * block, so ++, -- and * are pointer operations, the block is looked up again only when
+ * the pointer crosses a block boundary or the iterator jumps by n.
+ */
+template <typename T, typename Allocator, std::size_t FirstBlockSize>
+template <bool Const>
+class segmented_vector<T, Allocator, FirstBlockSize>::basic_iterator {
+    using owner = std::conditional_t<Const, const segmented_vector, segmented_vector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+
+    basic_iterator() noexcept = default;
+    basic_iterator(owner* vector, size_type index) noexcept
+        : vector_m(vector), index_m(index) {
+        seek_();
+    }
+
+    // iterator converts to const_iterator
+    operator basic_iterator<true>() const noexcept
+        requires(!Const)
+    {
+        return basic_iterator<true>(vector_m, index_m);
+    }
+
+    reference operator*() const noexcept { return *ptr_m; }
+    pointer operator->() const noexcept { return ptr_m; }
+    reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+    basic_iterator& operator++() noexcept {
+        ++index_m;
+        if (++ptr_m == block_end_m) [[unlikely]] {
+            seek_();
+        }
+        return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+        basic_iterator old = *this;
+        ++*this;
+        return old;
+    }
+    basic_iterator& operator--() noexcept {
+        if (ptr_m == block_begin_m) [[unlikely]] {
+            --index_m;
+            seek_();
+        } else {
+            --index_m;
+            --ptr_m;
+        }
+        return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+        basic_iterator old = *this;
+        --*this;
+        return old;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+        index_m = static_cast<size_type>(static_cast<difference_type>(index_m) + n);
+        seek_();
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& a,
+                                     const basic_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_m) -
+               static_cast<difference_type>(b.index_m);
+    }
+
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m == b.index_m;
+    }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m <=> b.index_m;
+    }
+
+private:
+    owner* vector_m = nullptr;
+    size_type index_m = 0;
+    pointer ptr_m = nullptr;
+    pointer block_begin_m = nullptr;
+    pointer block_end_m = nullptr;
+
+    // points ptr_m at index_m, past the allocated blocks it stays null (end of a full
+    // container)
+    void seek_() noexcept {
+        if (vector_m == nullptr || index_m >= vector_m->capacity()) {
+            ptr_m = block_begin_m = block_end_m = nullptr;
+            return;
+        }
+
+        auto [block, offset] = locate_(index_m);
+        block_begin_m = vector_m->blocks_m[block];
+        block_end_m = block_begin_m + block_size(block);
+        ptr_m = block_begin_m + offset;
+    }
+};
+
+} // namespace ptorpis
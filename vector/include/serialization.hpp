@@ -0,0 +1,469 @@
+/**
+ * @file data-structures/vector/include/serialization.hpp
+ * @brief Versioned binary format for arrays of trivially copyable elements, and a view
+ * that reads it in place
+ * @author ptorpis -- Peter Torpis
+ *
+ * A serialized array is a 64-byte header followed by the elements' bytes, exactly as
+ * they are laid out in memory:
+ *
+ *     offset  0  magic          "PTVECSER", also rejects the other byte order
+ *             8  version
+ *            12  flags          bit 0: the checksum field is set
+ *            16  element_size   sizeof(T)
+ *            20  element_align  alignof(T)
+ *            24  size           number of elements
+ *            32  checksum       CRC32C of the element bytes, 0 without the flag
+ *            36  reserved, zero up to offset 64
+ *
+ * Writing never looks at the elements one by one: write() hands the header and the
+ * whole contiguous buffer to a single writev, serialize() is one memcpy. On the reading
+ * side vector_view<T> validates the header and then points straight into the buffer
+ * (an mmap'd file, a shared memory segment, a received message), so opening it does not
+ * touch the elements unless the checksum is verified.
+ *
+ * The format is only meaningful to the same T on the same architecture, as with
+ * mapped_vector: T has to be trivially copyable and should not hold pointers.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <type_traits>
+
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include "iterators.hpp"
+#include "vector.hpp"
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#define PTORPIS_SERIALIZATION_X86 1
+#else
+#define PTORPIS_SERIALIZATION_X86 0
+#endif
+
+namespace ptorpis {
+
+/**
+ * @brief Whether the writer stores a checksum of the elements
+ *
+ * crc32c uses the SSE4.2 crc32 instruction when the CPU has it (about 8 bytes per
+ * cycle), and a table otherwise.
+ */
+enum class checksum { none, crc32c };
+
+struct serialized_header {
+    static constexpr std::uint64_t MAGIC = 0x5245534345565450; // "PTVECSER"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint32_t HAS_CHECKSUM = 1;
+
+    std::uint64_t magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint32_t element_size;
+    std::uint32_t element_align;
+    std::uint64_t size;
+    std::uint32_t checksum;
+    std::uint32_t reserved;
+};
+
+inline constexpr std::size_t serialized_header_size = 64;
+static_assert(sizeof(serialized_header) <= serialized_header_size);
+
+// contiguous ranges whose elements can be written as raw bytes
+template <typename R>
+concept serializable_range =
+    std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+    std::is_trivially_copyable_v<std::ranges::range_value_t<R>>;
+
+namespace detail {
+
+inline constexpr std::array<std::uint32_t, 256> crc32c_table = [] {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ (0x82f63b78 & (0u - (crc & 1)));
+        }
+        table[i] = crc;
+    }
+    return table;
+}();
+
+// crc is the running value (~0 at the start), the caller inverts the final result
+inline std::uint32_t crc32c_scalar(std::uint32_t crc, const std::byte* data,
+                                   std::size_t count) noexcept {
+    for (std::size_t i = 0; i < count; ++i) {
+        auto index = (crc ^ static_cast<std::uint32_t>(data[i])) & 0xff;
+        crc = crc32c_table[index] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+#if PTORPIS_SERIALIZATION_X86
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+
+inline std::uint32_t crc32c_sse42(std::uint32_t crc, const std::byte* data,
+                                  std::size_t count) noexcept {
+    std::uint64_t crc64 = crc;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        crc64 = _mm_crc32_u64(crc64, word);
+    }
+
+    auto crc32 = static_cast<std::uint32_t>(crc64);
+    for (; i < count; ++i) {
+        crc32 = _mm_crc32_u8(crc32, static_cast<std::uint8_t>(data[i]));
+    }
+    return crc32;
+}
+
+#pragma GCC pop_options
+#endif
+
+inline bool has_crc32_instruction() noexcept {
+#if PTORPIS_SERIALIZATION_X86
+    static const bool supported = [] {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse4.2") != 0;
+    }();
+    return supported;
+#else
+    return false;
+#endif
+}
+
+/**
+ * CRC32C (Castagnoli) of count bytes, the checksum used by iSCSI, ext4 and most
+ * storage formats. crc32c("123456789") == 0xe3069283
+ */
+inline std::uint32_t crc32c(const void* data, std::size_t count) noexcept {
+    const auto* bytes = static_cast<const std::byte*>(data);
+#if PTORPIS_SERIALIZATION_X86
+    if (has_crc32_instruction()) {
+        return ~crc32c_sse42(~0u, bytes, count);
+    }
+#endif
+    return ~crc32c_scalar(~0u, bytes, count);
+}
+
+[[noreturn]] inline void serialization_throw_errno(const char* what) {
+    throw std::system_error(errno, std::generic_category(), what);
+}
+
+template <typename T>
+serialized_header make_header(const T* data, std::size_t count, checksum mode) noexcept {
+    serialized_header header{};
+    header.magic = serialized_header::MAGIC;
+    header.version = serialized_header::VERSION;
+    header.element_size = sizeof(T);
+    header.element_align = alignof(T);
+    header.size = count;
+    if (mode == checksum::crc32c) {
+        header.flags |= serialized_header::HAS_CHECKSUM;
+        header.checksum = crc32c(data, count * sizeof(T));
+    }
+    return header;
+}
+
+// throws std::runtime_error unless header was written by this version for T
+template <typename T> void check_header_fields(const serialized_header& header) {
+    if (header.magic != serialized_header::MAGIC) {
+        throw std::runtime_error("serialization: bad magic");
+    }
+    if (header.version != serialized_header::VERSION) {
+        throw std::runtime_error("serialization: unsupported version");
+    }
+    if (header.element_size != sizeof(T) || header.element_align != alignof(T)) {
+        throw std::runtime_error("serialization: element type mismatch");
+    }
+}
+
+// the header at the start of bytes, after checking that bytes holds all the elements
+template <typename T> serialized_header check_header(std::span<const std::byte> bytes) {
+    if (bytes.size() < serialized_header_size) {
+        throw std::runtime_error("serialization: buffer smaller than the header");
+    }
+
+    serialized_header header;
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    check_header_fields<T>(header);
+    if (header.size > (bytes.size() - serialized_header_size) / sizeof(T)) {
+        throw std::runtime_error("serialization: buffer is truncated");
+    }
+    return header;
+}
+
+template <typename T>
+void check_checksum(const serialized_header& header, const T* data) {
+    if ((header.flags & serialized_header::HAS_CHECKSUM) &&
+        crc32c(data, header.size * sizeof(T)) != header.checksum) {
+        throw std::runtime_error("serialization: checksum mismatch");
+    }
+}
+
+// reads exactly count bytes, false if the file ends first
+inline bool read_all(int fd, void* data, std::size_t count) {
+    auto* out = static_cast<std::byte*>(data);
+    while (count > 0) {
+        ssize_t n = ::read(fd, out, count);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            serialization_throw_errno("serialization: read");
+        }
+        if (n == 0) {
+            return false;
+        }
+        out += n;
+        count -= static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+// bytes left in fd when it is a regular file, or the largest size_t when that is unknown
+inline std::size_t remaining_bytes(int fd) {
+    struct stat st;
+    if (::fstat(fd, &st) == -1) {
+        serialization_throw_errno("serialization: fstat");
+    }
+
+    off_t offset = S_ISREG(st.st_mode) ? ::lseek(fd, 0, SEEK_CUR) : -1;
+    if (offset == -1) {
+        return std::numeric_limits<std::size_t>::max();
+    }
+    return st.st_size > offset ? static_cast<std::size_t>(st.st_size - offset) : 0;
+}
+
+} // namespace detail
+
+/**
+ * @brief Bytes serialize() and write() produce for range
+ */
+template <serializable_range R> std::size_t serialized_size(const R& range) noexcept {
+    return serialized_header_size +
+           std::ranges::size(range) * sizeof(std::ranges::range_value_t<R>);
+}
+
+/**
+ * @brief Writes the header and the elements of range into out with one memcpy
+ * @return The number of bytes written, serialized_size(range)
+ * @throws std::length_error if out is smaller than serialized_size(range)
+ */
+template <serializable_range R>
+std::size_t serialize(const R& range, std::span<std::byte> out,
+                      checksum mode = checksum::none) {
+    using T = std::ranges::range_value_t<R>;
+    std::size_t bytes = serialized_size(range);
+    if (out.size() < bytes) {
+        throw std::length_error("serialization: output buffer too small");
+    }
+
+    const T* data = std::ranges::data(range);
+    std::size_t count = std::ranges::size(range);
+    serialized_header header = detail::make_header(data, count, mode);
+
+    std::memset(out.data(), 0, serialized_header_size);
+    std::memcpy(out.data(), &header, sizeof(header));
+    if (count != 0) {
+        std::memcpy(out.data() + serialized_header_size, data, count * sizeof(T));
+    }
+    return bytes;
+}
+
+/**
+ * @brief Writes range to a file, pipe or socket with one writev of the header and the
+ * contiguous elements
+ *
+ * Partial writes (pipes, sockets, more than 2 GiB) are continued until everything is
+ * written.
+ *
+ * @throws std::system_error if writev fails
+ */
+template <serializable_range R>
+void write(int fd, const R& range, checksum mode = checksum::none) {
+    using T = std::ranges::range_value_t<R>;
+    const T* data = std::ranges::data(range);
+    std::size_t count = std::ranges::size(range);
+
+    std::byte header_bytes[serialized_header_size]{};
+    serialized_header header = detail::make_header(data, count, mode);
+    std::memcpy(header_bytes, &header, sizeof(header));
+
+    iovec parts[2] = {
+        {header_bytes, serialized_header_size},
+        {const_cast<T*>(data), count * sizeof(T)},
+    };
+    iovec* next = parts;
+    int remaining = count == 0 ? 1 : 2;
+
+    while (remaining > 0) {
+        ssize_t written = ::writev(fd, next, remaining);
+        if (written == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            detail::serialization_throw_errno("serialization: writev");
+        }
+
+        // skip what was written, maybe stopping in the middle of a part
+        auto n = static_cast<std::size_t>(written);
+        while (remaining > 0 && n >= next->iov_len) {
+            n -= next->iov_len;
+            ++next;
+            --remaining;
+        }
+        if (remaining > 0) {
+            next->iov_base = static_cast<std::byte*>(next->iov_base) + n;
+            next->iov_len -= n;
+        }
+    }
+}
+
+/**
+ * @brief Read-only view of a serialized array, directly over the serialized bytes
+ * @tparam T The element type the array was written with
+ *
+ * Does not own the bytes, which have to outlive the view. The elements are not copied,
+ * so the view works over an mmap'd file the same way as over a buffer in memory.
+ */
+template <typename T> class vector_view {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "serialized elements are raw bytes, T must be trivially copyable");
+
+public:
+    using value_type = T;
+    using reference = const T&;
+    using const_reference = const T&;
+    using pointer = const T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using iterator = detail::vector_const_iterator<T>;
+    using const_iterator = detail::vector_const_iterator<T>;
+
+    vector_view() noexcept = default;
+
+    /**
+     * @brief Views the array at the start of bytes
+     *
+     * Only reads the header, unless verify_checksum is set and the writer stored a
+     * checksum, then every element is read once to check it.
+     *
+     * @throws std::runtime_error if the header was not written for T, bytes is shorter
+     * than the array, the elements are not aligned for T, or the checksum does not match
+     */
+    explicit vector_view(std::span<const std::byte> bytes, bool verify_checksum = true) {
+        serialized_header header = detail::check_header<T>(bytes);
+        const std::byte* first = bytes.data() + serialized_header_size;
+        if (reinterpret_cast<std::uintptr_t>(first) % alignof(T) != 0) {
+            throw std::runtime_error("serialization: elements are misaligned for T");
+        }
+
+        data_m = reinterpret_cast<const T*>(first);
+        size_m = header.size;
+        if (verify_checksum) {
+            detail::check_checksum(header, data_m);
+        }
+    }
+
+    size_type size() const noexcept { return size_m; }
+    bool empty() const noexcept { return size_m == 0; }
+    const T* data() const noexcept { return data_m; }
+
+    // bytes of the serialized array, where the next one starts in a stream of them
+    size_type serialized_size() const noexcept {
+        return serialized_header_size + size_m * sizeof(T);
+    }
+
+    const T& operator[](size_type index) const noexcept { return data_m[index]; }
+
+    /**
+     * @brief Bounds checked element access
+     * @throws std::out_of_range if index >= size()
+     */
+    const T& at(size_type index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data_m[index];
+    }
+
+    const T& front() const noexcept { return data_m[0]; }
+    const T& back() const noexcept { return data_m[size_m - 1]; }
+
+    const_iterator begin() const noexcept { return const_iterator(data_m); }
+    const_iterator end() const noexcept { return const_iterator(data_m + size_m); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    operator std::span<const T>() const noexcept { return {data_m, size_m}; }
+
+private:
+    const T* data_m = nullptr;
+    size_type size_m = 0;
+};
+
+/**
+ * @brief Reads one array written by write() from fd into a new vector
+ *
+ * The header is read first, then the elements with as few reads as the file allows,
+ * straight into the vector's buffer, which is not initialized first. For a regular file
+ * the size in the header is checked against the rest of the file before allocating.
+ *
+ * @throws std::runtime_error if the header was not written for T, the input ends early
+ * or the checksum does not match
+ * @throws std::system_error if read fails
+ */
+template <typename T> vector<T> read_vector(int fd, bool verify_checksum = true) {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "serialized elements are raw bytes, T must be trivially copyable");
+
+    std::byte header_bytes[serialized_header_size];
+    if (!detail::read_all(fd, header_bytes, serialized_header_size)) {
+        throw std::runtime_error("serialization: input ends inside the header");
+    }
+
+    serialized_header header;
+    std::memcpy(&header, header_bytes, sizeof(header));
+    detail::check_header_fields<T>(header);
+    if (header.size > vector<T>().max_size()) {
+        throw std::runtime_error("serialization: size exceeds max_size()");
+    }
+    if (header.size > detail::remaining_bytes(fd) / sizeof(T)) {
+        throw std::runtime_error("serialization: input ends inside the elements");
+    }
+
+    vector<T> result;
+    result.resize_for_overwrite(header.size);
+    if (!detail::read_all(fd, result.data(), header.size * sizeof(T))) {
+        throw std::runtime_error("serialization: input ends inside the elements");
+    }
+    if (verify_checksum) {
+        detail::check_checksum(header, result.data());
+    }
+    return result;
+}
+
+} // namespace ptorpis
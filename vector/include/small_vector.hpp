@@ -0,0 +1,624 @@
+/**
+ * @file data-structures/vector/include/small_vector.hpp
+ * @brief vector with an inline buffer for the first N elements
+ * @author ptorpis -- Peter Torpis
+ *
+ * Same interface and iterator types as ptorpis::vector, but the first N elements live
+ * inside the object itself, so containers that usually stay small never touch the heap.
+ * Once the size goes past N the elements move to a heap block obtained from Allocator and
+ * the container behaves like a regular vector from then on. shrink_to_fit() moves them
+ * back inline when they fit again.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include "comparison.hpp"
+#include "growth_policy.hpp"
+#include "iterators.hpp"
+#include "relocation.hpp"
+
+namespace ptorpis {
+/**
+ * @brief Dynamic array container with small buffer optimization
+ * @tparam T The type of the elements
+ * @tparam N Number of elements stored inline before spilling to the heap
+ * @tparam Allocator The allocator type used once the inline buffer is full
+ * @tparam GrowthPolicy Picks the new capacity when full, see growth_policy.hpp
+ */
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>,
+          growth_policy GrowthPolicy = doubling_growth>
+class small_vector {
+    static_assert(N > 0, "small_vector needs room for at least one inline element");
+
+private:
+    using alloc_traits = std::allocator_traits<Allocator>;
+
+public:
+    using iterator = detail::vector_iterator<T>;
+    using const_iterator = detail::vector_const_iterator<T>;
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    using value_type = T;
+    using reference = T&;
+    using const_reference = const T&;
+    using pointer = T*;
+    using const_pointer = const T*;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    static constexpr size_type inline_capacity = N;
+
+    constexpr size_type max_size() const noexcept {
+        return alloc_traits::max_size(alloc_m);
+    }
+
+    /*
+     * Constructors
+     */
+
+    small_vector() noexcept : data_m(inline_data_()), capacity_m(N), size_m(0) {}
+
+    small_vector(const Allocator& allocator) noexcept
+        : alloc_m(allocator), data_m(inline_data_()), capacity_m(N), size_m(0) {}
+
+    small_vector(size_type count, const Allocator& allocator = Allocator())
+        : small_vector(allocator) {
+        reserve(count);
+        construct_guarded_([&](pointer p) { new (p) T(); }, count);
+    }
+
+    small_vector(size_type count, const T& value,
+                 const Allocator& allocator = Allocator())
+        : small_vector(allocator) {
+        reserve(count);
+        construct_guarded_([&](pointer p) { new (p) T(value); }, count);
+    }
+
+    small_vector(std::initializer_list<T> init, const Allocator& allocator = Allocator())
+        : small_vector(allocator) {
+        reserve(init.size());
+        auto it = init.begin();
+        construct_guarded_([&](pointer p) { new (p) T(*it++); }, init.size());
+    }
+
+    small_vector(const small_vector& other)
+        : small_vector(
+              alloc_traits::select_on_container_copy_construction(other.alloc_m)) {
+        copy_from_(other);
+    }
+
+    /**
+     * @brief Move constructor
+     *
+     * Steals the heap block if other has spilled, otherwise moves the inline elements
+     * one by one (or with one memcpy for trivially relocatable types).
+     *
+     * @note After the move, other is empty and back on its inline buffer
+     */
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : alloc_m(std::move(other.alloc_m)), data_m(inline_data_()), capacity_m(N),
+          size_m(0) {
+        take_(other);
+    }
+
+    small_vector& operator=(const small_vector& other) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            release_heap_();
+            alloc_m = other.alloc_m;
+        }
+
+        copy_from_(other);
+        return *this;
+    }
+
+    small_vector& operator=(small_vector&& other) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        if (this == &other) {
+            return *this;
+        }
+
+        clear();
+        release_heap_();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc_m = std::move(other.alloc_m);
+        }
+
+        take_(other);
+        return *this;
+    }
+
+    ~small_vector() {
+        clear();
+        release_heap_();
+    }
+
+    void reserve(size_type new_capacity) {
+        if (capacity_m >= new_capacity) {
+            return;
+        }
+
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        reallocate_(new_capacity);
+    }
+
+    /*
+     * Access methods
+     */
+
+    T& at(size_type pos) {
+        if (pos >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+
+        return data_m[pos];
+    }
+
+    const T& at(size_type pos) const {
+        if (pos >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return data_m[pos];
+    }
+
+    reference operator[](size_type pos) { return data_m[pos]; }
+    reference operator[](size_type pos) const { return data_m[pos]; }
+
+    reference back() const { return data_m[size_m - 1]; }
+    reference back() { return data_m[size_m - 1]; }
+
+    reference front() { return *data_m; }
+    reference front() const { return *data_m; }
+
+    pointer data() { return data_m; }
+    const T* data() const { return data_m; }
+
+    size_type size() const { return size_m; }
+
+    size_type capacity() const { return capacity_m; }
+
+    // true while the elements live in the inline buffer
+    bool is_inline() const noexcept { return data_m == inline_data_(); }
+
+    /*
+     * Modifiers
+     */
+
+    void push_back(const T& value) { emplace_back(value); }
+
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    /*
+     * When full, the new element is built in the new block before the old elements are
+     * moved, so args may refer to an element, as in vector::emplace_back
+     */
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        if (size_m == capacity_m) [[unlikely]] {
+            return grow_emplace_back_(std::forward<Args>(args)...);
+        }
+
+        new (data_m + size_m) T(std::forward<Args>(args)...);
+        ++size_m;
+        return data_m[size_m - 1];
+    }
+
+    void pop_back() {
+        data_m[size_m - 1].~T();
+        --size_m;
+    }
+
+    void clear() {
+        for (size_type i{}; i < size_m; ++i) {
+            data_m[i].~T();
+        }
+
+        size_m = 0;
+    }
+
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_type first_idx = first - begin();
+        size_type last_idx = last - begin();
+        size_type count = last_idx - first_idx;
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            for (size_type i{first_idx}; i < last_idx; ++i) {
+                data_m[i].~T();
+            }
+            detail::relocate_bytes_overlapping(data_m + last_idx, size_m - last_idx,
+                                               data_m + first_idx);
+        } else {
+            std::move(data_m + last_idx, data_m + size_m, data_m + first_idx);
+            for (size_type i{size_m - count}; i < size_m; ++i) {
+                data_m[i].~T();
+            }
+        }
+
+        size_m -= count;
+        return iterator(data_m + first_idx);
+    }
+
+    iterator insert(const_iterator pos, const T& value) { return insert(pos, 1, value); }
+
+    iterator insert(const_iterator pos, T&& value) {
+        if (is_element_(value)) {
+            // growing or opening the gap would move value before it is read
+            T moved(std::move(value));
+            return insert(pos, std::move(moved));
+        }
+
+        return insert_n_(pos - begin(), 1,
+                         [&](pointer p) { new (p) T(std::move(value)); });
+    }
+
+    iterator insert(const_iterator pos, size_type count, const T& value) {
+        if (is_element_(value)) {
+            const T copy(value);
+            return insert(pos, count, copy);
+        }
+
+        return insert_n_(pos - begin(), count, [&](pointer p) { new (p) T(value); });
+    }
+
+    /**
+     * @brief Constructs an element from args before pos
+     *
+     * At end() it is emplace_back, otherwise the element is built as a temporary first
+     * (args may refer to elements, which the gap would move) and moved into place.
+     */
+    template <typename... Args> iterator emplace(const_iterator pos, Args&&... args) {
+        if (pos == cend()) {
+            emplace_back(std::forward<Args>(args)...);
+            return iterator(data_m + size_m - 1);
+        }
+
+        T value(std::forward<Args>(args)...);
+        return insert(pos, std::move(value));
+    }
+
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        return insert_range(pos, std::ranges::subrange(first, last));
+    }
+
+    iterator insert(const_iterator pos, std::initializer_list<T> iList) {
+        return insert_range(pos, iList);
+    }
+
+    /**
+     * @brief Inserts the elements of rg before pos
+     *
+     * Sized and forward ranges grow the buffer at most once and construct the elements
+     * straight into the gap. Single-pass input ranges are appended and rotated into
+     * place, as in vector::insert_range.
+     */
+    template <detail::container_compatible_range<T> R>
+    iterator insert_range(const_iterator pos, R&& rg) {
+        size_type index = pos - begin();
+
+        if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+            auto count = static_cast<size_type>(std::ranges::distance(rg));
+            auto it = std::ranges::begin(rg);
+            return insert_n_(index, count, [&](pointer p) { new (p) T(*it++); });
+        } else {
+            size_type old_size = size_m;
+
+            try {
+                for (auto&& value : rg) {
+                    emplace_back(std::forward<decltype(value)>(value));
+                }
+            } catch (...) {
+                for (size_type i{old_size}; i < size_m; ++i) {
+                    data_m[i].~T();
+                }
+                size_m = old_size;
+                throw;
+            }
+
+            std::rotate(data_m + index, data_m + old_size, data_m + size_m);
+            return iterator(data_m + index);
+        }
+    }
+
+    template <detail::container_compatible_range<T> R> void append_range(R&& rg) {
+        insert_range(cend(), std::forward<R>(rg));
+    }
+
+    /**
+     * @brief Changes the number of elements to count
+     *
+     * Extra elements are value initialized, shrinking destroys the elements past count
+     * and keeps the capacity. Growing past the capacity goes through the growth policy.
+     */
+    void resize(size_type count) {
+        resize_with_(count, [](pointer p) { new (p) T(); });
+    }
+
+    /// @overload Extra elements are copies of value
+    void resize(size_type count, const T& value) {
+        if (count > capacity_m && is_element_(value)) {
+            // value is one of the elements, copy it before the buffer moves
+            const T copy(value);
+            resize(count, copy);
+            return;
+        }
+
+        resize_with_(count, [&](pointer p) { new (p) T(value); });
+    }
+
+    // like resize, but trivial types are left uninitialized, see vector
+    void resize_for_overwrite(size_type count) {
+        resize_with_(count, [](pointer p) { new (p) T; });
+    }
+
+    bool empty() const { return size_m == 0; }
+
+    /**
+     * @brief Releases unused heap capacity, moving the elements back into the inline
+     * buffer if they fit
+     */
+    void shrink_to_fit() {
+        if (is_inline() || size_m == capacity_m) {
+            return;
+        }
+
+        reallocate_(size_m);
+    }
+
+    bool operator==(const small_vector& other) const {
+        return size_m == other.size_m &&
+               detail::equal_elements(data_m, other.data_m, size_m);
+    }
+
+    auto operator<=>(const small_vector& other) const
+        requires detail::synth_comparable<T>
+    {
+        return detail::compare_elements(data_m, size_m, other.data_m, other.size_m);
+    }
+
+    iterator begin() { return iterator(data_m); }
+    iterator end() { return iterator(data_m + size_m); }
+
+    const_iterator begin() const { return const_iterator(data_m); }
+    const_iterator end() const { return const_iterator(data_m + size_m); }
+
+    const_iterator cbegin() const { return const_iterator(data_m); }
+    const_iterator cend() const { return const_iterator(data_m + size_m); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(cend()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(cbegin()); }
+
+private:
+    [[no_unique_address]] Allocator alloc_m;
+    pointer data_m; // points at inline_m until the first spill
+    size_type capacity_m;
+    size_type size_m;
+    alignas(T) std::byte inline_m[N * sizeof(T)];
+
+    pointer inline_data_() const noexcept {
+        return reinterpret_cast<pointer>(const_cast<std::byte*>(inline_m));
+    }
+
+    void release_heap_() noexcept {
+        if (!is_inline()) {
+            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
+            data_m = inline_data_();
+            capacity_m = N;
+        }
+    }
+
+    // constructs count elements at the end, destroying them again if one throws
+    template <typename Construct> void construct_guarded_(Construct&& construct,
+                                                          size_type count) {
+        size_type constructed{};
+        try {
+            for (; constructed < count; ++constructed) {
+                construct(data_m + size_m + constructed);
+            }
+        } catch (...) {
+            for (size_type i{}; i < constructed; ++i) {
+                data_m[size_m + i].~T();
+            }
+            throw;
+        }
+        size_m += count;
+    }
+
+    // copies other's elements into *this, which must be empty
+    void copy_from_(const small_vector& other) {
+        reserve(other.size_m);
+        size_type i{};
+        construct_guarded_([&](pointer p) { new (p) T(other.data_m[i++]); },
+                           other.size_m);
+    }
+
+    // moves other's elements into *this (which must be empty and inline)
+    void take_(small_vector& other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (!other.is_inline()) {
+            data_m = std::exchange(other.data_m, other.inline_data_());
+            capacity_m = std::exchange(other.capacity_m, N);
+            size_m = std::exchange(other.size_m, 0);
+            return;
+        }
+
+        relocate_to_(data_m, other.data_m, other.size_m);
+        size_m = std::exchange(other.size_m, 0);
+    }
+
+    /*
+     * Moves count elements from src into raw memory at dest and destroys the sources,
+     * with a memcpy for trivially relocatable types
+     */
+    static void relocate_to_(pointer dest, pointer src, size_type count) {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            detail::relocate_bytes(src, count, dest);
+        } else {
+            size_type moved{};
+            try {
+                for (; moved < count; ++moved) {
+                    new (dest + moved) T(std::move_if_noexcept(src[moved]));
+                }
+            } catch (...) {
+                for (size_type i{}; i < moved; ++i) {
+                    dest[i].~T();
+                }
+                throw;
+            }
+
+            for (size_type i{}; i < count; ++i) {
+                src[i].~T();
+            }
+        }
+    }
+
+    /*
+     * Moves the elements into a heap block of new_capacity, or back into the inline
+     * buffer when new_capacity <= N
+     */
+    void reallocate_(size_type new_capacity) {
+        bool to_inline = new_capacity <= N;
+        pointer new_data =
+            to_inline ? inline_data_() : alloc_traits::allocate(alloc_m, new_capacity);
+
+        try {
+            relocate_to_(new_data, data_m, size_m);
+        } catch (...) {
+            if (!to_inline) {
+                alloc_traits::deallocate(alloc_m, new_data, new_capacity);
+            }
+            throw;
+        }
+
+        release_heap_();
+        data_m = new_data;
+        capacity_m = to_inline ? N : new_capacity;
+    }
+
+    // the policy only adds slack, the result always fits required elements
+    size_type grow_capacity_(size_type required) const {
+        return std::max(required,
+                        GrowthPolicy::next_capacity(capacity_m, required, sizeof(T)));
+    }
+
+    template <typename Construct>
+    void resize_with_(size_type count, Construct&& construct) {
+        if (count <= size_m) {
+            for (size_type i{count}; i < size_m; ++i) {
+                data_m[i].~T();
+            }
+            size_m = count;
+            return;
+        }
+
+        if (count > capacity_m) {
+            reserve(grow_capacity_(count));
+        }
+        construct_guarded_(construct, count - size_m);
+    }
+
+    bool is_element_(const T& value) const {
+        std::less<const T*> less;
+        const T* address = std::addressof(value);
+        return !less(address, data_m) && less(address, data_m + size_m);
+    }
+
+    // emplace_back when full, always spills to a larger heap block
+    template <typename... Args> reference grow_emplace_back_(Args&&... args) {
+        size_type new_capacity = grow_capacity_(size_m + 1);
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        pointer new_data = alloc_traits::allocate(alloc_m, new_capacity);
+        try {
+            new (new_data + size_m) T(std::forward<Args>(args)...);
+        } catch (...) {
+            alloc_traits::deallocate(alloc_m, new_data, new_capacity);
+            throw;
+        }
+
+        try {
+            relocate_to_(new_data, data_m, size_m);
+        } catch (...) {
+            new_data[size_m].~T();
+            alloc_traits::deallocate(alloc_m, new_data, new_capacity);
+            throw;
+        }
+
+        release_heap_();
+        data_m = new_data;
+        capacity_m = new_capacity;
+        ++size_m;
+        return data_m[size_m - 1];
+    }
+
+    void grow_for_(size_type count) {
+        if (size_m + count > capacity_m) {
+            reserve(grow_capacity_(size_m + count));
+        }
+    }
+
+    template <typename Construct>
+    iterator insert_n_(size_type index, size_type count, Construct&& construct) {
+        if (count == 0) {
+            return iterator(data_m + index);
+        }
+
+        grow_for_(count);
+        open_gap_(index, count);
+
+        size_type inserted{};
+        try {
+            for (; inserted < count; ++inserted) {
+                construct(data_m + index + inserted);
+            }
+        } catch (...) {
+            for (size_type i{}; i < inserted; ++i) {
+                data_m[index + i].~T();
+            }
+
+            close_gap_(index, count);
+            throw;
+        }
+
+        size_m += count;
+        return iterator(data_m + index);
+    }
+
+    // same gap handling as vector::open_gap_/close_gap_
+    void open_gap_(size_type index, size_type count) {
+        detail::open_gap(data_m, size_m, index, count);
+    }
+
+    void close_gap_(size_type index, size_type count) {
+        detail::close_gap(data_m, size_m, index, count);
+    }
+};
+
+} // namespace ptorpis
@@ -0,0 +1,591 @@
+/**
+ * @file data-structures/vector/include/soa_vector.hpp
+ * @brief Struct-of-arrays container, one contiguous cache line aligned array per field
+ * @author ptorpis -- Peter Torpis
+ *
+ * soa_vector<Fields...> holds rows of Fields... like a vector<std::tuple<Fields...>>, but
+ * stores every field in its own array. A pass that reads two fields of a twelve field
+ * record only pulls those two arrays through the cache instead of the whole records.
+ *
+ *     ptorpis::soa_vector<std::int64_t, std::int32_t, double> orders; // price, qty, fee
+ *     orders.emplace_back(1005, 10, 0.25);
+ *     std::span<std::int64_t> prices = orders.column<0>();
+ *     for (auto [price, qty, fee] : orders) { ... }
+ *
+ * All arrays live in one allocation and share a single size and capacity, so growing is
+ * one allocation for every field. Each array starts on a 64-byte boundary, ready for
+ * aligned SIMD loads (the kernels in kernels.hpp take the column spans directly).
+ *
+ * Rows are std::tuple<Fields&...> proxies: operator[] and the iterators return them by
+ * value. They unpack with structured bindings, and assigning a tuple to one writes every
+ * field of the row. Because the iterators return proxies, algorithms that swap elements
+ * (std::sort...) are not supported, and const_iterator only models the iterator concepts
+ * with a standard library that has the C++23 common_reference for tuples.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "comparison.hpp"
+#include "growth_policy.hpp"
+#include "relocation.hpp"
+
+namespace ptorpis {
+/**
+ * @brief Dynamic array of rows stored as one array per field
+ * @tparam Fields The field types of a row, non-const object types
+ */
+template <typename... Fields> class soa_vector {
+    static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+    static_assert(((std::is_object_v<Fields> && !std::is_const_v<Fields>) && ...),
+                  "soa_vector fields must be non-const object types");
+
+private:
+    template <bool Const> class basic_iterator;
+
+    using columns_type = std::tuple<Fields*...>;
+
+public:
+    using value_type = std::tuple<Fields...>;
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<const Fields&...>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    template <std::size_t I> using field_type = std::tuple_element_t<I, value_type>;
+
+    static constexpr std::size_t field_count = sizeof...(Fields);
+    static constexpr std::size_t column_alignment =
+        std::max({std::size_t{64}, alignof(Fields)...});
+
+    constexpr size_type max_size() const noexcept {
+        return (static_cast<size_type>(std::numeric_limits<difference_type>::max()) -
+                field_count * column_alignment) /
+               row_bytes_;
+    }
+
+    /*
+     * Constructors
+     */
+
+    soa_vector() noexcept = default;
+
+    soa_vector(const soa_vector& other) {
+        reserve(other.size_m);
+        copy_rows_(other);
+    }
+
+    soa_vector(soa_vector&& other) noexcept
+        : buffer_m(std::exchange(other.buffer_m, nullptr)),
+          columns_m(std::exchange(other.columns_m, columns_type{})),
+          capacity_m(std::exchange(other.capacity_m, 0)),
+          size_m(std::exchange(other.size_m, 0)) {}
+
+    /**
+     * @brief Copy assignment
+     *
+     * Strong guarantee, the copy is built before *this is touched.
+     */
+    soa_vector& operator=(const soa_vector& other) {
+        if (this != &other) {
+            soa_vector copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    soa_vector& operator=(soa_vector&& other) noexcept {
+        if (this != &other) {
+            soa_vector moved(std::move(other));
+            swap(moved);
+        }
+        return *this;
+    }
+
+    ~soa_vector() {
+        clear();
+        deallocate_(buffer_m, capacity_m);
+    }
+
+    void swap(soa_vector& other) noexcept {
+        std::swap(buffer_m, other.buffer_m);
+        std::swap(columns_m, other.columns_m);
+        std::swap(capacity_m, other.capacity_m);
+        std::swap(size_m, other.size_m);
+    }
+
+    /*
+     * Capacity
+     */
+
+    size_type size() const noexcept { return size_m; }
+    size_type capacity() const noexcept { return capacity_m; }
+    bool empty() const noexcept { return size_m == 0; }
+
+    /**
+     * @brief Makes room for new_capacity rows in every column with one allocation
+     * @throws std::length_error if new_capacity > max_size()
+     */
+    void reserve(size_type new_capacity) {
+        if (new_capacity <= capacity_m) {
+            return;
+        }
+
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
+
+        reallocate_(new_capacity, [](const columns_type&) { return false; });
+    }
+
+    void shrink_to_fit() {
+        if (size_m == capacity_m) {
+            return;
+        }
+
+        if (size_m == 0) {
+            deallocate_(buffer_m, capacity_m);
+            buffer_m = nullptr;
+            columns_m = columns_type{};
+            capacity_m = 0;
+            return;
+        }
+
+        reallocate_(size_m, [](const columns_type&) { return false; });
+    }
+
+    /*
+     * Modifiers
+     */
+
+    /**
+     * @brief Appends a row, constructing each field from the matching argument
+     * @return The new row
+     *
+     * The arguments may refer to rows of this container, even when it has to grow.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == field_count &&
+                 (std::is_constructible_v<Fields, Args &&> && ...))
+    reference emplace_back(Args&&... args) {
+        if (size_m == capacity_m) [[unlikely]] {
+            /*
+             * The new row is built in the new buffer before the old rows move out, so
+             * arguments pointing into the old buffer are still valid while it is built
+             */
+            size_type required = size_m + 1;
+            if (required > max_size()) {
+                throw std::length_error("Requested capacity exceeded max size.");
+            }
+            size_type new_capacity = std::max(
+                required,
+                doubling_growth::next_capacity(capacity_m, required, row_bytes_));
+            new_capacity = std::min(new_capacity, max_size());
+            reallocate_(new_capacity, [&](const columns_type& columns) {
+                construct_row_(columns, size_m, std::forward<Args>(args)...);
+                return true;
+            });
+        } else {
+            construct_row_(columns_m, size_m, std::forward<Args>(args)...);
+        }
+
+        ++size_m;
+        return (*this)[size_m - 1];
+    }
+
+    void push_back(const value_type& row) {
+        std::apply([this](const Fields&... fields) { emplace_back(fields...); }, row);
+    }
+
+    void push_back(value_type&& row) {
+        std::apply([this](Fields&... fields) { emplace_back(std::move(fields)...); },
+                   row);
+    }
+
+    void pop_back() {
+        --size_m;
+        destroy_rows_(size_m, size_m + 1);
+    }
+
+    void clear() noexcept {
+        destroy_rows_(0, size_m);
+        size_m = 0;
+    }
+
+    /**
+     * @brief Adds value-initialized rows or removes rows from the end
+     */
+    void resize(size_type count) {
+        if (count <= size_m) {
+            destroy_rows_(count, size_m);
+            size_m = count;
+            return;
+        }
+
+        reserve(count);
+        while (size_m < count) {
+            emplace_back(Fields()...);
+        }
+    }
+
+    /*
+     * Element access
+     */
+
+    reference operator[](size_type index) noexcept {
+        return std::apply(
+            [index](Fields*... column) { return reference(column[index]...); },
+            columns_m);
+    }
+
+    const_reference operator[](size_type index) const noexcept {
+        return std::apply(
+            [index](Fields*... column) { return const_reference(column[index]...); },
+            columns_m);
+    }
+
+    /**
+     * @brief Bounds checked row access
+     * @throws std::out_of_range if index >= size()
+     */
+    reference at(size_type index) {
+        if (index >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return (*this)[index];
+    }
+
+    const_reference at(size_type index) const {
+        if (index >= size_m) {
+            throw std::out_of_range("Element accessed is out of bounds");
+        }
+        return (*this)[index];
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[size_m - 1]; }
+    const_reference back() const noexcept { return (*this)[size_m - 1]; }
+
+    /**
+     * @brief The I-th field of every row, as one contiguous array
+     *
+     * The span stays valid until the container grows, like a pointer into a vector.
+     */
+    template <std::size_t I> std::span<field_type<I>> column() noexcept {
+        return {std::get<I>(columns_m), size_m};
+    }
+
+    template <std::size_t I> std::span<const field_type<I>> column() const noexcept {
+        return {std::get<I>(columns_m), size_m};
+    }
+
+    template <std::size_t I> field_type<I>* data() noexcept {
+        return std::get<I>(columns_m);
+    }
+
+    template <std::size_t I> const field_type<I>* data() const noexcept {
+        return std::get<I>(columns_m);
+    }
+
+    bool operator==(const soa_vector& other) const {
+        if (size_m != other.size_m) {
+            return false;
+        }
+
+        return [&]<std::size_t... I>(std::index_sequence<I...>) {
+            return (detail::equal_elements(std::get<I>(columns_m),
+                                           std::get<I>(other.columns_m), size_m) &&
+                    ...);
+        }(std::index_sequence_for<Fields...>{});
+    }
+
+    /*
+     * Iterators
+     */
+
+    iterator begin() noexcept { return iterator(this, 0); }
+    iterator end() noexcept { return iterator(this, size_m); }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, size_m); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+private:
+    std::byte* buffer_m = nullptr; // every column, column_alignment aligned
+    columns_type columns_m{};
+    size_type capacity_m = 0;
+    size_type size_m = 0;
+
+    static constexpr std::size_t row_bytes_ = (sizeof(Fields) + ...);
+
+    static constexpr std::size_t round_up_(std::size_t bytes) noexcept {
+        return (bytes + column_alignment - 1) / column_alignment * column_alignment;
+    }
+
+    // column I starts at offsets[I] bytes into the buffer, each one rounded up
+    using layout_type = std::array<std::size_t, field_count + 1>;
+
+    static constexpr layout_type layout_(size_type capacity) {
+        layout_type offsets{};
+        std::array<std::size_t, field_count> sizes{sizeof(Fields)...};
+        for (std::size_t i = 0; i < field_count; ++i) {
+            offsets[i + 1] = round_up_(offsets[i] + capacity * sizes[i]);
+        }
+        return offsets; // offsets[field_count] is the buffer size
+    }
+
+    static std::byte* allocate_(size_type capacity, columns_type& columns) {
+        auto offsets = layout_(capacity);
+        auto* buffer = static_cast<std::byte*>(
+            ::operator new(offsets[field_count], std::align_val_t{column_alignment}));
+
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(columns) = reinterpret_cast<Fields*>(buffer + offsets[I])),
+             ...);
+        }(std::index_sequence_for<Fields...>{});
+        return buffer;
+    }
+
+    static void deallocate_(std::byte* buffer, size_type capacity) noexcept {
+        if (buffer) {
+            ::operator delete(buffer, layout_(capacity)[field_count],
+                              std::align_val_t{column_alignment});
+        }
+    }
+
+    /*
+     * Constructs one field in each column at index, destroying the fields already built
+     * if one of the constructors throws
+     */
+    template <typename... Args>
+    static void construct_row_(const columns_type& columns, size_type index,
+                               Args&&... args) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::size_t constructed = 0;
+            try {
+                ((std::construct_at(std::get<I>(columns) + index,
+                                    std::forward<Args>(args)),
+                  ++constructed),
+                 ...);
+            } catch (...) {
+                ((I < constructed ? std::destroy_at(std::get<I>(columns) + index)
+                                  : void()),
+                 ...);
+                throw;
+            }
+        }(std::index_sequence_for<Fields...>{});
+    }
+
+    void destroy_rows_(size_type first, size_type last) noexcept {
+        std::apply([&](Fields*... column) {
+            (std::destroy(column + first, column + last), ...);
+        }, columns_m);
+    }
+
+    // fields that are moved (or memcpy'd) to the new buffer, the rest are copied
+    template <typename Field>
+    static constexpr bool moves_on_growth_ =
+        is_trivially_relocatable_v<Field> ||
+        std::is_nothrow_move_constructible_v<Field> ||
+        !std::is_copy_constructible_v<Field>;
+
+    // builds the column in dest, the caller destroys src once every column is built
+    template <typename Field>
+    static void relocate_column_(Field* src, size_type count, Field* dest) {
+        if constexpr (is_trivially_relocatable_v<Field>) {
+            detail::relocate_bytes(src, count, dest);
+        } else if constexpr (moves_on_growth_<Field>) {
+            std::uninitialized_move_n(src, count, dest);
+        } else {
+            std::uninitialized_copy_n(src, count, dest);
+        }
+    }
+
+    // copies other's rows into *this, which is empty and has room for them
+    void copy_rows_(const soa_vector& other) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            std::size_t copied = 0;
+            try {
+                ((std::uninitialized_copy_n(std::get<I>(other.columns_m), other.size_m,
+                                            std::get<I>(columns_m)),
+                  ++copied),
+                 ...);
+            } catch (...) {
+                ((I < copied ? (void)std::destroy_n(std::get<I>(columns_m), other.size_m)
+                             : void()),
+                 ...);
+                throw;
+            }
+        }(std::index_sequence_for<Fields...>{});
+        size_m = other.size_m;
+    }
+
+    /*
+     * Moves the rows into the new columns. The columns that are copied go first, so if
+     * one of those copies throws, no column has been moved from yet: the columns built so
+     * far are destroyed and the old ones are untouched.
+     */
+    void relocate_rows_(const columns_type& columns) {
+        [&]<std::size_t... I>(std::index_sequence<I...>) {
+            bool built[field_count]{};
+            auto build = [&]<std::size_t J>(bool moves) {
+                if (moves_on_growth_<field_type<J>> == moves) {
+                    relocate_column_(std::get<J>(columns_m), size_m,
+                                     std::get<J>(columns));
+                    built[J] = true;
+                }
+            };
+            try {
+                (build.template operator()<I>(false), ...);
+                (build.template operator()<I>(true), ...);
+            } catch (...) {
+                ((built[I] && !is_trivially_relocatable_v<Fields>
+                      ? (void)std::destroy_n(std::get<I>(columns), size_m)
+                      : void()),
+                 ...);
+                throw;
+            }
+            ((is_trivially_relocatable_v<Fields>
+                  ? void()
+                  : (void)std::destroy_n(std::get<I>(columns_m), size_m)),
+             ...);
+        }(std::index_sequence_for<Fields...>{});
+    }
+
+    /*
+     * Moves the rows to a buffer of new_capacity. construct_new may build the appended
+     * row in the new columns first and returns whether it did, the row is destroyed
+     * again if moving the old rows fails.
+     */
+    template <typename ConstructNew>
+    void reallocate_(size_type new_capacity, ConstructNew&& construct_new) {
+        columns_type columns{};
+        std::byte* buffer = allocate_(new_capacity, columns);
+
+        bool appended = false;
+        try {
+            appended = construct_new(columns);
+            relocate_rows_(columns);
+        } catch (...) {
+            if (appended) {
+                std::apply(
+                    [&](Fields*... column) { (std::destroy_at(column + size_m), ...); },
+                    columns);
+            }
+            deallocate_(buffer, new_capacity);
+            throw;
+        }
+
+        deallocate_(buffer_m, capacity_m);
+        buffer_m = buffer;
+        columns_m = columns;
+        capacity_m = new_capacity;
+    }
+};
+
+/*
+ * Random access iterator over the rows, dereferences to a reference/const_reference
+ * proxy. Its iterator_category is input_iterator_tag since the proxies are not real
+ * references, iterator_concept is random_access_iterator_tag.
+ */
+template <typename... Fields>
+template <bool Const>
+class soa_vector<Fields...>::basic_iterator {
+    using owner = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = soa_vector::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::conditional_t<Const, soa_vector::const_reference, soa_vector::reference>;
+
+    basic_iterator() noexcept = default;
+    basic_iterator(owner* vector, size_type index) noexcept
+        : vector_m(vector), index_m(index) {}
+
+    // iterator converts to const_iterator
+    operator basic_iterator<true>() const noexcept
+        requires(!Const)
+    {
+        return basic_iterator<true>(vector_m, index_m);
+    }
+
+    reference operator*() const noexcept { return (*vector_m)[index_m]; }
+    reference operator[](difference_type n) const noexcept {
+        return *(*this + n);
+    }
+
+    basic_iterator& operator++() noexcept {
+        ++index_m;
+        return *this;
+    }
+    basic_iterator operator++(int) noexcept {
+        basic_iterator old = *this;
+        ++index_m;
+        return old;
+    }
+    basic_iterator& operator--() noexcept {
+        --index_m;
+        return *this;
+    }
+    basic_iterator operator--(int) noexcept {
+        basic_iterator old = *this;
+        --index_m;
+        return old;
+    }
+
+    basic_iterator& operator+=(difference_type n) noexcept {
+        index_m = static_cast<size_type>(static_cast<difference_type>(index_m) + n);
+        return *this;
+    }
+    basic_iterator& operator-=(difference_type n) noexcept { return *this += -n; }
+
+    friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+        return it += n;
+    }
+    friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+        return it -= n;
+    }
+    friend difference_type operator-(const basic_iterator& a,
+                                     const basic_iterator& b) noexcept {
+        return static_cast<difference_type>(a.index_m) -
+               static_cast<difference_type>(b.index_m);
+    }
+
+    friend bool operator==(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m == b.index_m;
+    }
+    friend auto operator<=>(const basic_iterator& a, const basic_iterator& b) noexcept {
+        return a.index_m <=> b.index_m;
+    }
+
+private:
+    owner* vector_m = nullptr;
+    size_type index_m = 0;
+};
+
+} // namespace ptorpis
@@ -13,23 +13,33 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
+#include <type_traits>
 #include <utility>
 
+#include "comparison.hpp"
+#include "growth_policy.hpp"
 #include "iterators.hpp"
+#include "relocation.hpp"
 
 namespace ptorpis {
 /**
  * @brief Dynamic array container
  * @tparam T The type of the elements
  * @tparam Allocator The allocator type used for memory management
+ * @tparam GrowthPolicy Picks the new capacity when full, see growth_policy.hpp
  */
-template <typename T, typename Allocator = std::allocator<T>> class vector {
+template <typename T, typename Allocator = std::allocator<T>,
+          growth_policy GrowthPolicy = doubling_growth>
+class vector {
 private:
     using alloc_traits = std::allocator_traits<Allocator>;
-    static constexpr std::size_t GROWTH_FACTOR = 2;
 
 public:
     using iterator = detail::vector_iterator<T>;
@@ -38,9 +48,13 @@ public:
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
+    using value_type = T;
     using reference = T&;
+    using const_reference = const T&;
     using pointer = T*;
+    using const_pointer = const T*;
     using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
 
     constexpr size_type max_size() const noexcept {
         return alloc_traits::max_size(alloc_m);
@@ -68,27 +82,9 @@ public:
      */
     vector(size_type count, const Allocator& allocator = Allocator())
         : alloc_m(allocator), data_m(nullptr), capacity_m(0), size_m(0) {
-        if (count == 0) {
-            return;
-        }
-
-        data_m = alloc_traits::allocate(alloc_m, count);
-        capacity_m = count;
-
-        try {
-            for (size_type i{}; i < count; ++i) {
-                new (data_m + i) T();
-                ++size_m;
-            }
-        } catch (...) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
-
-            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
-
-            throw;
-        }
+        init_(count, [count](pointer dest) {
+            std::uninitialized_value_construct_n(dest, count);
+        });
     }
 
     /**
@@ -100,25 +96,9 @@ public:
      */
     vector(size_type count, const T& value, const Allocator& allocator = Allocator())
         : alloc_m(allocator), data_m(nullptr), capacity_m(0), size_m(0) {
-
-        data_m = alloc_traits::allocate(alloc_m, count);
-        capacity_m = count;
-
-        try {
-            for (size_type i{}; i < count; ++i) {
-                new (data_m + i) T(value);
-                ++size_m;
-            }
-
-        } catch (...) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
-
-            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
-
-            throw;
-        }
+        init_(count, [count, &value](pointer dest) {
+            std::uninitialized_fill_n(dest, count, value);
+        });
     }
 
     /**
@@ -140,29 +120,8 @@ public:
      */
     vector(std::initializer_list<T> init, const Allocator& allocator = Allocator())
         : alloc_m(allocator), data_m(nullptr), capacity_m(0), size_m(0) {
-        size_type count = init.size();
-        if (count == 0) {
-            return;
-        }
-
-        data_m = alloc_traits::allocate(alloc_m, count);
-        capacity_m = count;
-
-        try {
-            auto it = init.begin();
-            for (size_type i{}; i < count; ++i, ++it) {
-                new (data_m + i) T(*it);
-                ++size_m;
-            }
-
-        } catch (...) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
-
-            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
-            throw;
-        }
+        init_(init.size(),
+              [&init](pointer dest) { construct_n_(init.begin(), init.size(), dest); });
     }
 
     /**
@@ -190,27 +149,8 @@ public:
     vector(const vector& other)
         : alloc_m(alloc_traits::select_on_container_copy_construction(other.alloc_m)),
           data_m(nullptr), capacity_m(0), size_m(0) {
-        if (other.size_m == 0) {
-            return;
-        }
-
-        data_m = alloc_traits::allocate(alloc_m, other.size_m);
-        capacity_m = other.size();
-
-        try {
-            for (size_type i{}; i < other.size_m; ++i) {
-                new (data_m + i) T(other.data_m[i]);
-                ++size_m;
-            }
-
-        } catch (...) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
-
-            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
-            throw;
-        }
+        init_(other.size_m,
+              [&other](pointer dest) { construct_n_(other.data_m, other.size_m, dest); });
     }
 
     /**
@@ -258,41 +198,33 @@ public:
      * but unspecified state
      *
      * @note Self-assignment is handled correctly
-     * @note All existing elements are destroyed before copying
+     * @note The existing buffer is reused when it can hold other.size() elements, the
+     * elements are then copy assigned (one memcpy for trivially copyable types)
      */
     vector& operator=(const vector& other) {
         if (this == &other) {
             return *this;
         }
 
-        clear_and_deallocate_();
-
+        bool reuse = other.size_m <= capacity_m;
         if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
-            alloc_m = other.alloc_m;
+            reuse = reuse && alloc_m == other.alloc_m;
         }
 
-        if (other.size_m == 0) {
+        if (reuse) {
+            assign_from_(other.data_m, other.size_m);
             return *this;
         }
 
-        data_m = alloc_traits::allocate(alloc_m, other.size_m);
-        capacity_m = other.size_m;
-
-        try {
-            for (size_type i{}; i < other.size_m; ++i) {
-                new (data_m + i) T(other.data_m[i]);
-                ++size_m;
-            }
-        } catch (...) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
-
-            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
+        clear_and_deallocate_();
 
-            throw;
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc_m = other.alloc_m;
         }
 
+        init_(other.size_m,
+              [&other](pointer dest) { construct_n_(other.data_m, other.size_m, dest); });
+
         return *this;
     }
 
@@ -351,9 +283,7 @@ public:
      *       should not throw exceptions)
      */
     ~vector() {
-        for (size_type i{}; i < size_m; ++i) {
-            data_m[i].~T();
-        }
+        destroy_(data_m, data_m + size_m);
         if (data_m) {
             alloc_traits::deallocate(alloc_m, data_m, capacity_m);
         }
@@ -419,7 +349,7 @@ public:
 
     pointer data() { return data_m; }
 
-    pointer data() const { return data_m; }
+    const T* data() const { return data_m; }
 
     size_type size() const { return size_m; }
 
@@ -429,29 +359,14 @@ public:
      *
      */
 
-    void push_back(const T& value) {
-        if (size_m == capacity_m) {
-            // reserve space for 1 if the vector is empty, otherwise double the capacity
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
-        }
-
-        new (data_m + size_m) T(value);
-        ++size_m;
-    }
-
-    void push_back(T&& value) {
-        if (size_m == capacity_m) {
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
-        }
+    void push_back(const T& value) { emplace_back(value); }
 
-        new (data_m + size_m) T(std::move(value));
-        ++size_m;
-    }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
 
     /* less general, not ideal version
     template <typename... Args> reference emplace_back(Args&&... args) {
         if (size_m == capacity_m) {
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
+            reserve(grow_capacity_(size_m + 1));
         }
 
         std::construct_at(data_m + size_m, std::forward<Args>(args)...);
@@ -462,11 +377,16 @@ public:
     */
 
     /*
-     *
+     * Growing goes through grow_insert_, out of the hot path. The new element is built
+     * before the old buffer is freed, or remapped by an allocator that resizes in place,
+     * so args may refer to an element with every allocator.
      */
     template <typename... Args> reference emplace_back(Args&&... args) {
-        if (size_m == capacity_m) {
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
+        if (size_m == capacity_m) [[unlikely]] {
+            auto construct = [&](pointer dest) {
+                std::construct_at(dest, std::forward<Args>(args)...);
+            };
+            return *grow_insert_(size_m, 1, construct);
         }
 
         new (data_m + size_m) T(std::forward<Args>(args)...);
@@ -489,19 +409,61 @@ public:
      * The end() iterator is also invalidated.
      */
     void pop_back() {
-        data_m[size_m - 1].~T();
         --size_m;
+        destroy_(data_m + size_m, data_m + size_m + 1);
     }
 
     /*
      *
      */
     void clear() {
-        for (size_type i{}; i < size_m; ++i) {
-            data_m[i].~T();
+        destroy_(data_m, data_m + size_m);
+        size_m = 0;
+    }
+
+    /**
+     * @brief Changes the number of elements to count
+     *
+     * Extra elements are value initialized (zeroed for trivial types), shrinking destroys
+     * the elements past count and keeps the capacity. Growing past the capacity goes
+     * through the growth policy, like push_back.
+     *
+     * @throws If constructing an element throws, the new elements are destroyed and the
+     * vector keeps its old size.
+     */
+    void resize(size_type count) {
+        resize_with_(count, [](pointer first, pointer last) {
+            std::uninitialized_value_construct(first, last);
+        });
+    }
+
+    /// @overload Extra elements are copies of value
+    void resize(size_type count, const T& value) {
+        auto fill_with = [this, count](const T& fill) {
+            resize_with_(count, [&fill](pointer first, pointer last) {
+                std::uninitialized_fill(first, last, fill);
+            });
+        };
+
+        if (count > capacity_m && size_m != 0) {
+            // value may be one of the elements, copy it before the buffer moves
+            fill_with(T(value));
+        } else {
+            fill_with(value);
         }
+    }
 
-        size_m = 0;
+    /**
+     * @brief Like resize, but the extra elements are default initialized
+     *
+     * For trivial types this leaves the memory uninitialized, so a buffer that is about
+     * to be filled by read() or a decoder is not zeroed first. Reading an element before
+     * it was written is undefined behavior for those types.
+     */
+    void resize_for_overwrite(size_type count) {
+        resize_with_(count, [](pointer first, pointer last) {
+            std::uninitialized_default_construct(first, last);
+        });
     }
 
     /*
@@ -510,10 +472,13 @@ public:
     iterator erase(const_iterator pos) {
         size_type index = pos - begin();
 
-        data_m[index].~T();
-
-        for (size_type i{index}; i < size_m - 1; ++i) {
-            data_m[i] = std::move(data_m[i + 1]);
+        if constexpr (is_trivially_relocatable_v<T>) {
+            data_m[index].~T();
+            detail::relocate_bytes_overlapping(data_m + index + 1, size_m - index - 1,
+                                               data_m + index);
+        } else {
+            std::move(data_m + index + 1, data_m + size_m, data_m + index);
+            data_m[size_m - 1].~T();
         }
         --size_m;
         return iterator(data_m + index);
@@ -524,157 +489,142 @@ public:
         size_type last_idx = last - begin();
         size_type count = last_idx - first_idx;
 
-        for (size_type i{first_idx}; i < last_idx; ++i) {
-            data_m[i].~T();
+        if constexpr (is_trivially_relocatable_v<T>) {
+            destroy_(data_m + first_idx, data_m + last_idx);
+            detail::relocate_bytes_overlapping(data_m + last_idx, size_m - last_idx,
+                                               data_m + first_idx);
+        } else {
+            std::move(data_m + last_idx, data_m + size_m, data_m + first_idx);
+            destroy_(data_m + size_m - count, data_m + size_m);
         }
 
-        std::move(data_m + last_idx, data_m + size_m, data_m + first_idx);
-
         size_m -= count;
 
         return iterator(data_m + first_idx);
     }
 
-    /*
+    /**
+     * @brief Removes the element at pos in O(1) by moving the last element into its slot
      *
+     * Does not keep the order of the elements. Use it when removing one element at a
+     * time from a vector whose order does not matter.
+     *
+     * @return Iterator to the element that took the place of the removed one, or end()
      */
-    iterator insert(const_iterator pos, const T& value) {
+    iterator unordered_erase(const_iterator pos) {
         size_type index = pos - begin();
-        if (size_m == capacity_m) {
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
-        }
-
-        std::move_backward(data_m + index, data_m + size_m, data_m + size_m + 1);
+        size_type last = size_m - 1;
 
-        try {
-            new (data_m + index) T(value);
-        } catch (...) {
-            std::move(data_m + index, data_m + size_m + 1, data_m + index);
-            throw;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            data_m[index].~T();
+            if (index != last) {
+                detail::relocate_bytes(data_m + last, 1, data_m + index);
+            }
+        } else {
+            if (index != last) {
+                data_m[index] = std::move(data_m[last]);
+            }
+            data_m[last].~T();
         }
 
-        ++size_m;
+        --size_m;
         return iterator(data_m + index);
     }
 
-    iterator insert(const_iterator pos, T&& value) {
-        size_type index = pos - begin();
-        if (size_m == capacity_m) {
-            reserve(capacity_m == 0 ? 1 : capacity_m * GROWTH_FACTOR);
-        }
-
-        std::move_backward(data_m + index, data_m + size_m, data_m + size_m + 1);
-
-        try {
-            new (data_m + index) T(std::move(value));
-        } catch (...) {
-            std::move(data_m + index, data_m + size_m + 1, data_m + index);
-            throw;
-        }
-
-        ++size_m;
+    /*
+     *
+     */
+    iterator insert(const_iterator pos, const T& value) {
+        return insert_one_(pos - begin(), value);
+    }
 
-        return iterator(data_m + index);
+    iterator insert(const_iterator pos, T&& value) {
+        return insert_one_(pos - begin(), std::move(value));
     }
 
     iterator insert(const_iterator pos, size_type count, const T& value) {
-        size_type index = pos - begin();
-
-        if (count == 0) {
-            return iterator(data_m + index);
-        }
-
-        if (size_m + count > capacity_m) {
-            size_type new_capacity = std::max(size_m + count, capacity_m * GROWTH_FACTOR);
-            reserve(new_capacity);
-        }
-
-        std::move_backward(data_m + index, data_m + size_m, data_m + size_m + count);
-
-        size_type inserted{};
-        try {
-            for (; inserted < count; ++inserted) {
-                new (data_m + index + inserted) T(value);
-            }
-
-        } catch (...) {
-            for (size_type i{}; i < inserted; ++i) {
-                data_m[index + i].~T();
-            }
-
-            std::move(data_m + index + count, data_m + size_m + count, data_m + index);
-            throw;
+        if (is_element_(value)) {
+            // the shift would move value before it is copied
+            const T copy(value);
+            return insert(pos, count, copy);
         }
 
-        size_m += count;
-        return iterator(data_m + index);
+        return insert_with_(pos - begin(), count, [&value, count](pointer dest) {
+            std::uninitialized_fill_n(dest, count, value);
+        });
     }
 
-    template <typename InputIt>
-    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+    /**
+     * @brief Constructs an element from args before pos
+     *
+     * When the vector grows, or pos is end(), the element is constructed directly in its
+     * final slot. Otherwise it is built as a temporary first (args may refer to elements
+     * of the vector, which the shift would overwrite) and moved into the gap.
+     */
+    template <typename... Args> iterator emplace(const_iterator pos, Args&&... args) {
         size_type index = pos - begin();
-        size_type count = std::distance(first, last);
-        if (count == 0) {
-            return iterator(data_m + index);
-        }
 
-        if (size_m + count > capacity_m) {
-            size_type new_capacity = std::max(size_m + count, capacity_m * GROWTH_FACTOR);
-            reserve(new_capacity);
+        if (size_m == capacity_m || index == size_m) {
+            return insert_with_(index, 1, [&](pointer dest) {
+                std::construct_at(dest, std::forward<Args>(args)...);
+            });
         }
 
-        std::move_backward(data_m + index, data_m + size_m, data_m + size_m + count);
-
-        size_type inserted{};
-
-        try {
-            for (auto it = first; it != last; ++inserted, ++it) {
-                new (data_m + index + inserted) T(*it);
-            }
-        } catch (...) {
-            for (size_type i{}; i < inserted; ++i) {
-                data_m[index + i].~T();
-            }
-
-            std::move(data_m + index + count, data_m + size_m + count, data_m + index);
-            throw;
-        }
+        T value(std::forward<Args>(args)...);
+        return insert_with_(index, 1, [&value](pointer dest) {
+            std::construct_at(dest, std::move(value));
+        });
+    }
 
-        size_m += count;
-        return iterator(data_m + index);
+    template <std::input_iterator InputIt>
+    iterator insert(const_iterator pos, InputIt first, InputIt last) {
+        return insert_range(pos, std::ranges::subrange(first, last));
     }
 
     iterator insert(const_iterator pos, std::initializer_list<T> iList) {
-        size_type index = pos - begin();
-        size_type count = iList.size();
-
-        if (count == 0) {
-            return iterator(data_m + index);
-        }
-
-        if (size_m + count > capacity_m) {
-            size_type new_capacity = std::max(size_m + count, capacity_m * GROWTH_FACTOR);
-            reserve(new_capacity);
-        }
-        std::move_backward(data_m + index, data_m + size_m, data_m + size_m + count);
+        return insert_range(pos, iList);
+    }
 
-        size_type inserted{};
+    /**
+     * @brief Inserts the elements of rg before pos
+     *
+     * Sized and forward ranges grow the buffer at most once and construct the elements
+     * directly in the gap, contiguous ranges of T are copied with one memcpy when T is
+     * trivially copyable. Single-pass input ranges are appended with amortized growth
+     * and rotated into place.
+     *
+     * @return Iterator to the first inserted element, or pos if rg is empty
+     */
+    template <detail::container_compatible_range<T> R>
+    iterator insert_range(const_iterator pos, R&& rg) {
+        size_type index = pos - begin();
 
-        try {
-            for (auto it = iList.begin(); inserted < count; ++inserted, ++it) {
-                new (data_m + index + inserted) T(*it);
-            }
-        } catch (...) {
-            for (size_type i{}; i < inserted; ++i) {
-                data_m[index + i].~T();
+        if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>) {
+            auto count = static_cast<size_type>(std::ranges::distance(rg));
+            return insert_with_(index, count, [&rg, count](pointer dest) {
+                construct_n_(std::ranges::begin(rg), count, dest);
+            });
+        } else {
+            size_type old_size = size_m;
+
+            try {
+                for (auto&& value : rg) {
+                    emplace_back(std::forward<decltype(value)>(value));
+                }
+            } catch (...) {
+                destroy_(data_m + old_size, data_m + size_m);
+                size_m = old_size;
+                throw;
             }
 
-            std::move(data_m + index + count, data_m + size_m + count, data_m + index);
-            throw;
+            std::rotate(data_m + index, data_m + old_size, data_m + size_m);
+            return iterator(data_m + index);
         }
+    }
 
-        size_m += count;
-        return iterator(data_m + index);
+    // appends the elements of rg, same fast paths as insert_range
+    template <detail::container_compatible_range<T> R> void append_range(R&& rg) {
+        insert_range(cend(), std::forward<R>(rg));
     }
 
     /*
@@ -705,20 +655,26 @@ public:
         reallocate_(size_m);
     }
 
+    /**
+     * @brief Compares the sizes and then the elements, != is derived from it
+     *
+     * A single memcmp for element types where that is the same as comparing the values,
+     * see comparison.hpp
+     */
     bool operator==(const vector& other) const {
-        if (other.size_m != size_m) {
-            return false;
-        }
-
-        return std::equal(data_m, data_m + size_m, other.data_m);
+        return size_m == other.size_m &&
+               detail::equal_elements(data_m, other.data_m, size_m);
     }
 
-    bool operator!=(const vector& other) const {
-        if (other.size_m != size_m) {
-            return true;
-        }
-
-        return !(std::equal(data_m, data_m + size_m, other.data_m));
+    /**
+     * @brief Lexicographic comparison, <, <=, > and >= are derived from it
+     *
+     * Uses T's operator<=>, or operator< if T has no <=>, like std::vector.
+     */
+    auto operator<=>(const vector& other) const
+        requires detail::synth_comparable<T>
+    {
+        return detail::compare_elements(data_m, size_m, other.data_m, other.size_m);
     }
 
     iterator begin() { return iterator(data_m); }
@@ -755,9 +711,7 @@ private:
      */
     void clear_and_deallocate_() {
         if (data_m) {
-            for (size_type i{}; i < size_m; ++i) {
-                data_m[i].~T();
-            }
+            destroy_(data_m, data_m + size_m);
 
             alloc_traits::deallocate(alloc_m, data_m, capacity_m);
             data_m = nullptr;
@@ -766,28 +720,283 @@ private:
         }
     }
 
+    // the policy only adds slack, the result always fits required elements
+    size_type grow_capacity_(size_type required) const {
+        return std::max(required,
+                        GrowthPolicy::next_capacity(capacity_m, required, sizeof(T)));
+    }
+
+    // no loop at all for trivially destructible types, even in unoptimized builds
+    static void destroy_(pointer first, pointer last) noexcept {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            std::destroy(first, last);
+        }
+    }
+
+    // allocates exactly count slots for construct(dest) to fill, used by the constructors
+    template <typename Construct> void init_(size_type count, Construct construct) {
+        if (count == 0) {
+            return;
+        }
+
+        pointer new_data = alloc_traits::allocate(alloc_m, count);
+
+        try {
+            construct(new_data);
+        } catch (...) {
+            alloc_traits::deallocate(alloc_m, new_data, count);
+            throw;
+        }
+
+        data_m = new_data;
+        capacity_m = count;
+        size_m = count;
+    }
+
+    // copies count elements into the current buffer, which has room for them
+    void assign_from_(const T* source, size_type count) {
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (count != 0) {
+                std::memcpy(static_cast<void*>(data_m), static_cast<const void*>(source),
+                            count * sizeof(T));
+            }
+        } else {
+            size_type common = std::min(count, size_m);
+            std::copy_n(source, common, data_m);
+
+            if (count < size_m) {
+                destroy_(data_m + count, data_m + size_m);
+            } else {
+                std::uninitialized_copy_n(source + common, count - common,
+                                          data_m + common);
+            }
+        }
+
+        size_m = count;
+    }
+
     /*
-     *
+     * Copy constructs count elements from first into raw memory at dest, with a single
+     * memcpy for contiguous sources of trivially copyable T. Nothing is left constructed
+     * if a copy throws.
      */
-    void reallocate_(size_type new_capacity) {
-        pointer new_data = alloc_traits::allocate(alloc_m, new_capacity);
-        size_type moved{};
+    template <typename It>
+    static void construct_n_(It first, size_type count, pointer dest) {
+        if constexpr (std::contiguous_iterator<It> && std::is_trivially_copyable_v<T> &&
+                      std::is_same_v<std::iter_value_t<It>, T>) {
+            const T* source = std::to_address(first);
+            std::memcpy(static_cast<void*>(dest), static_cast<const void*>(source),
+                        count * sizeof(T));
+        } else {
+            std::uninitialized_copy_n(first, count, dest);
+        }
+    }
+
+    // construct fills the raw slots [first, last) past the current size
+    template <typename Construct>
+    void resize_with_(size_type count, Construct construct) {
+        if (count <= size_m) {
+            destroy_(data_m + count, data_m + size_m);
+            size_m = count;
+            return;
+        }
+
+        if (count > capacity_m) {
+            reserve(grow_capacity_(count));
+        }
+
+        construct(data_m + size_m, data_m + count);
+        size_m = count;
+    }
+
+    bool is_element_(const T& value) const {
+        std::less<const T*> less;
+        const T* address = std::addressof(value);
+        return !less(address, data_m) && less(address, data_m + size_m);
+    }
+
+    // value is constructed in its final slot unless it is one of the elements
+    template <typename Value> iterator insert_one_(size_type index, Value&& value) {
+        if (is_element_(value)) {
+            return emplace(cbegin() + index, std::forward<Value>(value));
+        }
+
+        return insert_with_(index, 1, [&value](pointer dest) {
+            std::construct_at(dest, std::forward<Value>(value));
+        });
+    }
+
+    /*
+     * Inserts count elements at index, fill(dest) constructs them in raw memory and
+     * leaves nothing constructed if it throws. If the vector has to grow, the new
+     * elements are constructed in the new buffer first and the old elements are moved
+     * once, straight to their final slots on either side of them, instead of being moved
+     * by reallocate_ and then shifted again. Allocators that resize in place keep the
+     * reserve + shift path, the resize copies nothing.
+     */
+    template <typename Fill>
+    iterator insert_with_(size_type index, size_type count, Fill fill) {
+        if (count == 0) {
+            return iterator(data_m + index);
+        }
+
+        if (size_m + count <= capacity_m) {
+            return fill_gap_(index, count, fill);
+        }
+
+        return grow_insert_(index, count, fill);
+    }
+
+    // insert_with_ when the elements fit in the current buffer
+    template <typename Fill>
+    iterator fill_gap_(size_type index, size_type count, Fill& fill) {
+        open_gap_(index, count);
 
         try {
-            for (; moved < size_m; ++moved) {
-                new (new_data + moved) T(std::move_if_noexcept(data_m[moved]));
-            }
+            fill(data_m + index);
         } catch (...) {
-            for (size_type i{}; i < moved; ++i) {
-                data_m[i].~T();
+            close_gap_(index, count);
+            throw;
+        }
+
+        size_m += count;
+        return iterator(data_m + index);
+    }
+
+    // insert_with_ when the buffer has to grow, also the slow path of emplace_back
+    template <typename Fill>
+    iterator grow_insert_(size_type index, size_type count, Fill& fill) {
+        if constexpr (is_trivially_relocatable_v<T> &&
+                      detail::reallocating_allocator<Allocator>) {
+            if (data_m) {
+                return remap_insert_(index, count, fill);
             }
+        }
+
+        size_type new_capacity = grow_capacity_(size_m + count);
+        if (new_capacity > max_size()) {
+            throw std::length_error("Requested capacity exceeded max size.");
+        }
 
+        pointer new_data = alloc_traits::allocate(alloc_m, new_capacity);
+
+        try {
+            fill(new_data + index);
+        } catch (...) {
             alloc_traits::deallocate(alloc_m, new_data, new_capacity);
             throw;
         }
 
-        for (size_type i{}; i < size_m; ++i) {
-            data_m[i].~T();
+        if constexpr (is_trivially_relocatable_v<T>) {
+            detail::relocate_bytes(data_m, index, new_data);
+            detail::relocate_bytes(data_m + index, size_m - index,
+                                   new_data + index + count);
+        } else {
+            // [first, last) of new_data holds objects, it grows outward from the new ones
+            size_type first = index;
+            size_type last = index + count;
+
+            try {
+                for (; first > 0; --first) {
+                    new (new_data + first - 1)
+                        T(std::move_if_noexcept(data_m[first - 1]));
+                }
+                for (; last < size_m + count; ++last) {
+                    new (new_data + last) T(std::move_if_noexcept(data_m[last - count]));
+                }
+            } catch (...) {
+                destroy_(new_data + first, new_data + last);
+                alloc_traits::deallocate(alloc_m, new_data, new_capacity);
+                throw;
+            }
+
+            destroy_(data_m, data_m + size_m);
+        }
+
+        if (data_m) {
+            alloc_traits::deallocate(alloc_m, data_m, capacity_m);
+        }
+
+        data_m = new_data;
+        capacity_m = new_capacity;
+        size_m += count;
+        return iterator(data_m + index);
+    }
+
+    /*
+     * grow_insert_ for allocators that resize the buffer in place. fill may read elements
+     * of *this, which the remap can move, so the new elements are built in a separate
+     * buffer first and relocated into the gap afterwards
+     */
+    template <typename Fill>
+    iterator remap_insert_(size_type index, size_type count, Fill& fill) {
+        pointer staged = alloc_traits::allocate(alloc_m, count);
+
+        try {
+            fill(staged);
+        } catch (...) {
+            alloc_traits::deallocate(alloc_m, staged, count);
+            throw;
+        }
+
+        try {
+            reserve(grow_capacity_(size_m + count));
+        } catch (...) {
+            destroy_(staged, staged + count);
+            alloc_traits::deallocate(alloc_m, staged, count);
+            throw;
+        }
+
+        open_gap_(index, count);
+        detail::relocate_bytes(staged, count, data_m + index);
+        alloc_traits::deallocate(alloc_m, staged, count);
+        size_m += count;
+        return iterator(data_m + index);
+    }
+
+    // see detail::open_gap, the gap is raw memory for every element type
+    void open_gap_(size_type index, size_type count) {
+        detail::open_gap(data_m, size_m, index, count);
+    }
+
+    // undoes open_gap_ when constructing the inserted elements fails
+    void close_gap_(size_type index, size_type count) {
+        detail::close_gap(data_m, size_m, index, count);
+    }
+
+    /*
+     * Moves the elements into a new buffer of new_capacity, trivially relocatable types
+     * are moved with a single memcpy instead of a move construct + destroy per element,
+     * or left to the allocator if it can resize the buffer itself (mmap_allocator)
+     */
+    void reallocate_(size_type new_capacity) {
+        if constexpr (is_trivially_relocatable_v<T> &&
+                      detail::reallocating_allocator<Allocator>) {
+            if (data_m) {
+                data_m = alloc_m.reallocate(data_m, capacity_m, new_capacity);
+                capacity_m = new_capacity;
+                return;
+            }
+        }
+
+        pointer new_data = alloc_traits::allocate(alloc_m, new_capacity);
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            detail::relocate_bytes(data_m, size_m, new_data);
+        } else {
+            size_type moved{};
+
+            try {
+                for (; moved < size_m; ++moved) {
+                    new (new_data + moved) T(std::move_if_noexcept(data_m[moved]));
+                }
+            } catch (...) {
+                destroy_(new_data, new_data + moved);
+                alloc_traits::deallocate(alloc_m, new_data, new_capacity);
+                throw;
+            }
+
+            destroy_(data_m, data_m + size_m);
         }
 
         if (data_m) {
@@ -799,4 +1008,24 @@ private:
     }
 };
 
+/*
+ * Stable removal of every matching element in one sweep, the kept elements are moved at
+ * most once instead of shifting the tail for each erased element
+ *
+ * @return The number of elements removed
+ */
+template <typename T, typename Allocator, growth_policy GrowthPolicy, typename Pred>
+typename vector<T, Allocator, GrowthPolicy>::size_type
+erase_if(vector<T, Allocator, GrowthPolicy>& vec, Pred pred) {
+    auto old_size = vec.size();
+    vec.erase(std::remove_if(vec.begin(), vec.end(), pred), vec.end());
+    return old_size - vec.size();
+}
+
+template <typename T, typename Allocator, growth_policy GrowthPolicy, typename U = T>
+typename vector<T, Allocator, GrowthPolicy>::size_type
+erase(vector<T, Allocator, GrowthPolicy>& vec, const U& value) {
+    return erase_if(vec, [&value](const T& element) { return element == value; });
+}
+
 } // namespace ptorpis
@@ -0,0 +1,197 @@
+#include "concurrent_append_vector.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// first block of 4 elements, then 8, 16, 32...
+template <typename T>
+using small_blocks = ptorpis::concurrent_append_vector<T, std::allocator<T>, 4>;
+
+// written by one thread, check is always ~value once the event is published
+struct event {
+    std::uint32_t thread;
+    std::uint32_t sequence;
+    std::uint64_t value;
+    std::uint64_t check;
+
+    event(std::uint32_t t, std::uint32_t s) noexcept
+        : thread(t), sequence(s), value(std::uint64_t{t} << 32 | s), check(~value) {}
+};
+
+// emplace_back throws when armed
+struct throwing_ctor {
+    static inline bool armed = false;
+
+    int value = 0;
+
+    throwing_ctor(int v) : value(v) {
+        if (armed) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+    throwing_ctor(throwing_ctor&&) noexcept = default;
+};
+
+} // namespace
+
+TEST(ConcurrentAppendVector, Types) {
+    static_assert(std::random_access_iterator<small_blocks<int>::iterator>);
+    static_assert(std::random_access_iterator<small_blocks<int>::const_iterator>);
+    static_assert(std::ranges::random_access_range<const small_blocks<int>>);
+    static_assert(!std::is_copy_constructible_v<small_blocks<int>>);
+    static_assert(!std::is_move_constructible_v<small_blocks<int>>);
+    using int64_vector = ptorpis::concurrent_append_vector<std::int64_t>;
+    static_assert(int64_vector::first_block_size == 64);
+}
+
+TEST(ConcurrentAppendVector, SingleWriter) {
+    small_blocks<int> v;
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), 0u);
+    EXPECT_FALSE(v.is_published(0));
+    EXPECT_THROW(v.at(0), std::out_of_range);
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(v.emplace_back(i), i);
+    }
+    EXPECT_EQ(v.size(), 100u);
+    EXPECT_EQ(v.claimed(), 100u);
+    EXPECT_EQ(v.capacity(), 124u);
+    EXPECT_TRUE(v.is_published(99));
+    EXPECT_FALSE(v.is_published(100));
+    EXPECT_EQ(v.at(57), 57);
+    EXPECT_THROW(v.at(100), std::out_of_range);
+
+    std::vector<int> expected(100);
+    std::iota(expected.begin(), expected.end(), 0);
+    EXPECT_TRUE(std::ranges::equal(v, expected));
+
+    const auto& c = v;
+    EXPECT_EQ(c.end() - c.begin(), 100);
+    EXPECT_EQ(*(c.cbegin() + 10), 10);
+}
+
+TEST(ConcurrentAppendVector, AddressesAreStable) {
+    small_blocks<std::string> v;
+    const std::string* first = &v.emplace_back("first element, long enough to allocate");
+    for (int i = 0; i < 1000; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(first, &v[0]);
+    EXPECT_EQ(*first, "first element, long enough to allocate");
+    EXPECT_EQ(v[1000], "999");
+}
+
+TEST(ConcurrentAppendVector, ReserveAndClear) {
+    small_blocks<std::string> v;
+    v.reserve(100);
+    EXPECT_EQ(v.capacity(), 124u);
+    EXPECT_TRUE(v.empty());
+    EXPECT_THROW(v.reserve(v.max_size() + 1), std::length_error);
+
+    v.push_back("a");
+    v.push_back("b");
+    const std::string* slot = &v[0];
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.claimed(), 0u);
+    EXPECT_FALSE(v.is_published(0));
+    EXPECT_EQ(v.capacity(), 124u);
+
+    // the blocks are reused
+    v.push_back("c");
+    EXPECT_EQ(&v[0], slot);
+    EXPECT_EQ(v.size(), 1u);
+}
+
+TEST(ConcurrentAppendVector, ThrowingConstructorClaimsNoIndex) {
+    small_blocks<throwing_ctor> v;
+    v.emplace_back(1);
+
+    throwing_ctor::armed = true;
+    EXPECT_THROW(v.emplace_back(2), std::runtime_error);
+    throwing_ctor::armed = false;
+    EXPECT_EQ(v.claimed(), 1u);
+
+    v.emplace_back(3);
+    ASSERT_EQ(v.size(), 2u);
+    EXPECT_EQ(v[1].value, 3);
+}
+
+TEST(ConcurrentAppendVector, ManyWritersAppendEveryElementOnce) {
+    constexpr std::uint32_t writers = 8;
+    constexpr std::uint32_t per_writer = 20000;
+    small_blocks<event> v;
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < writers; ++t) {
+        threads.emplace_back([&v, t] {
+            for (std::uint32_t s = 0; s < per_writer; ++s) {
+                v.emplace_back(t, s);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(v.size(), writers * per_writer);
+    EXPECT_EQ(v.claimed(), v.size());
+
+    // each writer's events appear in the order it appended them
+    std::vector<std::uint32_t> next(writers, 0);
+    for (const event& e : v) {
+        ASSERT_EQ(e.check, ~e.value);
+        ASSERT_EQ(e.sequence, next[e.thread]++);
+    }
+    EXPECT_TRUE(
+        std::ranges::all_of(next, [](std::uint32_t n) { return n == per_writer; }));
+}
+
+TEST(ConcurrentAppendVector, ReadersOnlySeePublishedElements) {
+    constexpr std::uint32_t writers = 4;
+    constexpr std::uint32_t per_writer = 20000;
+    small_blocks<event> v;
+    std::atomic<bool> done = false;
+
+    std::thread reader([&] {
+        std::size_t checked = 0;
+        while (!done.load(std::memory_order_acquire) || checked < v.size()) {
+            std::size_t size = v.size();
+            ASSERT_GE(size, checked);
+            for (; checked < size; ++checked) {
+                ASSERT_EQ(v[checked].check, ~v[checked].value);
+            }
+
+            // an element past the watermark may be published already
+            if (v.is_published(size + 1)) {
+                ASSERT_EQ(v[size + 1].check, ~v[size + 1].value);
+            }
+        }
+        EXPECT_EQ(checked, writers * per_writer);
+    });
+
+    std::vector<std::thread> threads;
+    for (std::uint32_t t = 0; t < writers; ++t) {
+        threads.emplace_back([&v, t] {
+            for (std::uint32_t s = 0; s < per_writer; ++s) {
+                v.emplace_back(t, s);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.store(true, std::memory_order_release);
+    reader.join();
+}
@@ -0,0 +1,147 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// not trivially relocatable, counts how often elements are moved
+struct counted {
+    static inline int moves = 0;
+    static inline int live = 0;
+
+    std::string name;
+
+    counted(std::string n) : name(std::move(n)) { ++live; }
+    counted(int a, char c) : name(static_cast<size_t>(a), c) { ++live; }
+    counted(const counted& other) : name(other.name) { ++live; }
+    counted(counted&& other) noexcept : name(std::move(other.name)) {
+        ++moves;
+        ++live;
+    }
+    counted& operator=(counted&& other) noexcept {
+        name = std::move(other.name);
+        ++moves;
+        return *this;
+    }
+    counted& operator=(const counted&) = default;
+    ~counted() { --live; }
+};
+
+// copy-only type whose copies start throwing once throw_at reaches zero
+struct fragile {
+    static inline int throw_at = -1;
+    int value;
+
+    fragile(int v) : value(v) {}
+    fragile(const fragile& other) : value(other.value) {
+        if (throw_at == 0) {
+            throw std::runtime_error("copy");
+        }
+        --throw_at;
+    }
+    fragile& operator=(const fragile&) = default;
+};
+
+std::vector<std::string> names(const ptorpis::vector<counted>& v) {
+    std::vector<std::string> out;
+    for (size_t i = 0; i < v.size(); ++i) {
+        out.push_back(v[i].name);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(VectorEmplace, BuildsInPlace) {
+    ptorpis::vector<counted> v;
+    v.reserve(4);
+    v.emplace_back("a");
+    v.emplace_back("c");
+    counted::moves = 0;
+
+    auto it = v.emplace(v.begin() + 2, 2, 'd');
+    EXPECT_EQ(it->name, "dd");
+    EXPECT_EQ(counted::moves, 0);
+
+    v.emplace(v.begin() + 1, 1, 'b');
+    EXPECT_EQ(names(v), (std::vector<std::string>{"a", "b", "c", "dd"}));
+}
+
+TEST(VectorEmplace, GrowingInsertMovesEachElementOnce) {
+    ptorpis::vector<counted> v;
+    for (int i = 0; i < 8; ++i) {
+        v.emplace_back(std::to_string(i));
+    }
+    ASSERT_EQ(v.capacity(), 8u);
+    counted::moves = 0;
+
+    auto it = v.emplace(v.begin() + 3, 1, 'x');
+    EXPECT_EQ(it - v.begin(), 3);
+    EXPECT_EQ(counted::moves, 8);
+    EXPECT_EQ(names(v), (std::vector<std::string>{"0", "1", "2", "x", "3", "4", "5", "6",
+                                                  "7"}));
+
+    std::vector<counted> batch{counted("p"), counted("q")};
+    v.shrink_to_fit();
+    counted::moves = 0;
+    v.insert_range(v.begin(), batch);
+    EXPECT_EQ(counted::moves, 9);
+    EXPECT_EQ(v.size(), 11u);
+    EXPECT_EQ(v[0].name, "p");
+    EXPECT_EQ(v[10].name, "7");
+}
+
+TEST(VectorEmplace, InsertElementOfTheVector) {
+    ptorpis::vector<std::string> v{"a", "b", "c"};
+    v.reserve(10);
+
+    v.insert(v.begin(), v[2]);
+    v.insert(v.begin() + 1, 2, v.back());
+    v.emplace(v.begin(), v[1]);
+    EXPECT_EQ(v[0], "c");
+    EXPECT_EQ(v[1], "c");
+    EXPECT_EQ(v[2], "c");
+    EXPECT_EQ(v[3], "c");
+    EXPECT_EQ(v.back(), "c");
+
+    v.shrink_to_fit();
+    v.insert(v.begin(), v[4]);
+    EXPECT_EQ(v[0], "a");
+}
+
+TEST(VectorEmplace, ThrowingConstructorOnGrowthLeavesVectorUnchanged) {
+    counted::live = 0;
+    {
+        ptorpis::vector<counted> v;
+        v.emplace_back("a");
+        v.emplace_back("b");
+        const counted* data = v.data();
+
+        EXPECT_THROW(v.emplace(v.begin() + 1, -1, 'x'), std::length_error);
+        EXPECT_EQ(v.data(), data);
+        EXPECT_EQ(v.capacity(), 2u);
+        EXPECT_EQ(names(v), (std::vector<std::string>{"a", "b"}));
+        EXPECT_EQ(counted::live, 2);
+    }
+    EXPECT_EQ(counted::live, 0);
+}
+
+TEST(VectorEmplace, ThrowingCopyOfOldElementsLeavesVectorUnchanged) {
+    ptorpis::vector<fragile> v;
+    v.emplace_back(1);
+    v.emplace_back(2);
+    v.emplace_back(3);
+    v.shrink_to_fit();
+
+    // the new element is built, then moving the second old element throws
+    fragile::throw_at = 2;
+    EXPECT_THROW(v.insert(v.begin() + 1, fragile(9)), std::runtime_error);
+    fragile::throw_at = -1;
+
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(v.capacity(), 3u);
+    EXPECT_EQ(v[0].value, 1);
+    EXPECT_EQ(v[2].value, 3);
+}
@@ -0,0 +1,82 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+template <typename Vector, typename Expected>
+void expect_elements(const Vector& v, const Expected& expected) {
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), v.data()));
+}
+
+} // namespace
+
+TEST(VectorEraseIf, KeepsOrderOfSurvivors) {
+    ptorpis::vector<int> v;
+    for (int i = 0; i < 20; ++i) {
+        v.push_back(i);
+    }
+
+    auto removed = ptorpis::erase_if(v, [](int i) { return i % 3 != 0; });
+    EXPECT_EQ(removed, 13u);
+    expect_elements(v, std::vector<int>{0, 3, 6, 9, 12, 15, 18});
+}
+
+TEST(VectorEraseIf, NonTrivialElements) {
+    ptorpis::vector<std::string> v{"keep", "drop", "drop", "keep too", "drop"};
+    EXPECT_EQ(ptorpis::erase(v, "drop"), 3u);
+    expect_elements(v, std::vector<std::string>{"keep", "keep too"});
+
+    EXPECT_EQ(ptorpis::erase(v, "absent"), 0u);
+    EXPECT_EQ(v.size(), 2u);
+}
+
+TEST(VectorEraseIf, MoveOnlyElements) {
+    ptorpis::vector<std::unique_ptr<int>> v;
+    for (int i = 0; i < 6; ++i) {
+        v.push_back(std::make_unique<int>(i));
+    }
+
+    ptorpis::erase_if(v, [](const std::unique_ptr<int>& p) { return *p % 2 == 0; });
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(*v[0], 1);
+    EXPECT_EQ(*v[2], 5);
+}
+
+TEST(VectorEraseIf, EverythingAndNothing) {
+    ptorpis::vector<int> v{1, 2, 3};
+    EXPECT_EQ(ptorpis::erase_if(v, [](int) { return false; }), 0u);
+    EXPECT_EQ(ptorpis::erase_if(v, [](int) { return true; }), 3u);
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(VectorUnorderedErase, MovesLastIntoTheHole) {
+    ptorpis::vector<std::string> v{"a", "b", "c", "d"};
+
+    auto it = v.unordered_erase(v.begin() + 1);
+    EXPECT_EQ(*it, "d");
+    expect_elements(v, std::vector<std::string>{"a", "d", "c"});
+
+    it = v.unordered_erase(v.begin() + 2);
+    EXPECT_EQ(it, v.end());
+    expect_elements(v, std::vector<std::string>{"a", "d"});
+}
+
+TEST(VectorUnorderedErase, RelocatableElements) {
+    ptorpis::vector<std::unique_ptr<int>> v;
+    for (int i = 0; i < 4; ++i) {
+        v.push_back(std::make_unique<int>(i));
+    }
+
+    v.unordered_erase(v.begin());
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(*v[0], 3);
+    EXPECT_EQ(*v[1], 1);
+
+    while (!v.empty()) {
+        v.unordered_erase(v.begin());
+    }
+}
@@ -2,6 +2,8 @@
 #include <gtest/gtest.h>
 #include <print>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 TEST(VectorTest, PopBackBasic) {
     ptorpis::vector<int> v{1, 2, 3, 4, 5};
@@ -535,3 +537,21 @@ TEST(VectorTest, SizeParityAtLargerCounts) {
     EXPECT_EQ(v.size(), sv.size());
     EXPECT_EQ(sizeof(v), sizeof(sv));
 }
+
+TEST(VectorTest, InsertIntoSpareCapacityNonTrivial) {
+    ptorpis::vector<std::string> v;
+    v.reserve(16);
+    v.push_back(std::string(40, 'a'));
+    v.push_back(std::string(40, 'd'));
+
+    // the shifted elements land in slots that never held an object
+    v.insert(v.begin() + 1, {std::string(40, 'b'), std::string(40, 'c')});
+    v.insert(v.begin(), 3, std::string(40, 'z'));
+
+    std::vector<std::string> expected{std::string(40, 'z'), std::string(40, 'z'),
+                                      std::string(40, 'z'), std::string(40, 'a'),
+                                      std::string(40, 'b'), std::string(40, 'c'),
+                                      std::string(40, 'd')};
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+}
@@ -0,0 +1,94 @@
+#include "growth_policy.hpp"
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+struct record {
+    char bytes[24];
+};
+
+struct wide_record {
+    char bytes[100];
+};
+
+// capacities a vector goes through while n elements are pushed one by one
+template <typename Vector> std::vector<size_t> capacity_steps(size_t n) {
+    Vector v;
+    std::vector<size_t> steps;
+    for (size_t i = 0; i < n; ++i) {
+        v.emplace_back();
+        if (steps.empty() || steps.back() != v.capacity()) {
+            steps.push_back(v.capacity());
+        }
+    }
+    return steps;
+}
+
+} // namespace
+
+TEST(GrowthPolicy, DoublingIsTheDefault) {
+    static_assert(std::is_same_v<ptorpis::vector<int>,
+                                 ptorpis::vector<int, std::allocator<int>,
+                                                 ptorpis::doubling_growth>>);
+
+    std::vector<size_t> expected{1, 2, 4, 8, 16};
+    EXPECT_EQ(capacity_steps<ptorpis::vector<int>>(16), expected);
+}
+
+TEST(GrowthPolicy, OneAndHalf) {
+    using vec = ptorpis::vector<int, std::allocator<int>, ptorpis::one_and_half_growth>;
+    std::vector<size_t> expected{1, 2, 3, 4, 6, 9, 13, 19};
+    EXPECT_EQ(capacity_steps<vec>(19), expected);
+}
+
+TEST(GrowthPolicy, MinimumCapacity) {
+    using policy = ptorpis::factor_growth<2, 1, 8>;
+    using vec = ptorpis::vector<int, std::allocator<int>, policy>;
+    std::vector<size_t> expected{8, 16};
+    EXPECT_EQ(capacity_steps<vec>(9), expected);
+}
+
+TEST(GrowthPolicy, SizeClasses) {
+    EXPECT_EQ(ptorpis::detail::size_class_ceil(1), 16u);
+    EXPECT_EQ(ptorpis::detail::size_class_ceil(17), 32u);
+    EXPECT_EQ(ptorpis::detail::size_class_ceil(100), 112u);
+    EXPECT_EQ(ptorpis::detail::size_class_ceil(128), 128u);
+    EXPECT_EQ(ptorpis::detail::size_class_ceil(4097), 5120u);
+
+    // 16 elements need 1600 bytes, the 1792-byte class holds one more
+    using vec = ptorpis::vector<wide_record, std::allocator<wide_record>,
+                                ptorpis::size_class_growth<>>;
+    std::vector<size_t> expected{1, 2, 4, 8, 17, 35};
+    EXPECT_EQ(capacity_steps<vec>(35), expected);
+}
+
+TEST(GrowthPolicy, PageGranular) {
+    using policy = ptorpis::page_growth<>;
+    EXPECT_EQ(policy::next_capacity(0, 1, sizeof(record)), 4096 / sizeof(record));
+
+    // every block is a whole number of pages, filled with as many elements as fit
+    size_t capacity = 0;
+    for (int step = 0; step < 12; ++step) {
+        size_t grown = policy::next_capacity(capacity, capacity + 1, sizeof(record));
+        EXPECT_GE(grown, 2 * capacity);
+
+        size_t pages = (grown * sizeof(record) + 4095) / 4096;
+        EXPECT_EQ(grown, pages * 4096 / sizeof(record));
+        capacity = grown;
+    }
+}
+
+TEST(GrowthPolicy, NeverBelowRequired) {
+    using vec =
+        ptorpis::vector<std::string, std::allocator<std::string>, ptorpis::page_growth<>>;
+    vec v;
+    v.insert(v.end(), 1000, std::string("x"));
+    EXPECT_GE(v.capacity(), 1000u);
+    EXPECT_EQ(v.capacity() * sizeof(std::string) % 4096, 0u);
+
+    v.insert(v.begin(), {std::string("a"), std::string("b")});
+    EXPECT_EQ(v[0], "a");
+    EXPECT_EQ(v.size(), 1002u);
+}
@@ -0,0 +1,112 @@
+#include "inplace_vector.hpp"
+#include <cstring>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+struct Leg {
+    int instrument;
+    int quantity;
+    double price;
+};
+
+constexpr int constexpr_sum() {
+    ptorpis::inplace_vector<int, 8> v{5, 1, 4};
+    v.push_back(2);
+    v.insert(v.begin() + 1, 3);
+    v.erase(v.begin());
+
+    ptorpis::inplace_vector<int, 8> copy = v;
+    int sum = 0;
+    for (int x : copy) {
+        sum += x;
+    }
+    return sum;
+}
+
+} // namespace
+
+TEST(InplaceVector, TriviallyCopyableForTrivialElements) {
+    static_assert(std::is_trivially_copyable_v<ptorpis::inplace_vector<int, 4>>);
+    static_assert(std::is_trivially_copyable_v<ptorpis::inplace_vector<Leg, 16>>);
+    static_assert(!std::is_trivially_copyable_v<ptorpis::inplace_vector<std::string, 4>>);
+    static_assert(std::is_same_v<ptorpis::inplace_vector<int, 4>::iterator,
+                                 ptorpis::detail::vector_iterator<int>>);
+}
+
+TEST(InplaceVector, UsableInConstantExpressions) {
+    static_assert(constexpr_sum() == 10);
+    EXPECT_EQ(constexpr_sum(), 10);
+}
+
+TEST(InplaceVector, CopiesAsBytes) {
+    ptorpis::inplace_vector<Leg, 16> legs;
+    legs.push_back({1, 10, 100.5});
+    legs.push_back({2, -10, 99.5});
+
+    // what sending it through a shared memory queue does
+    ptorpis::inplace_vector<Leg, 16> received;
+    std::memcpy(&received, &legs, sizeof(legs));
+
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[1].quantity, -10);
+    EXPECT_DOUBLE_EQ(received[0].price, 100.5);
+}
+
+TEST(InplaceVector, CapacityIsEnforced) {
+    ptorpis::inplace_vector<int, 3> v{1, 2, 3};
+    EXPECT_THROW(v.push_back(4), std::bad_alloc);
+    EXPECT_EQ(v.try_push_back(4), nullptr);
+    EXPECT_THROW(v.insert(v.begin(), 0), std::bad_alloc);
+    EXPECT_THROW((ptorpis::inplace_vector<int, 3>{1, 2, 3, 4}), std::bad_alloc);
+    EXPECT_EQ(v.size(), 3u);
+
+    v.pop_back();
+    ASSERT_NE(v.try_push_back(9), nullptr);
+    EXPECT_EQ(v.back(), 9);
+}
+
+TEST(InplaceVector, InsertAndErase) {
+    ptorpis::inplace_vector<int, 16> v{1, 5};
+    v.insert(v.begin() + 1, {2, 3, 4});
+    v.insert(v.end(), 2, 6);
+    auto it = v.insert(v.begin(), 0);
+    EXPECT_EQ(*it, 0);
+
+    std::vector<int> expected{0, 1, 2, 3, 4, 5, 6, 6};
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+
+    v.erase(v.begin() + 2, v.begin() + 5);
+    v.erase(v.begin());
+    expected = {1, 5, 6, 6};
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+}
+
+TEST(InplaceVector, NonTrivialElements) {
+    ptorpis::inplace_vector<std::string, 4> a{"one", "two"};
+    a.emplace_back(30, 'x');
+
+    ptorpis::inplace_vector<std::string, 4> b(a);
+    EXPECT_EQ(a, b);
+
+    b.erase(b.begin());
+    EXPECT_NE(a, b);
+    EXPECT_EQ(b[0], "two");
+
+    a = b;
+    EXPECT_EQ(a, b);
+
+    ptorpis::inplace_vector<std::string, 4> c(std::move(a));
+    EXPECT_EQ(c.size(), 2u);
+    EXPECT_EQ(c.back(), std::string(30, 'x'));
+
+    ptorpis::inplace_vector<std::unique_ptr<int>, 4> owners;
+    owners.push_back(std::make_unique<int>(1));
+    owners.insert(owners.begin(), std::make_unique<int>(0));
+    EXPECT_EQ(*owners[0], 0);
+    EXPECT_EQ(*owners[1], 1);
+}
@@ -0,0 +1,121 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <list>
+#include <numeric>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+// throws from the copy constructor once throw_at reaches zero
+struct throws_on_copy {
+    static inline int throw_at = -1;
+    int value;
+
+    throws_on_copy(int v) : value(v) {}
+    throws_on_copy(const throws_on_copy& other) : value(other.value) {
+        if (throw_at == 0) {
+            throw std::runtime_error("copy");
+        }
+        --throw_at;
+    }
+    throws_on_copy& operator=(const throws_on_copy&) = default;
+};
+
+template <typename Vector, typename Expected>
+void expect_elements(const Vector& v, const Expected& expected) {
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(expected.begin(), expected.end(), v.data()));
+}
+
+} // namespace
+
+TEST(VectorInsertRange, AppendContiguousGrowsOnce) {
+    ptorpis::vector<int> v{1, 2};
+    std::vector<int> batch(100);
+    std::iota(batch.begin(), batch.end(), 3);
+
+    v.append_range(batch);
+    EXPECT_EQ(v.capacity(), 102u);
+
+    std::vector<int> expected{1, 2};
+    expected.insert(expected.end(), batch.begin(), batch.end());
+    expect_elements(v, expected);
+}
+
+TEST(VectorInsertRange, InsertInTheMiddle) {
+    ptorpis::vector<std::string> v{"a", "e"};
+    std::list<std::string> middle{"b", "c", "d"};
+
+    auto it = v.insert_range(v.begin() + 1, middle);
+    EXPECT_EQ(*it, "b");
+    expect_elements(v, std::vector<std::string>{"a", "b", "c", "d", "e"});
+}
+
+TEST(VectorInsertRange, ConvertingRange) {
+    ptorpis::vector<long> v{0};
+    v.append_range(std::views::iota(1, 5));
+    expect_elements(v, std::vector<long>{0, 1, 2, 3, 4});
+}
+
+TEST(VectorInsertRange, SinglePassInput) {
+    std::istringstream in("3 4 5");
+    ptorpis::vector<int> v{1, 2, 6};
+
+    auto it = v.insert_range(v.begin() + 2, std::views::istream<int>(in));
+    EXPECT_EQ(it - v.begin(), 2);
+    expect_elements(v, std::vector<int>{1, 2, 3, 4, 5, 6});
+}
+
+TEST(VectorInsertRange, SinglePassIteratorPair) {
+    std::istringstream in("7 8 9");
+    ptorpis::vector<int> v;
+
+    v.insert(v.end(), std::istream_iterator<int>(in), std::istream_iterator<int>());
+    expect_elements(v, std::vector<int>{7, 8, 9});
+}
+
+TEST(VectorInsertRange, EmptyRange) {
+    ptorpis::vector<int> v{1, 2, 3};
+    std::vector<int> empty;
+
+    auto it = v.insert_range(v.begin() + 1, empty);
+    EXPECT_EQ(*it, 2);
+    EXPECT_EQ(v.size(), 3u);
+}
+
+TEST(VectorInsertRange, ThrowingCopyLeavesVectorUnchanged) {
+    ptorpis::vector<throws_on_copy> v;
+    v.reserve(10);
+    v.emplace_back(1);
+    v.emplace_back(4);
+
+    std::vector<throws_on_copy> middle{2, 3};
+    throws_on_copy::throw_at = 1;
+    EXPECT_THROW(v.insert_range(v.begin() + 1, middle), std::runtime_error);
+    throws_on_copy::throw_at = -1;
+
+    ASSERT_EQ(v.size(), 2u);
+    EXPECT_EQ(v[0].value, 1);
+    EXPECT_EQ(v[1].value, 4);
+}
+
+TEST(VectorInsertRange, ThrowingSinglePassLeavesVectorUnchanged) {
+    std::istringstream in("1 2 3");
+    ptorpis::vector<throws_on_copy> v{10, 20};
+
+    throws_on_copy::throw_at = 1;
+    auto ints = std::views::istream<int>(in);
+    EXPECT_THROW(v.insert_range(v.begin(), ints | std::views::transform([](int i) {
+                                                return throws_on_copy(i);
+                                            })),
+                 std::runtime_error);
+    throws_on_copy::throw_at = -1;
+
+    ASSERT_EQ(v.size(), 2u);
+    EXPECT_EQ(v[0].value, 10);
+    EXPECT_EQ(v[1].value, 20);
+}
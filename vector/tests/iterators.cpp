@@ -1,7 +1,14 @@
+#include "inplace_vector.hpp"
 #include "iterators.hpp"
+#include "small_vector.hpp"
 #include "vector.hpp"
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <memory>
 #include <numeric>
+#include <ranges>
+#include <span>
+#include <type_traits>
 
 TEST(VectorIteratorTest, RangeIteration) {
     ptorpis::vector<int> v(5);
@@ -657,3 +664,58 @@ TEST(VectorReverseIteratorTest, ReverseIteratorTypeTraits) {
                   typename std::iterator_traits<const_reverse_iter>::iterator_category,
                   std::random_access_iterator_tag>);
 }
+
+// Contiguous Iterator Tests
+
+TEST(VectorContiguousIteratorTest, ConceptConformance) {
+    using iter = ptorpis::vector<int>::iterator;
+    using const_iter = ptorpis::vector<int>::const_iterator;
+
+    static_assert(std::contiguous_iterator<iter>);
+    static_assert(std::contiguous_iterator<const_iter>);
+    static_assert(std::sized_sentinel_for<const_iter, const_iter>);
+    static_assert(std::is_constructible_v<const_iter, const int*>);
+    static_assert(!std::is_constructible_v<iter, const int*>);
+
+    static_assert(std::ranges::contiguous_range<ptorpis::vector<int>>);
+    static_assert(std::ranges::contiguous_range<const ptorpis::vector<int>>);
+    static_assert(std::ranges::sized_range<ptorpis::vector<int>>);
+    static_assert(std::ranges::contiguous_range<ptorpis::small_vector<int, 4>>);
+    static_assert(std::ranges::contiguous_range<ptorpis::inplace_vector<int, 4>>);
+}
+
+TEST(VectorContiguousIteratorTest, ToAddressAndArithmetic) {
+    ptorpis::vector<int> v{1, 2, 3, 4};
+    const auto& cv = v;
+
+    EXPECT_EQ(std::to_address(v.begin() + 2), v.data() + 2);
+    EXPECT_EQ(std::to_address(cv.cend()), cv.data() + 4);
+
+    EXPECT_EQ(*(2 + v.begin()), 3);
+    EXPECT_EQ(*(1 + cv.cbegin()), 2);
+    EXPECT_EQ(cv.cend() - cv.cbegin(), 4);
+    EXPECT_EQ(cv.cbegin()[3], 4);
+
+    auto it = v.end();
+    EXPECT_EQ(*--(--it), 3);
+}
+
+TEST(VectorContiguousIteratorTest, SpanAndRangesAlgorithms) {
+    ptorpis::vector<int> v(100);
+    std::iota(v.begin(), v.end(), 0);
+
+    std::span<const int> view(v);
+    EXPECT_EQ(view.size(), 100u);
+    EXPECT_EQ(view.data(), v.data());
+
+    std::span<int> sub(v.begin() + 10, v.begin() + 20);
+    EXPECT_EQ(sub.front(), 10);
+
+    ptorpis::vector<int> copy(100);
+    std::ranges::copy(v, copy.begin());
+    EXPECT_EQ(copy, v);
+
+    std::copy_backward(v.begin(), v.begin() + 50, copy.end());
+    EXPECT_EQ(copy[50], 0);
+    EXPECT_EQ(copy[99], 49);
+}
@@ -0,0 +1,189 @@
+#include "kernels.hpp"
+#include "small_vector.hpp"
+#include "vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+
+namespace {
+
+using ptorpis::kernels::isa;
+
+constexpr isa levels[] = {isa::scalar, isa::avx2, isa::avx512};
+
+// lengths around the vector widths and the four-vector unrolled blocks of each level
+constexpr std::size_t lengths[] = {0,  1,  3,  4,  7,  8,  15, 16,
+                                   17, 31, 32, 33, 63, 64, 65, 130};
+
+template <typename T> ptorpis::vector<T> ramp(std::size_t n) {
+    ptorpis::vector<T> v;
+    for (std::size_t i = 0; i < n; ++i) {
+        // not monotonic, so min/max/find_first_greater do not just hit the ends
+        v.push_back(static_cast<T>(static_cast<long>((i * 37) % 101) - 50));
+    }
+    return v;
+}
+
+template <typename T> class KernelsTest : public ::testing::Test {};
+
+// the last four have no SIMD version and take the scalar path at every level
+using element_types = ::testing::Types<std::int32_t, std::int64_t, float, double,
+                                       long long, std::int16_t, std::uint32_t,
+                                       std::uint64_t>;
+TYPED_TEST_SUITE(KernelsTest, element_types);
+
+} // namespace
+
+TYPED_TEST(KernelsTest, FindMatchesStdFind) {
+    using T = TypeParam;
+    for (std::size_t n : lengths) {
+        auto v = ramp<T>(n);
+        for (isa level : levels) {
+            for (std::size_t i = 0; i < n; ++i) {
+                auto expected = static_cast<std::size_t>(
+                    std::find(v.begin(), v.end(), v[i]) - v.begin());
+                EXPECT_EQ(ptorpis::kernels::find(v, v[i], level), expected);
+            }
+            EXPECT_EQ(ptorpis::kernels::find(v, T{100}, level), n);
+        }
+    }
+}
+
+TYPED_TEST(KernelsTest, FindFirstGreaterMatchesFindIf) {
+    using T = TypeParam;
+    for (std::size_t n : lengths) {
+        auto v = ramp<T>(n);
+        for (isa level : levels) {
+            for (T limit : {T{0}, T{10}, T{49}, T{50}}) {
+                auto expected = static_cast<std::size_t>(
+                    std::find_if(v.begin(), v.end(), [&](T x) { return x > limit; }) -
+                    v.begin());
+                EXPECT_EQ(ptorpis::kernels::find_first_greater(v, limit, level),
+                          expected);
+            }
+        }
+    }
+}
+
+TYPED_TEST(KernelsTest, CountMatchesStdCount) {
+    using T = TypeParam;
+    for (std::size_t n : lengths) {
+        auto v = ramp<T>(n);
+        for (isa level : levels) {
+            for (T value : {T{0}, T{1}, T{13}, T{100}}) {
+                auto expected =
+                    static_cast<std::size_t>(std::count(v.begin(), v.end(), value));
+                EXPECT_EQ(ptorpis::kernels::count(v, value, level), expected);
+            }
+        }
+    }
+}
+
+TYPED_TEST(KernelsTest, MinMaxSumMatchStd) {
+    using T = TypeParam;
+    for (std::size_t n : lengths) {
+        if (n == 0) {
+            continue;
+        }
+        auto v = ramp<T>(n);
+        for (isa level : levels) {
+            EXPECT_EQ(ptorpis::kernels::min(v, level),
+                      *std::min_element(v.begin(), v.end()));
+            EXPECT_EQ(ptorpis::kernels::max(v, level),
+                      *std::max_element(v.begin(), v.end()));
+            // small integers, so floating point sums are exact in any order
+            EXPECT_EQ(ptorpis::kernels::sum(v, level),
+                      std::accumulate(v.begin(), v.end(), T{}));
+        }
+    }
+}
+
+TYPED_TEST(KernelsTest, MismatchMatchesStdMismatch) {
+    using T = TypeParam;
+    for (std::size_t n : lengths) {
+        auto a = ramp<T>(n);
+        for (isa level : levels) {
+            EXPECT_EQ(ptorpis::kernels::mismatch(a, a, level), n);
+            for (std::size_t i = 0; i < n; ++i) {
+                auto b = a;
+                b[i] = T{100};
+                EXPECT_EQ(ptorpis::kernels::mismatch(a, b, level), i);
+            }
+            // stops at the end of the shorter range
+            std::span<const T> prefix(a.data(), n / 2);
+            EXPECT_EQ(ptorpis::kernels::mismatch(a, prefix, level), n / 2);
+        }
+    }
+}
+
+TEST(KernelsTest, ExtremaAtEveryPosition) {
+    for (std::size_t n : {5u, 16u, 40u, 129u}) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ptorpis::vector<double> v(n, 1.0);
+            v[i] = -2.5;
+            ptorpis::vector<std::int64_t> w(n, 7);
+            w[i] = std::numeric_limits<std::int64_t>::max();
+            for (isa level : levels) {
+                EXPECT_EQ(ptorpis::kernels::min(v, level), -2.5);
+                EXPECT_EQ(ptorpis::kernels::max(w, level),
+                          std::numeric_limits<std::int64_t>::max());
+            }
+        }
+    }
+}
+
+TEST(KernelsTest, EmptyRanges) {
+    ptorpis::vector<double> empty;
+    for (isa level : levels) {
+        EXPECT_EQ(ptorpis::kernels::find(empty, 1.0, level), 0u);
+        EXPECT_EQ(ptorpis::kernels::count(empty, 1.0, level), 0u);
+        EXPECT_EQ(ptorpis::kernels::sum(empty, level), 0.0);
+        EXPECT_THROW(ptorpis::kernels::min(empty, level), std::out_of_range);
+        EXPECT_THROW(ptorpis::kernels::max(empty, level), std::out_of_range);
+    }
+}
+
+TEST(KernelsTest, IntegerSumWrapsAround) {
+    ptorpis::vector<std::int32_t> v(100, std::numeric_limits<std::int32_t>::max());
+    // 100 * (2^31 - 1) mod 2^32, as a signed value
+    for (isa level : levels) {
+        EXPECT_EQ(ptorpis::kernels::sum(v, level), -100);
+    }
+}
+
+TEST(KernelsTest, FloatingPointComparisons) {
+    ptorpis::vector<double> v(40, 1.0);
+    v[20] = std::nan("");
+    v[30] = -0.0;
+    for (isa level : levels) {
+        // NaN is never equal or greater, -0.0 == 0.0
+        EXPECT_EQ(ptorpis::kernels::find(v, std::nan(""), level), v.size());
+        EXPECT_EQ(ptorpis::kernels::find(v, 0.0, level), 30u);
+        EXPECT_EQ(ptorpis::kernels::find_first_greater(v, 1.0, level), v.size());
+        EXPECT_EQ(ptorpis::kernels::count(v, 1.0, level), 38u);
+        EXPECT_EQ(ptorpis::kernels::mismatch(v, v, level), 20u);
+    }
+}
+
+TEST(KernelsTest, WorksOnOtherContiguousRanges) {
+    ptorpis::small_vector<std::int64_t, 8> small{5, 3, 9, 1};
+    EXPECT_EQ(ptorpis::kernels::find(small, 9), 2u);
+    EXPECT_EQ(ptorpis::kernels::min(small), 1);
+
+    const ptorpis::vector<float> prices{1.5f, 2.5f, 3.5f, 4.5f};
+    EXPECT_EQ(ptorpis::kernels::find_first_greater(prices, 3.0f), 2u);
+
+    std::span<const float> tail(prices.data() + 1, 3);
+    EXPECT_EQ(ptorpis::kernels::sum(tail), 10.5f);
+    EXPECT_EQ(ptorpis::kernels::max(tail), 4.5f);
+}
+
+TEST(KernelsTest, DetectedIsaIsStable) {
+    isa level = ptorpis::kernels::detected_isa();
+    EXPECT_EQ(ptorpis::kernels::detected_isa(), level);
+}
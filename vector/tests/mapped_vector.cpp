@@ -0,0 +1,169 @@
+#include "mapped_vector.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+class MappedVector : public TempFileTest {};
+
+} // namespace
+
+TEST_F(MappedVector, Types) {
+    static_assert(std::contiguous_iterator<ptorpis::mapped_vector<int>::iterator>);
+    static_assert(std::ranges::contiguous_range<ptorpis::mapped_vector<int>>);
+    static_assert(!std::is_copy_constructible_v<ptorpis::mapped_vector<int>>);
+    static_assert(std::is_nothrow_move_constructible_v<ptorpis::mapped_vector<int>>);
+}
+
+TEST_F(MappedVector, CreatesEmptyFile) {
+    ptorpis::mapped_vector<quote> v(path);
+    EXPECT_TRUE(v.is_open());
+    EXPECT_TRUE(v.empty());
+    EXPECT_GT(v.capacity(), 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(v.data()) % alignof(quote), 0u);
+    auto page = static_cast<std::uintmax_t>(::getpagesize());
+    EXPECT_EQ(std::filesystem::file_size(path) % page, 0u);
+}
+
+TEST_F(MappedVector, ElementsPersistAcrossReopen) {
+    {
+        ptorpis::mapped_vector<quote> v(path);
+        for (std::int32_t i = 0; i < 10000; ++i) {
+            v.push_back({1000 + i, i, i % 4});
+        }
+        v.sync();
+    }
+
+    ptorpis::mapped_vector<quote> v(path, ptorpis::mapped_mode::open);
+    ASSERT_EQ(v.size(), 10000u);
+    for (std::int32_t i = 0; i < 10000; ++i) {
+        ASSERT_EQ(v[static_cast<std::size_t>(i)], (quote{1000 + i, i, i % 4}));
+    }
+
+    // appending after the reopen continues where the last run stopped
+    v.emplace_back(quote{1, 2, 3});
+    EXPECT_EQ(v.size(), 10001u);
+    EXPECT_EQ(v.back(), (quote{1, 2, 3}));
+}
+
+TEST_F(MappedVector, CreateModeTruncates) {
+    {
+        ptorpis::mapped_vector<int> v(path);
+        v.push_back(1);
+    }
+
+    ptorpis::mapped_vector<int> v(path, ptorpis::mapped_mode::create);
+    EXPECT_TRUE(v.empty());
+}
+
+TEST_F(MappedVector, OpenModeNeedsTheFile) {
+    EXPECT_THROW(ptorpis::mapped_vector<int>(path, ptorpis::mapped_mode::open),
+                 std::system_error);
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(MappedVector, RejectsOtherFiles) {
+    {
+        ptorpis::mapped_vector<std::int32_t> v(path);
+        v.push_back(1);
+    }
+    EXPECT_THROW(ptorpis::mapped_vector<std::int64_t>{path}, std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << std::string(4096, 'x');
+    }
+    EXPECT_THROW(ptorpis::mapped_vector<std::int32_t>{path}, std::runtime_error);
+
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out << "short";
+    }
+    EXPECT_THROW(ptorpis::mapped_vector<std::int32_t>{path}, std::runtime_error);
+}
+
+TEST_F(MappedVector, GrowthKeepsElementsAndGrowsTheFile) {
+    ptorpis::mapped_vector<std::int64_t> v(path);
+    std::size_t initial = v.capacity();
+    for (std::int64_t i = 0; i < 100000; ++i) {
+        v.push_back(i);
+    }
+
+    EXPECT_GT(v.capacity(), initial);
+    EXPECT_EQ(std::filesystem::file_size(path), 64 + v.capacity() * sizeof(std::int64_t));
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), std::int64_t{}), 4999950000);
+
+    const auto& c = v;
+    EXPECT_EQ(c.end() - c.begin(), 100000);
+    EXPECT_EQ(*c.cbegin(), 0);
+}
+
+TEST_F(MappedVector, AppendFromOwnElementsWhileGrowing) {
+    ptorpis::mapped_vector<std::int64_t> v(path);
+    v.resize(v.capacity());
+    std::iota(v.begin(), v.end(), 0);
+    std::size_t count = v.size();
+
+    v.emplace_back(v[5]);
+    EXPECT_EQ(v.back(), 5);
+
+    v.append(v.data(), count);
+    ASSERT_EQ(v.size(), 2 * count + 1);
+    EXPECT_TRUE(std::equal(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(count),
+                           v.begin() + static_cast<std::ptrdiff_t>(count) + 1));
+}
+
+TEST_F(MappedVector, ResizeShrinkAndClear) {
+    ptorpis::mapped_vector<int> v(path);
+    v.resize(50000);
+    EXPECT_EQ(v.size(), 50000u);
+    EXPECT_EQ(v[49999], 0);
+    auto big = std::filesystem::file_size(path);
+
+    v.resize(10);
+    v.shrink_to_fit();
+    EXPECT_LT(std::filesystem::file_size(path), big);
+    EXPECT_GE(v.capacity(), 10u);
+    EXPECT_EQ(v.size(), 10u);
+
+    v.pop_back();
+    EXPECT_EQ(v.size(), 9u);
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_THROW(v.at(0), std::out_of_range);
+    EXPECT_THROW(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+TEST_F(MappedVector, MoveAndSwap) {
+    ptorpis::mapped_vector<int> a(path);
+    a.push_back(7);
+
+    ptorpis::mapped_vector<int> b = std::move(a);
+    EXPECT_FALSE(a.is_open());
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(a.begin(), a.end());
+    EXPECT_EQ(b[0], 7);
+
+    // a moved-from vector has no file, resizing to no elements is a no-op
+    a.resize(0);
+    a.clear();
+    EXPECT_THROW(a.resize(1), std::system_error);
+    EXPECT_THROW(a.push_back(1), std::system_error);
+    EXPECT_TRUE(a.empty());
+
+    a.swap(b);
+    EXPECT_EQ(a.at(0), 7);
+    b = std::move(a);
+    EXPECT_EQ(std::span<const int>(b.data(), b.size())[0], 7);
+}
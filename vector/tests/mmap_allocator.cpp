@@ -0,0 +1,115 @@
+#include "mmap_allocator.hpp"
+#include "vector.hpp"
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <string>
+
+namespace {
+
+// counts reallocate() calls so the tests can tell which growth path the vector took
+template <typename T> struct counting_mmap_allocator : ptorpis::mmap_allocator<T> {
+    using value_type = T;
+    static inline int reallocations = 0;
+
+    T* reallocate(T* ptr, std::size_t old_n, std::size_t new_n) {
+        ++reallocations;
+        return ptorpis::mmap_allocator<T>::reallocate(ptr, old_n, new_n);
+    }
+};
+
+} // namespace
+
+TEST(MmapAllocator, SmallBlocksUseTheHeap) {
+    ptorpis::mmap_allocator<int> alloc;
+    int* p = alloc.allocate(16);
+    p[15] = 7;
+    EXPECT_FALSE(alloc.try_expand(p, 16, 32));
+    alloc.deallocate(p, 16);
+}
+
+TEST(MmapAllocator, ReallocateKeepsContents) {
+    ptorpis::mmap_allocator<uint64_t> alloc;
+    const size_t small = 1024;     // 8 KiB, heap
+    const size_t large = 1 << 20;  // 8 MiB, mapped
+    const size_t larger = 4 << 20; // 32 MiB, mapped
+
+    uint64_t* p = alloc.allocate(small);
+    for (size_t i = 0; i < small; ++i) {
+        p[i] = i;
+    }
+
+    p = alloc.reallocate(p, small, large);
+    for (size_t i = small; i < large; ++i) {
+        p[i] = i;
+    }
+
+    p = alloc.reallocate(p, large, larger);
+    for (size_t i = 0; i < large; ++i) {
+        ASSERT_EQ(p[i], i);
+    }
+
+    p = alloc.reallocate(p, larger, small);
+    for (size_t i = 0; i < small; ++i) {
+        ASSERT_EQ(p[i], i);
+    }
+    alloc.deallocate(p, small);
+}
+
+TEST(MmapAllocator, VectorGrowsThroughReallocate) {
+    using alloc = counting_mmap_allocator<int64_t>;
+    alloc::reallocations = 0;
+
+    ptorpis::vector<int64_t, alloc> v;
+    for (int64_t i = 0; i < 2'000'000; ++i) {
+        v.push_back(i);
+    }
+    EXPECT_GT(alloc::reallocations, 0);
+
+    for (int64_t i = 0; i < 2'000'000; ++i) {
+        ASSERT_EQ(v[static_cast<size_t>(i)], i);
+    }
+
+    v.erase(v.begin() + 1000, v.end());
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 1000u);
+    EXPECT_EQ(v[999], 999);
+}
+
+TEST(MmapAllocator, NonRelocatableTypesAreCopied) {
+    using alloc = counting_mmap_allocator<std::string>;
+    alloc::reallocations = 0;
+
+    ptorpis::vector<std::string, alloc> v;
+    for (int i = 0; i < 20'000; ++i) {
+        v.push_back(std::to_string(i));
+    }
+    EXPECT_EQ(alloc::reallocations, 0);
+    EXPECT_EQ(v[12345], "12345");
+}
+
+TEST(MmapAllocator, GrowingFromOwnElements) {
+    // small threshold so the buffer is mapped and every growth is a remap
+    using alloc = ptorpis::mmap_allocator<long, 4096>;
+
+    ptorpis::vector<long, alloc> v(1024);
+    std::iota(v.begin(), v.end(), 0);
+    v.shrink_to_fit();
+    ASSERT_EQ(v.size(), v.capacity());
+
+    v.push_back(v[0]);
+    EXPECT_EQ(v.back(), 0);
+
+    v.resize(v.capacity());
+    v.emplace(v.begin() + 1, v[3]);
+    EXPECT_EQ(v[1], 3);
+
+    v.resize(v.capacity());
+    v.insert(v.begin(), v[5]);
+    EXPECT_EQ(v[0], 4);
+
+    v.resize(v.capacity());
+    v.insert(v.end(), 3, v[10]);
+    EXPECT_EQ(v[v.size() - 1], 8);
+    EXPECT_EQ(v[v.size() - 3], 8);
+}
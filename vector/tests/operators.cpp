@@ -1,5 +1,13 @@
+#include "inplace_vector.hpp"
+#include "small_vector.hpp"
 #include "vector.hpp"
+#include <cmath>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <string>
+#include <vector>
 
 TEST(VectorOperatorTest, EqualityOperator) {
     ptorpis::vector<int> v1{1, 2, 3};
@@ -33,3 +41,134 @@ TEST(VectorOperatorTest, EqualitySelfComparison) {
 
     EXPECT_TRUE(v == v); // Should equal itself
 }
+
+namespace {
+
+struct only_less {
+    int value;
+    bool operator<(const only_less& other) const { return value < other.value; }
+    bool operator==(const only_less& other) const { return value == other.value; }
+};
+
+struct quote {
+    std::int32_t price;
+    std::int32_t quantity;
+    bool operator==(const quote&) const = default;
+    auto operator<=>(const quote&) const = default;
+};
+
+// ordering on a vector must match std::vector's for the same contents
+template <typename T>
+void expect_same_order(const std::vector<T>& a, const std::vector<T>& b) {
+    ptorpis::vector<T> pa;
+    ptorpis::vector<T> pb;
+    pa.append_range(a);
+    pb.append_range(b);
+    EXPECT_EQ(pa <=> pb, a <=> b);
+    EXPECT_EQ(pa == pb, a == b);
+    EXPECT_EQ(pa < pb, a < b);
+}
+
+} // namespace
+
+template <>
+struct ptorpis::is_trivially_equality_comparable<quote> : std::true_type {};
+
+TEST(VectorOperatorTest, RelationalOperators) {
+    ptorpis::vector<int> v1{1, 2, 3};
+    ptorpis::vector<int> v2{1, 2, 4};
+    ptorpis::vector<int> prefix{1, 2};
+
+    EXPECT_TRUE(v1 < v2);
+    EXPECT_TRUE(v2 > v1);
+    EXPECT_TRUE(v1 <= v1);
+    EXPECT_TRUE(v1 >= prefix);
+    EXPECT_TRUE(prefix < v1);
+    EXPECT_EQ(v1 <=> v1, std::strong_ordering::equal);
+    EXPECT_EQ(ptorpis::vector<int>{} <=> ptorpis::vector<int>{},
+              std::strong_ordering::equal);
+}
+
+TEST(VectorOperatorTest, OrderingMatchesStdVector) {
+    // signed and wider than a byte: memcmp order would be wrong, so must not be used
+    expect_same_order<int>({-1, 5}, {1, 5});
+    expect_same_order<std::int64_t>({256}, {1});
+    expect_same_order<unsigned char>({1, 200, 3}, {1, 200, 4});
+    expect_same_order<unsigned char>({1, 200}, {1, 200, 0});
+    expect_same_order<std::byte>({std::byte{0x80}}, {std::byte{0x7f}});
+    expect_same_order<char>({'a', 'b'}, {'a', 'B'});
+    expect_same_order<std::string>({"ab", "c"}, {"ab", "b"});
+    expect_same_order<double>({1.0, -0.0}, {1.0, 0.0});
+}
+
+TEST(VectorOperatorTest, MismatchInEveryBlockPosition) {
+    // long enough for several memcmp/vectorized blocks plus a tail
+    for (std::size_t n : {1u, 31u, 32u, 33u, 100u, 257u}) {
+        for (std::size_t i = 0; i < n; ++i) {
+            ptorpis::vector<std::int64_t> a(n, 7);
+            ptorpis::vector<std::int64_t> b(n, 7);
+            b[i] = -7;
+            EXPECT_FALSE(a == b);
+            EXPECT_TRUE(a > b);
+
+            ptorpis::vector<double> x(n, 0.5);
+            ptorpis::vector<double> y(n, 0.5);
+            y[i] = 1.5;
+            EXPECT_FALSE(x == y);
+            EXPECT_TRUE(x < y);
+        }
+    }
+}
+
+TEST(VectorOperatorTest, FloatingPointEqualityUsesValues) {
+    ptorpis::vector<double> zeros(100, 0.0);
+    ptorpis::vector<double> negative_zeros(100, -0.0);
+    EXPECT_TRUE(zeros == negative_zeros);
+
+    ptorpis::vector<double> nans(100, std::nan(""));
+    EXPECT_FALSE(nans == nans);
+    EXPECT_EQ(nans <=> nans, std::partial_ordering::unordered);
+}
+
+TEST(VectorOperatorTest, TypesWithOnlyLessThan) {
+    ptorpis::vector<only_less> a{{1}, {2}};
+    ptorpis::vector<only_less> b{{1}, {3}};
+
+    EXPECT_EQ(a <=> b, std::weak_ordering::less);
+    EXPECT_TRUE(b > a);
+}
+
+TEST(VectorOperatorTest, TriviallyEqualityComparableTrait) {
+    static_assert(ptorpis::is_trivially_equality_comparable_v<int>);
+    static_assert(ptorpis::is_trivially_equality_comparable_v<int*>);
+    static_assert(ptorpis::is_trivially_equality_comparable_v<std::byte>);
+    static_assert(!ptorpis::is_trivially_equality_comparable_v<double>);
+    static_assert(!ptorpis::is_trivially_equality_comparable_v<std::string>);
+    static_assert(ptorpis::is_trivially_equality_comparable_v<quote>);
+
+    ptorpis::vector<quote> a{{100, 5}, {101, 7}};
+    ptorpis::vector<quote> b{{100, 5}, {101, 8}};
+    EXPECT_FALSE(a == b);
+    EXPECT_TRUE(a < b);
+    b[1].quantity = 7;
+    EXPECT_TRUE(a == b);
+}
+
+TEST(VectorOperatorTest, OtherContainers) {
+    ptorpis::small_vector<int, 4> s1{1, 2, 3};
+    ptorpis::small_vector<int, 4> s2{1, 2, 3, 4, 5};
+    EXPECT_TRUE(s1 < s2);
+    EXPECT_TRUE(s1 != s2);
+
+    ptorpis::inplace_vector<unsigned char, 8> i1{1, 2};
+    ptorpis::inplace_vector<unsigned char, 8> i2{1, 3};
+    EXPECT_TRUE(i1 < i2);
+    EXPECT_FALSE(i1 == i2);
+
+    constexpr auto ordered = [] {
+        ptorpis::inplace_vector<int, 4> a{1, 2};
+        ptorpis::inplace_vector<int, 4> b{1, 2, 0};
+        return a < b && a == a;
+    }();
+    static_assert(ordered);
+}
@@ -0,0 +1,145 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+namespace {
+
+// counts special member calls, relocation must not go through any of them
+struct Tracked {
+    static inline int moves = 0;
+    static inline int destructions = 0;
+
+    int value;
+    int* heap;
+
+    explicit Tracked(int v) : value(v), heap(new int(v)) {}
+    Tracked(const Tracked& other) : value(other.value), heap(new int(*other.heap)) {}
+    Tracked(Tracked&& other) noexcept
+        : value(other.value), heap(std::exchange(other.heap, nullptr)) {
+        ++moves;
+    }
+    Tracked& operator=(Tracked&& other) noexcept {
+        std::swap(heap, other.heap);
+        value = other.value;
+        ++moves;
+        return *this;
+    }
+    ~Tracked() {
+        delete heap;
+        ++destructions;
+    }
+
+    static void reset() {
+        moves = 0;
+        destructions = 0;
+    }
+};
+
+struct Pod {
+    int a;
+    double b;
+};
+
+} // namespace
+
+template <> struct ptorpis::is_trivially_relocatable<Tracked> : std::true_type {};
+
+TEST(VectorRelocation, TraitDetection) {
+    static_assert(ptorpis::is_trivially_relocatable_v<int>);
+    static_assert(ptorpis::is_trivially_relocatable_v<Pod>);
+    static_assert(ptorpis::is_trivially_relocatable_v<std::unique_ptr<int>>);
+    static_assert(ptorpis::is_trivially_relocatable_v<Tracked>);
+    static_assert(!ptorpis::is_trivially_relocatable_v<std::string>);
+}
+
+TEST(VectorRelocation, GrowthDoesNotMoveOrDestroy) {
+    ptorpis::vector<Tracked> v;
+    for (int i = 0; i < 1000; ++i) {
+        v.emplace_back(i);
+    }
+    Tracked::reset();
+
+    v.reserve(5000);
+    v.shrink_to_fit();
+
+    EXPECT_EQ(Tracked::moves, 0);
+    EXPECT_EQ(Tracked::destructions, 0);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_EQ(v[i].value, i);
+        EXPECT_EQ(*v[i].heap, i);
+    }
+}
+
+TEST(VectorRelocation, InsertShiftsBytes) {
+    ptorpis::vector<Tracked> v;
+    v.reserve(16);
+    for (int i = 0; i < 5; ++i) {
+        v.emplace_back(i);
+    }
+    Tracked::reset();
+
+    Tracked value(42);
+    auto it = v.insert(v.begin() + 2, value);
+    EXPECT_EQ(it->value, 42);
+    EXPECT_EQ(Tracked::moves, 0);
+
+    v.insert(v.begin(), 3, value);
+    EXPECT_EQ(Tracked::moves, 0);
+
+    int expected[] = {42, 42, 42, 0, 1, 42, 2, 3, 4};
+    ASSERT_EQ(v.size(), 9u);
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(v[i].value, expected[i]) << i;
+        EXPECT_EQ(*v[i].heap, expected[i]) << i;
+    }
+}
+
+TEST(VectorRelocation, EraseDestroysOnlyErased) {
+    ptorpis::vector<Tracked> v;
+    for (int i = 0; i < 10; ++i) {
+        v.emplace_back(i);
+    }
+    Tracked::reset();
+
+    v.erase(v.begin() + 1);
+    EXPECT_EQ(Tracked::destructions, 1);
+
+    v.erase(v.begin() + 2, v.begin() + 5);
+    EXPECT_EQ(Tracked::destructions, 4);
+    EXPECT_EQ(Tracked::moves, 0);
+
+    int expected[] = {0, 2, 6, 7, 8, 9};
+    ASSERT_EQ(v.size(), 6u);
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(*v[i].heap, expected[i]) << i;
+    }
+}
+
+TEST(VectorRelocation, UniquePtrOwnershipSurvives) {
+    ptorpis::vector<std::unique_ptr<int>> v;
+    for (int i = 0; i < 100; ++i) {
+        v.push_back(std::make_unique<int>(i));
+    }
+
+    v.insert(v.begin() + 50, std::make_unique<int>(-1));
+    v.erase(v.begin(), v.begin() + 10);
+    v.erase(v.begin() + 40);
+
+    ASSERT_EQ(v.size(), 90u);
+    for (size_t i = 0; i < v.size(); ++i) {
+        EXPECT_EQ(*v[i], static_cast<int>(i + 10));
+    }
+}
+
+TEST(VectorRelocation, NonRelocatableEraseKeepsValues) {
+    ptorpis::vector<std::string> v{"zero", "one", "two", "three", "four", "five"};
+
+    v.erase(v.begin() + 1);
+    v.erase(v.begin() + 1, v.begin() + 3);
+
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(v[0], "zero");
+    EXPECT_EQ(v[1], "four");
+    EXPECT_EQ(v[2], "five");
+}
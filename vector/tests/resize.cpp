@@ -0,0 +1,113 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+// counts live objects and throws from the constructor once throw_at reaches zero
+struct tracked {
+    static inline int live = 0;
+    static inline int throw_at = -1;
+
+    int value;
+
+    tracked() : tracked(0) {}
+    explicit tracked(int v) : value(v) {
+        if (throw_at == 0) {
+            throw std::runtime_error("tracked");
+        }
+        --throw_at;
+        ++live;
+    }
+    tracked(const tracked& other) : tracked(other.value) {}
+    ~tracked() { --live; }
+};
+
+} // namespace
+
+TEST(VectorResize, GrowValueInitializes) {
+    ptorpis::vector<int> v{1, 2};
+    v.resize(5);
+
+    ASSERT_EQ(v.size(), 5u);
+    EXPECT_EQ(v[1], 2);
+    for (size_t i = 2; i < 5; ++i) {
+        EXPECT_EQ(v[i], 0);
+    }
+}
+
+TEST(VectorResize, ShrinkKeepsCapacity) {
+    ptorpis::vector<std::string> v{"a", "b", "c", "d"};
+    size_t capacity = v.capacity();
+
+    v.resize(1);
+    ASSERT_EQ(v.size(), 1u);
+    EXPECT_EQ(v[0], "a");
+    EXPECT_EQ(v.capacity(), capacity);
+
+    v.resize(0);
+    EXPECT_TRUE(v.empty());
+}
+
+TEST(VectorResize, GrowWithValue) {
+    ptorpis::vector<std::string> v{"x"};
+    v.resize(4, "fill");
+
+    ASSERT_EQ(v.size(), 4u);
+    EXPECT_EQ(v[0], "x");
+    EXPECT_EQ(v[3], "fill");
+}
+
+TEST(VectorResize, ValueFromTheVectorItself) {
+    ptorpis::vector<std::string> v{std::string(40, 'a')};
+    v.shrink_to_fit();
+
+    // the buffer holding v[0] is freed while the new elements are built
+    v.resize(10, v[0]);
+    for (const std::string& s : v) {
+        EXPECT_EQ(s, std::string(40, 'a'));
+    }
+}
+
+TEST(VectorResize, ForOverwriteKeepsExistingElements) {
+    ptorpis::vector<unsigned char> v{1, 2, 3};
+    v.resize_for_overwrite(1 << 16);
+
+    ASSERT_EQ(v.size(), 1u << 16);
+    EXPECT_EQ(v[2], 3);
+
+    for (size_t i = 3; i < v.size(); ++i) {
+        v[i] = static_cast<unsigned char>(i);
+    }
+    EXPECT_EQ(v[300], static_cast<unsigned char>(300));
+}
+
+TEST(VectorResize, ForOverwriteConstructsClassTypes) {
+    ptorpis::vector<std::string> v;
+    v.resize_for_overwrite(3);
+
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_TRUE(v[2].empty());
+}
+
+TEST(VectorResize, ThrowingConstructorKeepsOldSize) {
+    tracked::live = 0;
+    {
+        ptorpis::vector<tracked> v;
+        v.emplace_back(7);
+        v.emplace_back(8);
+
+        tracked::throw_at = 3;
+        EXPECT_THROW(v.resize(10), std::runtime_error);
+        tracked::throw_at = -1;
+
+        ASSERT_EQ(v.size(), 2u);
+        EXPECT_EQ(v[1].value, 8);
+        EXPECT_EQ(tracked::live, 2);
+
+        v.resize(1);
+        EXPECT_EQ(tracked::live, 1);
+    }
+    EXPECT_EQ(tracked::live, 0);
+}
@@ -0,0 +1,232 @@
+#include "segmented_vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// first block of 4 elements, then 8, 16, 32...
+template <typename T>
+using small_blocks = ptorpis::segmented_vector<T, std::allocator<T>, 4>;
+
+// emplace_back throws when armed
+struct throwing_ctor {
+    static inline bool armed = false;
+
+    int value = 0;
+
+    throwing_ctor(int v) : value(v) {
+        if (armed) {
+            throw std::runtime_error("construction failed");
+        }
+    }
+};
+
+} // namespace
+
+TEST(SegmentedVector, Types) {
+    static_assert(std::random_access_iterator<small_blocks<int>::iterator>);
+    static_assert(std::random_access_iterator<small_blocks<int>::const_iterator>);
+    static_assert(std::ranges::random_access_range<small_blocks<int>>);
+    static_assert(std::is_convertible_v<small_blocks<int>::iterator,
+                                        small_blocks<int>::const_iterator>);
+    static_assert(ptorpis::segmented_vector<std::int64_t>::first_block_size == 64);
+    static_assert(ptorpis::segmented_vector<char[1000]>::first_block_size == 1);
+}
+
+TEST(SegmentedVector, BlocksDoubleInSize) {
+    small_blocks<int> v;
+    EXPECT_EQ(v.capacity(), 0u);
+    v.push_back(0);
+    EXPECT_EQ(v.capacity(), 4u);
+    v.resize(5);
+    EXPECT_EQ(v.capacity(), 12u);
+    v.resize(13);
+    EXPECT_EQ(v.capacity(), 28u);
+
+    EXPECT_EQ(v.segment_count(), 3u);
+    EXPECT_EQ(v.segment(0).size(), 4u);
+    EXPECT_EQ(v.segment(1).size(), 8u);
+    EXPECT_EQ(v.segment(2).size(), 1u);
+}
+
+TEST(SegmentedVector, IndexingMatchesPushOrder) {
+    small_blocks<std::size_t> v;
+    for (std::size_t i = 0; i < 10000; ++i) {
+        v.push_back(i);
+    }
+
+    for (std::size_t i = 0; i < v.size(); ++i) {
+        ASSERT_EQ(v[i], i);
+    }
+    EXPECT_EQ(v.front(), 0u);
+    EXPECT_EQ(v.back(), 9999u);
+    EXPECT_EQ(v.at(1234), 1234u);
+    EXPECT_THROW(v.at(10000), std::out_of_range);
+
+    // the segments cover the elements in order
+    std::size_t next = 0;
+    for (std::size_t k = 0; k < v.segment_count(); ++k) {
+        for (std::size_t value : v.segment(k)) {
+            ASSERT_EQ(value, next++);
+        }
+    }
+    EXPECT_EQ(next, v.size());
+}
+
+TEST(SegmentedVector, AddressesAreStable) {
+    small_blocks<std::string> v;
+    v.emplace_back("first");
+    std::string* first = &v[0];
+    std::vector<std::string*> addresses;
+    for (int i = 0; i < 1000; ++i) {
+        addresses.push_back(&v.emplace_back(std::to_string(i)));
+    }
+
+    EXPECT_EQ(first, &v[0]);
+    EXPECT_EQ(*first, "first");
+    for (std::size_t i = 0; i < addresses.size(); ++i) {
+        ASSERT_EQ(addresses[i], &v[i + 1]);
+    }
+
+    // appending a copy of an element of the container
+    v.emplace_back(v[0]);
+    EXPECT_EQ(v.back(), "first");
+}
+
+TEST(SegmentedVector, ReserveAndShrink) {
+    small_blocks<int> v;
+    v.reserve(30);
+    EXPECT_EQ(v.capacity(), 60u);
+    v.push_back(1);
+    int* address = &v[0];
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 4u);
+    EXPECT_EQ(address, &v[0]);
+
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0u);
+    EXPECT_THROW(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+TEST(SegmentedVector, ResizeAndPopBack) {
+    small_blocks<std::string> v(3);
+    EXPECT_EQ(v.size(), 3u);
+    v.resize(10, "x");
+    EXPECT_EQ(v[2], "");
+    EXPECT_EQ(v[9], "x");
+    v.pop_back();
+    EXPECT_EQ(v.size(), 9u);
+    v.resize(1);
+    EXPECT_EQ(v.size(), 1u);
+}
+
+TEST(SegmentedVector, Iterators) {
+    small_blocks<int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.push_back(i);
+    }
+
+    EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0), 4950);
+    EXPECT_EQ(v.end() - v.begin(), 100);
+    EXPECT_TRUE(std::ranges::equal(v | std::views::reverse,
+                                   std::views::iota(0, 100) | std::views::reverse));
+
+    auto it = v.begin() + 27;
+    EXPECT_EQ(*it, 27);
+    EXPECT_EQ(it[-27], 0);
+    --it;
+    EXPECT_EQ(*it, 26);
+    it -= 20;
+    EXPECT_EQ(*it, 6);
+
+    // walking backwards across every block boundary
+    auto back = v.end();
+    for (int i = 99; i >= 0; --i) {
+        ASSERT_EQ(*--back, i);
+    }
+    EXPECT_EQ(back, v.begin());
+
+    // end of a container whose last block is full
+    small_blocks<int> full{1, 2, 3, 4};
+    EXPECT_EQ(std::distance(full.begin(), full.end()), 4);
+    EXPECT_EQ(*std::prev(full.end()), 4);
+
+    small_blocks<int>::const_iterator cit = v.begin();
+    EXPECT_EQ(cit, v.cbegin());
+    EXPECT_EQ(std::ranges::find(v, 42) - v.begin(), 42);
+}
+
+TEST(SegmentedVector, CopyMoveAndCompare) {
+    small_blocks<std::string> a{"a", "b", "c", "d", "e", "f"};
+    small_blocks<std::string> b = a;
+    EXPECT_EQ(a, b);
+    b[5] = "g";
+    EXPECT_NE(a, b);
+    EXPECT_LT(a, b);
+
+    std::string* address = &b[0];
+    small_blocks<std::string> c = std::move(b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(&c[0], address);
+
+    b = a;
+    EXPECT_EQ(a, b);
+    c = a;
+    EXPECT_EQ(c, a);
+    small_blocks<std::string> shorter{"a"};
+    shorter = a;
+    EXPECT_EQ(shorter, a);
+    a = small_blocks<std::string>{"z"};
+    EXPECT_EQ(a.size(), 1u);
+    EXPECT_GT(a, b);
+
+    a.swap(b);
+    EXPECT_EQ(a, c);
+}
+
+TEST(SegmentedVector, OrderingMatchesStdVector) {
+    small_blocks<std::int64_t> a;
+    small_blocks<std::int64_t> b;
+    std::vector<std::int64_t> sa;
+    std::vector<std::int64_t> sb;
+    for (std::int64_t i = 0; i < 50; ++i) {
+        a.push_back(i);
+        sa.push_back(i);
+    }
+
+    for (std::size_t change : {0u, 3u, 4u, 11u, 12u, 49u}) {
+        b = a;
+        sb = sa;
+        b[change] = sb[change] = -1;
+        EXPECT_EQ(a <=> b, sa <=> sb);
+        EXPECT_EQ(b <=> a, sb <=> sa);
+    }
+    b.resize(20);
+    sb.resize(20);
+    EXPECT_EQ(a <=> b, sa <=> sb);
+}
+
+TEST(SegmentedVector, EmplaceThrowLeavesContainerIntact) {
+    small_blocks<throwing_ctor> v;
+    for (int i = 0; i < 4; ++i) {
+        v.emplace_back(i);
+    }
+
+    throwing_ctor::armed = true;
+    EXPECT_THROW(v.emplace_back(4), std::runtime_error);
+    throwing_ctor::armed = false;
+
+    ASSERT_EQ(v.size(), 4u);
+    EXPECT_EQ(v.back().value, 3);
+    v.emplace_back(4);
+    EXPECT_EQ(v.back().value, 4);
+}
@@ -0,0 +1,210 @@
+#include "mapped_vector.hpp"
+#include "serialization.hpp"
+#include "small_vector.hpp"
+#include "test_helpers.hpp"
+#include "vector.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+ptorpis::vector<quote> make_quotes(std::size_t count) {
+    ptorpis::vector<quote> quotes;
+    for (std::size_t i = 0; i < count; ++i) {
+        auto n = static_cast<std::int32_t>(i);
+        quotes.push_back({1000 + n, n % 100, n % 4});
+    }
+    return quotes;
+}
+
+// 64-byte aligned bytes, as from mmap or an aligned receive buffer
+struct aligned_buffer {
+    alignas(64) std::byte bytes[4096];
+};
+
+class Serialization : public TempFileTest {};
+
+} // namespace
+
+TEST_F(Serialization, Crc32c) {
+    std::string_view check = "123456789";
+    EXPECT_EQ(ptorpis::detail::crc32c(check.data(), check.size()), 0xe3069283u);
+    EXPECT_EQ(ptorpis::detail::crc32c(nullptr, 0), 0u);
+
+    // the instruction and the table agree on every length and alignment
+    std::array<std::byte, 100> bytes;
+    for (std::size_t i = 0; i < bytes.size(); ++i) {
+        bytes[i] = static_cast<std::byte>(i * 37 + 11);
+    }
+    for (std::size_t first = 0; first < 8; ++first) {
+        for (std::size_t count = 0; first + count <= bytes.size(); count += 7) {
+            const std::byte* data = bytes.data() + first;
+            auto table = ~ptorpis::detail::crc32c_scalar(~0u, data, count);
+            ASSERT_EQ(ptorpis::detail::crc32c(data, count), table);
+        }
+    }
+}
+
+TEST_F(Serialization, SerializeAndView) {
+    auto quotes = make_quotes(100);
+    aligned_buffer buffer;
+    std::size_t bytes = ptorpis::serialize(quotes, buffer.bytes);
+    EXPECT_EQ(bytes, ptorpis::serialized_size(quotes));
+    EXPECT_EQ(bytes, 64 + 100 * sizeof(quote));
+
+    ptorpis::vector_view<quote> view(std::span(buffer.bytes, bytes));
+    ASSERT_EQ(view.size(), 100u);
+    EXPECT_EQ(view.serialized_size(), bytes);
+    EXPECT_EQ(view.data(), reinterpret_cast<const quote*>(buffer.bytes + 64));
+    EXPECT_TRUE(std::equal(view.begin(), view.end(), quotes.begin(), quotes.end()));
+    EXPECT_EQ(view.front(), quotes.front());
+    EXPECT_EQ(view.back(), quotes.back());
+    EXPECT_EQ(view.at(42), quotes[42]);
+    EXPECT_THROW(view.at(100), std::out_of_range);
+
+    std::span<const quote> span = view;
+    EXPECT_EQ(span.size(), 100u);
+    static_assert(std::ranges::contiguous_range<ptorpis::vector_view<quote>>);
+}
+
+TEST_F(Serialization, OtherContainersAndEmpty) {
+    aligned_buffer buffer;
+
+    ptorpis::small_vector<std::int64_t, 8> small{1, 2, 3};
+    auto crc = ptorpis::checksum::crc32c;
+    std::size_t bytes = ptorpis::serialize(small, buffer.bytes, crc);
+    ptorpis::vector_view<std::int64_t> view(std::span(buffer.bytes, bytes));
+    EXPECT_TRUE(std::ranges::equal(view, small));
+
+    ptorpis::vector<double> empty;
+    bytes = ptorpis::serialize(empty, buffer.bytes, crc);
+    EXPECT_EQ(bytes, 64u);
+    EXPECT_TRUE(ptorpis::vector_view<double>(std::span(buffer.bytes, bytes)).empty());
+
+    std::array<std::byte, 10> tiny;
+    EXPECT_THROW(ptorpis::serialize(small, tiny), std::length_error);
+}
+
+TEST_F(Serialization, RejectsBadBuffers) {
+    auto quotes = make_quotes(10);
+    aligned_buffer buffer;
+    std::size_t bytes =
+        ptorpis::serialize(quotes, buffer.bytes, ptorpis::checksum::crc32c);
+    std::span<const std::byte> good(buffer.bytes, bytes);
+
+    EXPECT_THROW(ptorpis::vector_view<quote>(good.first(63)), std::runtime_error);
+    EXPECT_THROW(ptorpis::vector_view<quote>(good.first(bytes - 1)), std::runtime_error);
+    EXPECT_THROW(ptorpis::vector_view<std::int64_t>{good}, std::runtime_error);
+
+    aligned_buffer copy = buffer;
+    copy.bytes[0] = std::byte{'X'};
+    EXPECT_THROW(ptorpis::vector_view<quote>(std::span(copy.bytes, bytes)),
+                 std::runtime_error);
+
+    copy = buffer;
+    copy.bytes[8] = std::byte{2}; // version
+    EXPECT_THROW(ptorpis::vector_view<quote>(std::span(copy.bytes, bytes)),
+                 std::runtime_error);
+
+    // one flipped bit in an element fails the checksum, unless it is not verified
+    copy = buffer;
+    copy.bytes[64 + 5 * sizeof(quote)] ^= std::byte{1};
+    EXPECT_THROW(ptorpis::vector_view<quote>(std::span(copy.bytes, bytes)),
+                 std::runtime_error);
+    ptorpis::vector_view<quote> unchecked(std::span(copy.bytes, bytes), false);
+    EXPECT_NE(unchecked[5], quotes[5]);
+
+    // a buffer at an offset that misaligns the elements
+    alignas(64) std::byte shifted[sizeof(aligned_buffer) + 4];
+    std::memcpy(shifted + 4, buffer.bytes, bytes);
+    EXPECT_THROW(ptorpis::vector_view<quote>(std::span(shifted + 4, bytes)),
+                 std::runtime_error);
+}
+
+TEST_F(Serialization, WriteAndReadFile) {
+    auto quotes = make_quotes(50000);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    ASSERT_NE(fd, -1);
+    ptorpis::write(fd, quotes, ptorpis::checksum::crc32c);
+    ptorpis::write(fd, make_quotes(3));
+
+    ::lseek(fd, 0, SEEK_SET);
+    EXPECT_EQ(ptorpis::read_vector<quote>(fd), quotes);
+    EXPECT_EQ(ptorpis::read_vector<quote>(fd), make_quotes(3));
+    EXPECT_THROW(ptorpis::read_vector<quote>(fd), std::runtime_error);
+
+    ::lseek(fd, 0, SEEK_SET);
+    EXPECT_THROW(ptorpis::read_vector<std::int32_t>(fd), std::runtime_error);
+
+    // a corrupt size is caught against the file length before anything is allocated
+    ptorpis::serialized_header header;
+    ::pread(fd, &header, sizeof(header), 0);
+    ptorpis::serialized_header corrupt = header;
+    corrupt.size = std::uint64_t{1} << 40;
+    ::pwrite(fd, &corrupt, sizeof(corrupt), 0);
+    ::lseek(fd, 0, SEEK_SET);
+    EXPECT_THROW(ptorpis::read_vector<quote>(fd), std::runtime_error);
+    ::pwrite(fd, &header, sizeof(header), 0);
+
+    // both arrays viewed in place over the mapped file, one after the other
+    auto file_size = static_cast<std::size_t>(::lseek(fd, 0, SEEK_END));
+    void* map = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    ASSERT_NE(map, MAP_FAILED);
+    std::span<const std::byte> file(static_cast<const std::byte*>(map), file_size);
+
+    ptorpis::vector_view<quote> first(file);
+    EXPECT_TRUE(std::ranges::equal(first, quotes));
+    ptorpis::vector_view<quote> second(file.subspan(first.serialized_size()));
+    EXPECT_TRUE(std::ranges::equal(second, make_quotes(3)));
+
+    ::munmap(map, file_size);
+    ::close(fd);
+}
+
+TEST_F(Serialization, WriteThroughPipe) {
+    // much larger than the pipe buffer, writev blocks until the reader catches up
+    ptorpis::vector<std::int64_t> values(300000);
+    std::iota(values.begin(), values.end(), 0);
+
+    int fds[2];
+    ASSERT_EQ(::pipe(fds), 0);
+    std::thread writer([&] {
+        ptorpis::write(fds[1], values, ptorpis::checksum::crc32c);
+        ::close(fds[1]);
+    });
+
+    auto received = ptorpis::read_vector<std::int64_t>(fds[0]);
+    writer.join();
+    ::close(fds[0]);
+    EXPECT_EQ(received, values);
+}
+
+TEST_F(Serialization, MappedVectorContents) {
+    {
+        ptorpis::mapped_vector<std::int32_t> table(std::filesystem::path(path) += ".vec");
+        table.resize(1000);
+        std::iota(table.begin(), table.end(), 0);
+
+        int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        ASSERT_NE(fd, -1);
+        ptorpis::write(fd, table);
+        ::lseek(fd, 0, SEEK_SET);
+        EXPECT_TRUE(std::ranges::equal(ptorpis::read_vector<std::int32_t>(fd), table));
+        ::close(fd);
+    }
+    std::filesystem::remove(std::filesystem::path(path) += ".vec");
+}
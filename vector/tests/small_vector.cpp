@@ -0,0 +1,201 @@
+#include "small_vector.hpp"
+#include <gtest/gtest.h>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace {
+
+// std::allocator that counts how many blocks it handed out
+template <typename T> struct counting_allocator {
+    using value_type = T;
+    static inline int allocations = 0;
+
+    counting_allocator() = default;
+    template <typename U> counting_allocator(const counting_allocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        ++allocations;
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) { std::allocator<T>{}.deallocate(p, n); }
+
+    bool operator==(const counting_allocator&) const { return true; }
+};
+
+} // namespace
+
+TEST(SmallVector, SharesVectorIterators) {
+    static_assert(std::is_same_v<ptorpis::small_vector<int, 4>::iterator,
+                                 ptorpis::detail::vector_iterator<int>>);
+    static_assert(std::is_same_v<ptorpis::small_vector<int, 4>::const_iterator,
+                                 ptorpis::detail::vector_const_iterator<int>>);
+}
+
+TEST(SmallVector, StaysInlineUpToN) {
+    using alloc = counting_allocator<int>;
+    alloc::allocations = 0;
+
+    ptorpis::small_vector<int, 8, alloc> v;
+    EXPECT_EQ(v.capacity(), 8u);
+    for (int i = 0; i < 8; ++i) {
+        v.push_back(i);
+    }
+
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(alloc::allocations, 0);
+
+    auto* object = reinterpret_cast<const char*>(&v);
+    auto* first = reinterpret_cast<const char*>(v.data());
+    EXPECT_GE(first, object);
+    EXPECT_LT(first, object + sizeof(v));
+}
+
+TEST(SmallVector, SpillsToHeapAndBack) {
+    using alloc = counting_allocator<int>;
+    alloc::allocations = 0;
+
+    ptorpis::small_vector<int, 4, alloc> v{1, 2, 3, 4};
+    v.push_back(5);
+    EXPECT_FALSE(v.is_inline());
+    EXPECT_EQ(alloc::allocations, 1);
+    EXPECT_EQ(v.capacity(), 8u);
+
+    v.pop_back();
+    v.pop_back();
+    v.shrink_to_fit();
+    EXPECT_TRUE(v.is_inline());
+    EXPECT_EQ(v.capacity(), 4u);
+
+    std::vector<int> expected{1, 2, 3};
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin(), expected.end()));
+}
+
+TEST(SmallVector, MoveInlineAndHeap) {
+    ptorpis::small_vector<std::string, 2> inline_vec{"a", "b"};
+    ptorpis::small_vector<std::string, 2> moved_inline(std::move(inline_vec));
+    EXPECT_TRUE(inline_vec.empty());
+    EXPECT_TRUE(inline_vec.is_inline());
+    ASSERT_EQ(moved_inline.size(), 2u);
+    EXPECT_EQ(moved_inline[1], "b");
+
+    ptorpis::small_vector<std::string, 2> heap_vec{"x", "y", "z"};
+    const std::string* heap_data = heap_vec.data();
+    ptorpis::small_vector<std::string, 2> moved_heap(std::move(heap_vec));
+    EXPECT_EQ(moved_heap.data(), heap_data); // the block was stolen, not copied
+    EXPECT_TRUE(heap_vec.is_inline());
+
+    moved_inline = std::move(moved_heap);
+    ASSERT_EQ(moved_inline.size(), 3u);
+    EXPECT_EQ(moved_inline[2], "z");
+}
+
+TEST(SmallVector, CopyAndCompare) {
+    ptorpis::small_vector<std::string, 3> a{"one", "two", "three", "four"};
+    ptorpis::small_vector<std::string, 3> b(a);
+    EXPECT_EQ(a, b);
+
+    b[0] = "uno";
+    EXPECT_NE(a, b);
+
+    ptorpis::small_vector<std::string, 3> c{"x"};
+    c = a;
+    EXPECT_EQ(c, a);
+}
+
+TEST(SmallVector, InsertAndErase) {
+    ptorpis::small_vector<int, 4> v{1, 5};
+    v.insert(v.begin() + 1, {2, 3, 4});
+    v.insert(v.end(), 2, 6);
+    v.insert(v.begin(), 0);
+
+    std::vector<int> expected{0, 1, 2, 3, 4, 5, 6, 6};
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+
+    v.erase(v.begin() + 2, v.begin() + 5);
+    v.erase(v.begin());
+    expected = {1, 5, 6, 6};
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+}
+
+TEST(SmallVector, NonTrivialElementsSurviveSpill) {
+    ptorpis::small_vector<std::string, 2> v;
+    for (int i = 0; i < 100; ++i) {
+        v.emplace_back(std::to_string(i) + std::string(20, 'x'));
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(v.at(static_cast<size_t>(i)), std::to_string(i) + std::string(20, 'x'));
+    }
+    EXPECT_THROW(v.at(100), std::out_of_range);
+}
+
+TEST(SmallVector, InsertOwnElements) {
+    std::string first(30, 'a');
+    std::string second(30, 'b');
+
+    // full, so both have to move the elements to a new block first
+    ptorpis::small_vector<std::string, 2> v{first, second};
+    v.push_back(v[0]);
+    ASSERT_EQ(v.size(), 3u);
+    EXPECT_EQ(v[2], first);
+
+    ptorpis::small_vector<std::string, 2> w{first, second};
+    w.insert(w.begin(), w[1]);
+    ASSERT_EQ(w.size(), 3u);
+    EXPECT_EQ(w[0], second);
+    EXPECT_EQ(w[2], second);
+
+    // room for one more, opening the gap moves the element that is inserted
+    w.insert(w.begin(), std::move(w[1]));
+    ASSERT_EQ(w.size(), 4u);
+    EXPECT_EQ(w[0], first);
+
+    w.insert(w.begin(), 2, w[3]);
+    EXPECT_EQ(w[0], second);
+    EXPECT_EQ(w[1], second);
+    EXPECT_EQ(w[2], first);
+}
+
+TEST(SmallVector, InsertFromInputIterators) {
+    // single pass, counting the elements first would consume them
+    std::istringstream input("3 4 5 6");
+    ptorpis::small_vector<int, 2> v{1, 2, 7};
+    v.insert(v.begin() + 2, std::istream_iterator<int>(input),
+             std::istream_iterator<int>());
+
+    std::vector<int> expected{1, 2, 3, 4, 5, 6, 7};
+    ASSERT_EQ(v.size(), expected.size());
+    EXPECT_TRUE(std::equal(v.begin(), v.end(), expected.begin()));
+}
+
+TEST(SmallVector, GrowthPolicyAndVectorApi) {
+    using one_and_half =
+        ptorpis::small_vector<int, 4, std::allocator<int>, ptorpis::one_and_half_growth>;
+    one_and_half v{1, 2, 3, 4};
+    v.push_back(5);
+    EXPECT_EQ(v.capacity(), 6u);
+
+    ptorpis::small_vector<int, 4> w;
+    w.resize(3);
+    EXPECT_EQ(w[2], 0);
+    w.resize(6, 7);
+    EXPECT_EQ(w.capacity(), 8u);
+    EXPECT_EQ(w[5], 7);
+    w.resize(2);
+    w.resize_for_overwrite(4);
+    EXPECT_EQ(w.size(), 4u);
+
+    w.resize(2);
+    w.emplace(w.begin() + 1, 9);
+    w.append_range(std::vector<int>{3, 4});
+    w.insert_range(w.begin(), std::vector<int>{8});
+
+    std::vector<int> expected{8, 0, 9, 0, 3, 4};
+    ASSERT_EQ(w.size(), expected.size());
+    EXPECT_TRUE(std::equal(w.begin(), w.end(), expected.begin()));
+}
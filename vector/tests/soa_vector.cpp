@@ -0,0 +1,249 @@
+#include "kernels.hpp"
+#include "soa_vector.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <numeric>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+namespace {
+
+using orders = ptorpis::soa_vector<std::int64_t, std::int32_t, double>;
+
+// copying throws once copies_left reaches 0, without a move constructor growth copies it
+struct throwing_copy {
+    static inline int copies_left = -1;
+
+    int value = 0;
+
+    throwing_copy(int v) : value(v) {}
+    throwing_copy(const throwing_copy& other) : value(other.value) {
+        if (copies_left == 0) {
+            throw std::runtime_error("copy failed");
+        }
+        if (copies_left > 0) {
+            --copies_left;
+        }
+    }
+    throwing_copy& operator=(const throwing_copy&) = default;
+    ~throwing_copy() = default;
+
+    bool operator==(const throwing_copy&) const = default;
+};
+
+} // namespace
+
+TEST(SoaVector, Types) {
+    using row = std::tuple<std::int64_t, std::int32_t, double>;
+    static_assert(std::is_same_v<orders::value_type, row>);
+    static_assert(std::is_same_v<orders::reference,
+                                 std::tuple<std::int64_t&, std::int32_t&, double&>>);
+    static_assert(std::is_same_v<orders::field_type<1>, std::int32_t>);
+    static_assert(orders::field_count == 3);
+    static_assert(std::random_access_iterator<orders::iterator>);
+    static_assert(std::ranges::random_access_range<orders>);
+#if __cpp_lib_ranges_zip >= 202110L
+    // needs the common_reference of tuples of references from C++23
+    static_assert(std::random_access_iterator<orders::const_iterator>);
+#endif
+    static_assert(std::is_convertible_v<orders::iterator, orders::const_iterator>);
+}
+
+TEST(SoaVector, EmplaceAndAccess) {
+    orders v;
+    EXPECT_TRUE(v.empty());
+
+    auto [price, qty, fee] = v.emplace_back(1005, 10, 0.25);
+    EXPECT_EQ(price, 1005);
+    qty = 11;
+    v.push_back({1006, 20, 0.5});
+
+    EXPECT_EQ(v.size(), 2u);
+    EXPECT_EQ(std::get<1>(v[0]), 11);
+    EXPECT_EQ(v.front(), (orders::value_type{1005, 11, 0.25}));
+    EXPECT_EQ(std::get<2>(v.back()), 0.5);
+    EXPECT_EQ(std::get<0>(v.at(1)), 1006);
+    EXPECT_THROW(v.at(2), std::out_of_range);
+
+    // assigning a row writes every field
+    v[0] = std::tuple{1, 2, 3.0};
+    EXPECT_EQ(std::get<0>(v[0]), 1);
+    EXPECT_EQ(std::get<1>(v[0]), 2);
+    EXPECT_EQ(std::get<2>(v[0]), 3.0);
+
+    const orders& c = v;
+    auto [cprice, cqty, cfee] = c[1];
+    static_assert(std::is_same_v<decltype(cprice), const std::int64_t&>);
+    EXPECT_EQ(cqty, 20);
+}
+
+TEST(SoaVector, ColumnsAreAlignedAndContiguous) {
+    orders v;
+    for (int i = 0; i < 1000; ++i) {
+        v.emplace_back(i, i * 2, i * 0.5);
+    }
+
+    std::span<std::int64_t> prices = v.column<0>();
+    std::span<std::int32_t> qtys = v.column<1>();
+    std::span<double> fees = v.column<2>();
+    ASSERT_EQ(prices.size(), 1000u);
+    ASSERT_EQ(qtys.size(), 1000u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(prices.data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(qtys.data()) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(fees.data()) % 64, 0u);
+    EXPECT_EQ(v.data<1>(), qtys.data());
+
+    EXPECT_EQ(std::accumulate(prices.begin(), prices.end(), std::int64_t{}), 499500);
+    EXPECT_EQ(ptorpis::kernels::sum(prices), 499500);
+    EXPECT_EQ(ptorpis::kernels::max(qtys), 1998);
+
+    // writing a column is seen through the rows
+    qtys[7] = -1;
+    EXPECT_EQ(std::get<1>(v[7]), -1);
+}
+
+TEST(SoaVector, GrowthKeepsRows) {
+    ptorpis::soa_vector<std::string, int> v;
+    for (int i = 0; i < 100; ++i) {
+        v.emplace_back(std::string(20, static_cast<char>('a' + i % 26)), i);
+    }
+
+    EXPECT_GE(v.capacity(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(std::get<0>(v[static_cast<std::size_t>(i)]),
+                  std::string(20, static_cast<char>('a' + i % 26)));
+        EXPECT_EQ(std::get<1>(v[static_cast<std::size_t>(i)]), i);
+    }
+}
+
+TEST(SoaVector, EmplaceFromOwnRowWhileGrowing) {
+    ptorpis::soa_vector<std::string, int> v;
+    v.emplace_back(std::string(50, 'x'), 1);
+    v.shrink_to_fit();
+    ASSERT_EQ(v.size(), v.capacity());
+
+    v.emplace_back(std::get<0>(v[0]), std::get<1>(v[0]));
+    EXPECT_EQ(v.size(), 2u);
+    EXPECT_EQ(std::get<0>(v[1]), std::string(50, 'x'));
+    EXPECT_EQ(std::get<1>(v[1]), 1);
+}
+
+TEST(SoaVector, ReserveAndShrink) {
+    orders v;
+    v.reserve(10);
+    EXPECT_EQ(v.capacity(), 10u);
+    v.emplace_back(1, 2, 3.0);
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 1u);
+    EXPECT_EQ(std::get<0>(v[0]), 1);
+
+    v.clear();
+    v.shrink_to_fit();
+    EXPECT_EQ(v.capacity(), 0u);
+    EXPECT_THROW(v.reserve(v.max_size() + 1), std::length_error);
+}
+
+TEST(SoaVector, ResizeAndPopBack) {
+    ptorpis::soa_vector<std::string, int> v;
+    v.resize(3);
+    EXPECT_EQ(v.size(), 3u);
+    EXPECT_EQ(std::get<0>(v[2]), "");
+    EXPECT_EQ(std::get<1>(v[2]), 0);
+
+    v[1] = std::tuple{std::string("b"), 2};
+    v.pop_back();
+    EXPECT_EQ(v.size(), 2u);
+    EXPECT_EQ(std::get<0>(v.back()), "b");
+
+    v.resize(1);
+    EXPECT_EQ(v.size(), 1u);
+}
+
+TEST(SoaVector, CopyMoveAndEquality) {
+    ptorpis::soa_vector<std::string, double> a;
+    a.emplace_back("one", 1.0);
+    a.emplace_back("two", 2.0);
+
+    ptorpis::soa_vector<std::string, double> b = a;
+    EXPECT_EQ(a, b);
+    std::get<1>(b[1]) = 2.5;
+    EXPECT_NE(a, b);
+
+    ptorpis::soa_vector<std::string, double> c = std::move(b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(std::get<1>(c[1]), 2.5);
+
+    b = a;
+    EXPECT_EQ(a, b);
+    c = std::move(a);
+    EXPECT_EQ(c, b);
+
+    c.swap(a);
+    EXPECT_EQ(a, b);
+}
+
+TEST(SoaVector, Iterators) {
+    orders v;
+    for (int i = 0; i < 10; ++i) {
+        v.emplace_back(i, i, i);
+    }
+
+    std::int64_t total = 0;
+    for (auto [price, qty, fee] : v) {
+        total += price;
+        qty = 0;
+    }
+    EXPECT_EQ(total, 45);
+    EXPECT_EQ(std::get<1>(v[9]), 0);
+
+    auto it = v.begin();
+    EXPECT_EQ(std::get<0>(*(it + 4)), 4);
+    EXPECT_EQ(std::get<0>(it[7]), 7);
+    EXPECT_EQ(v.end() - v.begin(), 10);
+    EXPECT_LT(it, v.end());
+    orders::const_iterator cit = it;
+    EXPECT_EQ(cit, v.cbegin());
+
+    auto found =
+        std::ranges::find_if(v, [](const auto& row) { return std::get<0>(row) == 6; });
+    EXPECT_EQ(found - v.begin(), 6);
+    EXPECT_EQ(std::ranges::distance(v | std::views::reverse), 10);
+}
+
+TEST(SoaVector, GrowthThrowLeavesRowsIntact) {
+    ptorpis::soa_vector<std::string, throwing_copy, int> v;
+    for (int i = 0; i < 4; ++i) {
+        v.emplace_back(std::to_string(i), i, i);
+    }
+    v.shrink_to_fit();
+
+    // the throwing_copy column is copied before the string column is moved
+    throwing_copy::copies_left = 2;
+    EXPECT_THROW(v.emplace_back("new", 4, 4), std::runtime_error);
+    throwing_copy::copies_left = -1;
+
+    ASSERT_EQ(v.size(), 4u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_EQ(std::get<0>(v[static_cast<std::size_t>(i)]), std::to_string(i));
+        EXPECT_EQ(std::get<1>(v[static_cast<std::size_t>(i)]).value, i);
+    }
+}
+
+TEST(SoaVector, RowConstructionThrowLeavesRowsIntact) {
+    ptorpis::soa_vector<std::string, throwing_copy> v;
+    v.reserve(4);
+    v.emplace_back("a", 1);
+
+    throwing_copy source(2);
+    throwing_copy::copies_left = 0;
+    EXPECT_THROW(v.emplace_back("b", source), std::runtime_error);
+    throwing_copy::copies_left = -1;
+
+    ASSERT_EQ(v.size(), 1u);
+    EXPECT_EQ(std::get<0>(v[0]), "a");
+}
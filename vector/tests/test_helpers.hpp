@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+// 16-byte trivially copyable record used by the file-backed container tests
+struct quote {
+    std::int64_t price;
+    std::int32_t qty;
+    std::int32_t venue;
+
+    bool operator==(const quote&) const = default;
+};
+
+/*
+ * Fixture with a file in the temp directory, named after the test suite, the process
+ * and the test, that is removed before and after each test
+ */
+class TempFileTest : public ::testing::Test {
+protected:
+    std::filesystem::path path;
+
+    void SetUp() override {
+        const auto* info = ::testing::UnitTest::GetInstance()->current_test_info();
+        path = std::filesystem::temp_directory_path() /
+               (std::string(info->test_suite_name()) + "_" + std::to_string(::getpid()) +
+                "_" + info->name());
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+};
@@ -0,0 +1,109 @@
+#include "vector.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+struct pod64 {
+    long values[8];
+};
+
+// copies throw once throw_at reaches zero, live counts the objects alive
+struct throwing_copy {
+    static inline int throw_at = -1;
+    static inline int live = 0;
+
+    int value;
+
+    throwing_copy(int v = 0) : value(v) { ++live; }
+    throwing_copy(const throwing_copy& other) : value(other.value) {
+        if (throw_at == 0) {
+            throw std::runtime_error("copy");
+        }
+        --throw_at;
+        ++live;
+    }
+    throwing_copy& operator=(const throwing_copy&) = default;
+    ~throwing_copy() { --live; }
+};
+
+} // namespace
+
+TEST(VectorTrivialPaths, CopyPods) {
+    ptorpis::vector<pod64> v(100);
+    for (size_t i = 0; i < v.size(); ++i) {
+        v[i].values[7] = static_cast<long>(i);
+    }
+
+    ptorpis::vector<pod64> copy(v);
+    ASSERT_EQ(copy.size(), 100u);
+    EXPECT_EQ(copy[99].values[7], 99);
+    EXPECT_EQ(copy[99].values[0], 0);
+}
+
+TEST(VectorTrivialPaths, CopyAssignmentReusesTheBuffer) {
+    ptorpis::vector<int> small{1, 2, 3};
+    ptorpis::vector<int> big(100, 7);
+    const int* data = big.data();
+
+    big = small;
+    EXPECT_EQ(big.data(), data);
+    EXPECT_EQ(big.capacity(), 100u);
+    EXPECT_EQ(big, small);
+
+    ptorpis::vector<std::string> names{"a", "b", "c", "d"};
+    ptorpis::vector<std::string> two{"x", "y"};
+    const std::string* names_data = names.data();
+
+    names = two;
+    EXPECT_EQ(names.data(), names_data);
+    EXPECT_EQ(names, two);
+
+    two = ptorpis::vector<std::string>{"1", "2", "3"};
+    names = two;
+    EXPECT_EQ(names.data(), names_data);
+    EXPECT_EQ(names, two);
+}
+
+TEST(VectorTrivialPaths, ThrowingCopyAssignmentLeavesValidVector) {
+    throwing_copy::live = 0;
+    {
+        ptorpis::vector<throwing_copy> target{1};
+        ptorpis::vector<throwing_copy> source{1, 2, 3, 4};
+
+        throwing_copy::throw_at = 2;
+        EXPECT_THROW(target = source, std::runtime_error);
+        throwing_copy::throw_at = -1;
+
+        EXPECT_TRUE(target.empty());
+        EXPECT_EQ(throwing_copy::live, 4);
+
+        target = source;
+        EXPECT_EQ(target.size(), 4u);
+    }
+    EXPECT_EQ(throwing_copy::live, 0);
+}
+
+TEST(VectorTrivialPaths, ThrowingFillConstructorLeaksNothing) {
+    throwing_copy::live = 0;
+    throwing_copy value(5);
+
+    throwing_copy::throw_at = 3;
+    EXPECT_THROW((ptorpis::vector<throwing_copy>(10, value)), std::runtime_error);
+    throwing_copy::throw_at = -1;
+    EXPECT_EQ(throwing_copy::live, 1);
+}
+
+TEST(VectorTrivialPaths, FillAndClear) {
+    ptorpis::vector<pod64> v(50, pod64{{1, 2, 3, 4, 5, 6, 7, 8}});
+    EXPECT_EQ(v[49].values[7], 8);
+
+    size_t capacity = v.capacity();
+    v.clear();
+    EXPECT_TRUE(v.empty());
+    EXPECT_EQ(v.capacity(), capacity);
+
+    v.resize(2);
+    EXPECT_EQ(v[1].values[0], 0);
+}